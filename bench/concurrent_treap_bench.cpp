@@ -0,0 +1,92 @@
+// Mixed insert/lookup/erase throughput of concurrent_treap against one _Treap behind one mutex
+
+#include <memory>
+#include <mutex>
+#include "concurrent_treap.hpp"
+#include "treap_bench_common.hpp"
+
+using namespace TreapBench;
+
+typedef TreapTree::concurrent_treap<int> concurrent_set;
+
+static const int key_range = 1 << 20;
+
+/*
+ * @brief the baseline,a single _Treap that every operation locks exclusively
+ */
+struct locked_set
+{
+    std::mutex _M_mutex;
+    TreapTree::_Treap<int> _M_tree;
+
+    bool insert(int __k) {
+        std::lock_guard<std::mutex> __lock(_M_mutex);
+        return _M_tree.insert_unique(__k).second;
+    }
+
+    std::size_t erase(int __k) {
+        std::lock_guard<std::mutex> __lock(_M_mutex);
+        return _M_tree.erase(__k);
+    }
+
+    bool contains(int __k) {
+        std::lock_guard<std::mutex> __lock(_M_mutex);
+        return _M_tree.contains(__k);
+    }
+};
+
+static void spread(locked_set&) {}
+
+static void spread(concurrent_set& __s) { __s.rebalance(64); }
+
+/*
+ * @brief half of key_range preloaded,spread over 64 shards for concurrent_set
+ */
+template <typename _Set>
+static _Set* make_set() {
+    _Set* __s = new _Set;
+    for (int __k : make_keys(key_range / 2,pattern_random,1))
+        __s->insert(__k & (key_range - 1));
+    spread(*__s);
+    return __s;
+}
+
+template <typename _Set>
+static std::unique_ptr<_Set>& shared_set() {
+    static std::unique_ptr<_Set> __s;
+    return __s;
+}
+
+/*
+ * @brief _ReadPercent lookups,the rest split evenly between inserts and erases so the size holds
+ *
+ * Thread 0 builds the set before the timed loop and drops it after,the loop's start and end
+ * are barriers for all threads.
+ */
+template <typename _Set,unsigned int _ReadPercent>
+static void BM_concurrent_mixed(benchmark::State& __state) {
+    if (__state.thread_index() == 0)
+        shared_set<_Set>().reset(make_set<_Set>());
+    std::mt19937 __rng(__state.thread_index() + 1);
+    std::size_t __hits = 0;
+    for (auto _ : __state) {
+        _Set& __s = *shared_set<_Set>();
+        const int __k = static_cast<int>(__rng() & (key_range - 1));
+        const unsigned int __op = __rng() % 100;
+        if (__op < _ReadPercent)
+            __hits += __s.contains(__k);
+        else if ((__op - _ReadPercent) % 2 == 0)
+            __hits += __s.insert(__k);
+        else
+            __hits += __s.erase(__k);
+    }
+    benchmark::DoNotOptimize(__hits);
+    __state.SetItemsProcessed(__state.iterations());
+    if (__state.thread_index() == 0)
+        shared_set<_Set>().reset();
+}
+
+BENCHMARK_TEMPLATE(BM_concurrent_mixed,locked_set,50)->ThreadRange(1,64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_concurrent_mixed,concurrent_set,50)->ThreadRange(1,64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_concurrent_mixed,locked_set,90)->ThreadRange(1,64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_concurrent_mixed,concurrent_set,90)->ThreadRange(1,64)->UseRealTime();
@@ -0,0 +1,80 @@
+// Copy assignment of _Treap,which reuses the target's nodes,against destroy + copy-construct
+
+#include "treap_bench_common.hpp"
+
+using namespace TreapBench;
+
+static std::size_t allocated_objects = 0;
+
+/*
+ * @brief std::allocator that counts in allocated_objects what it hands out,whatever it is rebound to
+ */
+template <typename _Tp>
+struct counting_allocator : public std::allocator<_Tp>
+{
+    template <typename _Up>
+    struct rebind { typedef counting_allocator<_Up> other; };
+
+    counting_allocator() {}
+
+    template <typename _Up>
+    counting_allocator(const counting_allocator<_Up>&) {}
+
+    _Tp* allocate(std::size_t __n) {
+        allocated_objects += __n;
+        return std::allocator<_Tp>::allocate(__n);
+    }
+};
+
+typedef TreapTree::_Treap<long,std::less<long>,counting_allocator<long>> counted_treap;
+
+/*
+ * @brief a source of range(0) elements and a target of range(0) * range(1) / 4 elements
+ */
+static void make_assign_case(benchmark::State& __state,counted_treap& __src,counted_treap& __dst) {
+    const std::size_t __n = __state.range(0);
+    for (int __k : make_keys(__n,pattern_random,1))
+        __src.emplace(__k);
+    for (int __k : make_keys(__n * __state.range(1) / 4,pattern_random,2))
+        __dst.emplace(__k);
+}
+
+template <bool _Reuse>
+static void BM_reassign(benchmark::State& __state) {
+    counted_treap __src,__dst;
+    make_assign_case(__state,__src,__dst);
+    const std::size_t __dst_size = __dst.size();
+    std::size_t __allocs = 0;
+    for (auto _ : __state) {
+        __state.PauseTiming();
+        if (__dst.size() != __dst_size) {
+            __dst.clear();
+            for (int __k : make_keys(__dst_size,pattern_random,2))
+                __dst.emplace(__k);
+        }
+        const std::size_t __before = allocated_objects;
+        __state.ResumeTiming();
+        if (_Reuse)
+            __dst = __src;
+        else {
+            __dst.~counted_treap();
+            new (&__dst) counted_treap(__src);
+        }
+        benchmark::DoNotOptimize(__dst.size());
+        __allocs += allocated_objects - __before;
+    }
+    __state.SetItemsProcessed(__state.iterations() * __src.size());
+    __state.counters["allocs"] = benchmark::Counter(static_cast<double>(__allocs),benchmark::Counter::kAvgIterations);
+}
+
+/*
+ * @brief target sizes of 1/4,1 and 2 times the source
+ */
+static void assign_args(benchmark::internal::Benchmark* __b) {
+    for (long __n = 1000; __n <= TREAP_BENCH_MAX_N; __n *= 10)
+        for (long __quarters : { 1L,4L,8L })
+            __b->Args({__n,__quarters});
+}
+
+BENCHMARK_TEMPLATE(BM_reassign,false)->Apply(assign_args);
+BENCHMARK_TEMPLATE(BM_reassign,true)->Apply(assign_args);
@@ -0,0 +1,78 @@
+// find_batch() and lower_bound_batch() against one find()/lower_bound() per key
+
+#include "treap_bench_common.hpp"
+
+using namespace TreapBench;
+
+typedef TreapTree::_Treap<long> treap_long_multiset;
+
+static const std::size_t batch_queries = 1 << 20;
+
+/*
+ * @brief 200K keys fit the last-level cache of most machines,8M (about 0.5 GB) needs TREAP_BENCH_LARGE
+ */
+static void batch_sizes(benchmark::internal::Benchmark* __b) {
+    for (long __n : { 200000L,1L << 20,8L << 20 })
+        if (__n <= TREAP_BENCH_MAX_N)
+            __b->Arg(__n);
+}
+
+static std::vector<long> make_long_keys(std::size_t __n,std::uint64_t __seed) {
+    std::vector<long> __keys(__n);
+    for (std::size_t __i = 0; __i < __n; ++__i)
+        __keys[__i] = static_cast<long>(mix(__i ^ (__seed << 40)));
+    return __keys;
+}
+
+/*
+ * @brief the Treap of range(0) keys and batch_queries lookups,half of them hits
+ */
+static void make_batch_case(benchmark::State& __state,treap_long_multiset& __t,std::vector<long>& __queries) {
+    const std::vector<long> __keys = make_long_keys(__state.range(0),1);
+    for (long __k : __keys)
+        __t.emplace(__k);
+    __queries = make_long_keys(batch_queries,2);
+    for (std::size_t __i = 0; __i < __queries.size(); __i += 2)
+        __queries[__i] = __keys[mix(__i) % __keys.size()];
+}
+
+template <bool _Batch>
+static void BM_batch_find(benchmark::State& __state) {
+    treap_long_multiset __t;
+    std::vector<long> __queries;
+    make_batch_case(__state,__t,__queries);
+    std::vector<treap_long_multiset::iterator> __out(__queries.size());
+    for (auto _ : __state) {
+        if (_Batch)
+            __t.find_batch(__queries.begin(),__queries.end(),__out.begin());
+        else
+            for (std::size_t __i = 0; __i < __queries.size(); ++__i)
+                __out[__i] = __t.find(__queries[__i]);
+        benchmark::DoNotOptimize(__out.data());
+        benchmark::ClobberMemory();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __queries.size());
+}
+
+template <bool _Batch>
+static void BM_batch_lower_bound(benchmark::State& __state) {
+    treap_long_multiset __t;
+    std::vector<long> __queries;
+    make_batch_case(__state,__t,__queries);
+    std::vector<treap_long_multiset::iterator> __out(__queries.size());
+    for (auto _ : __state) {
+        if (_Batch)
+            __t.lower_bound_batch(__queries.begin(),__queries.end(),__out.begin());
+        else
+            for (std::size_t __i = 0; __i < __queries.size(); ++__i)
+                __out[__i] = __t.lower_bound(__queries[__i]);
+        benchmark::DoNotOptimize(__out.data());
+        benchmark::ClobberMemory();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __queries.size());
+}
+
+BENCHMARK_TEMPLATE(BM_batch_find,false)->Apply(batch_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_batch_find,true)->Apply(batch_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_batch_lower_bound,false)->Apply(batch_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_batch_lower_bound,true)->Apply(batch_sizes)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,139 @@
+// Core operations of _Treap against std::multiset and __gnu_pbds::tree
+
+#include "treap_bench_common.hpp"
+
+using namespace TreapBench;
+
+template <typename _Container,key_pattern _Pattern>
+static void BM_insert(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),_Pattern);
+    for (auto _ : __state) {
+        _Container __c;
+        fill(__c,__keys);
+        benchmark::DoNotOptimize(__c.size());
+        __state.PauseTiming();
+        { _Container __dead(std::move(__c)); }
+        __state.ResumeTiming();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+template <typename _Container>
+static void BM_find(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_random);
+    std::vector<int> __queries = make_keys(__state.range(0),pattern_random,2);
+    // half of the queries hit
+    for (std::size_t __i = 0; __i < __queries.size(); __i += 2)
+        __queries[__i] = __keys[mix(__i) % __keys.size()];
+    _Container __c;
+    fill(__c,__keys);
+    for (auto _ : __state) {
+        std::size_t __hits = 0;
+        for (int __q : __queries)
+            __hits += ops<_Container>::contains(__c,__q);
+        benchmark::DoNotOptimize(__hits);
+    }
+    __state.SetItemsProcessed(__state.iterations() * __queries.size());
+}
+
+template <typename _Container>
+static void BM_erase(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_random);
+    std::vector<int> __order(__keys);
+    std::shuffle(__order.begin(),__order.end(),std::mt19937(3));
+    for (auto _ : __state) {
+        __state.PauseTiming();
+        _Container __c;
+        fill(__c,__keys);
+        __state.ResumeTiming();
+        for (int __k : __order)
+            ops<_Container>::erase_one(__c,__k);
+        benchmark::DoNotOptimize(__c.size());
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+template <typename _Container>
+static void BM_iterate(benchmark::State& __state) {
+    _Container __c;
+    fill(__c,make_keys(__state.range(0),pattern_random));
+    for (auto _ : __state) {
+        long __sum = 0;
+        for (typename _Container::const_iterator __it = __c.begin(); __it != __c.end(); ++__it)
+            __sum += ops<_Container>::key(*__it);
+        benchmark::DoNotOptimize(__sum);
+    }
+    __state.SetItemsProcessed(__state.iterations() * __c.size());
+}
+
+template <typename _Container>
+static void BM_copy(benchmark::State& __state) {
+    _Container __c;
+    fill(__c,make_keys(__state.range(0),pattern_random));
+    for (auto _ : __state) {
+        _Container __d(__c);
+        benchmark::DoNotOptimize(__d.size());
+        __state.PauseTiming();
+        { _Container __dead(std::move(__d)); }
+        __state.ResumeTiming();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __c.size());
+}
+
+template <typename _Container>
+static void BM_clear(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_random);
+    for (auto _ : __state) {
+        __state.PauseTiming();
+        _Container __c;
+        fill(__c,__keys);
+        __state.ResumeTiming();
+        __c.clear();
+        benchmark::DoNotOptimize(__c.size());
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+/*
+ * bulk build from sorted input:assign_sorted() against the hinted range constructor of std::multiset
+ */
+static void BM_bulk_build_treap(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_sorted);
+    for (auto _ : __state) {
+        treap_multiset __t;
+        __t.assign_sorted(__keys.begin(),__keys.end());
+        benchmark::DoNotOptimize(__t.size());
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+static void BM_bulk_build_std(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_sorted);
+    for (auto _ : __state) {
+        std_multiset __s(__keys.begin(),__keys.end());
+        benchmark::DoNotOptimize(__s.size());
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+#define TREAP_BENCH_ALL(__bm) \
+    BENCHMARK_TEMPLATE(__bm,treap_multiset)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(__bm,std_multiset)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(__bm,pbds_multiset)->Apply(sizes)
+
+#define TREAP_BENCH_INSERT(__pattern) \
+    BENCHMARK_TEMPLATE(BM_insert,treap_multiset,__pattern)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(BM_insert,std_multiset,__pattern)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(BM_insert,pbds_multiset,__pattern)->Apply(sizes)
+
+TREAP_BENCH_INSERT(pattern_random);
+TREAP_BENCH_INSERT(pattern_sorted);
+TREAP_BENCH_INSERT(pattern_reversed);
+TREAP_BENCH_INSERT(pattern_zipf);
+TREAP_BENCH_ALL(BM_find);
+TREAP_BENCH_ALL(BM_erase);
+TREAP_BENCH_ALL(BM_iterate);
+TREAP_BENCH_ALL(BM_copy);
+TREAP_BENCH_ALL(BM_clear);
+BENCHMARK(BM_bulk_build_treap)->Apply(sizes);
+BENCHMARK(BM_bulk_build_std)->Apply(sizes);
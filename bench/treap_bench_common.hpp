@@ -0,0 +1,125 @@
+// Shared helpers of treap_bench -*- C++ -*-
+// @file treap_bench_common.hpp
+
+#ifndef _TREAP_BENCH_COMMON_H_
+#define _TREAP_BENCH_COMMON_H_ 1
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+#include <benchmark/benchmark.h>
+#include "treap.hpp"
+
+#ifndef TREAP_BENCH_MAX_N
+#define TREAP_BENCH_MAX_N (1 << 20)
+#endif
+
+namespace TreapBench {
+
+    enum key_pattern { pattern_random,pattern_sorted,pattern_reversed,pattern_zipf };
+
+    inline std::uint64_t mix(std::uint64_t __x) { return TreapTree::_M_mix64(__x); }
+
+    /*
+     * @brief __n keys,zipf ranks follow the continuous s = 1 law and are scattered by a hash
+     */
+    inline std::vector<int> make_keys(std::size_t __n,key_pattern __p,std::uint64_t __seed = 1) {
+        std::vector<int> __keys(__n);
+        std::mt19937_64 __rng(__seed);
+        switch (__p) {
+        case pattern_random:
+            for (int& __k : __keys)
+                __k = static_cast<int>(__rng());
+            break;
+        case pattern_sorted:
+        case pattern_reversed:
+            for (std::size_t __i = 0; __i < __n; ++__i)
+                __keys[__i] = static_cast<int>(__i * 4);
+            if (__p == pattern_reversed)
+                std::reverse(__keys.begin(),__keys.end());
+            break;
+        case pattern_zipf: {
+            std::uniform_real_distribution<double> __u(0.0,1.0);
+            const double __log_n = std::log(static_cast<double>(__n) + 1.0);
+            for (int& __k : __keys) {
+                const std::uint64_t __rank = static_cast<std::uint64_t>(std::exp(__u(__rng) * __log_n));
+                __k = static_cast<int>(mix(__rank));
+            }
+            break;
+        }
+        }
+        return __keys;
+    }
+
+    /*
+     * @brief sizes 1K,10K,... up to TREAP_BENCH_MAX_N
+     */
+    inline void sizes(benchmark::internal::Benchmark* __b) {
+        for (long __n = 1000; __n <= TREAP_BENCH_MAX_N; __n *= 10)
+            __b->Arg(__n);
+    }
+
+    typedef TreapTree::_Treap<int> treap_multiset;
+    typedef std::multiset<int> std_multiset;
+    // pb_ds has no multiset,a sequence number makes equal keys distinct
+    typedef __gnu_pbds::tree<std::pair<int,unsigned int>,__gnu_pbds::null_type,std::less<std::pair<int,unsigned int>>,
+                             __gnu_pbds::rb_tree_tag,__gnu_pbds::tree_order_statistics_node_update> pbds_multiset;
+
+    /*
+     * @brief the few operations every benchmark needs,spelled per container
+     */
+    template <typename _Container>
+    struct ops
+    {
+        static int key(int __v) { return __v; }
+
+        static void insert(_Container& __c,int __k) { __c.emplace(__k); }
+
+        static bool contains(const _Container& __c,int __k) { return __c.find(__k) != __c.end(); }
+
+        static void erase_one(_Container& __c,int __k) {
+            typename _Container::iterator __it = __c.find(__k);
+            if (__it != __c.end())
+                __c.erase(__it);
+        }
+    };
+
+    template <>
+    struct ops<pbds_multiset>
+    {
+        static int key(const std::pair<int,unsigned int>& __v) { return __v.first; }
+
+        static void insert(pbds_multiset& __c,int __k) { __c.insert(std::make_pair(__k,_S_seq()++)); }
+
+        static bool contains(const pbds_multiset& __c,int __k) {
+            pbds_multiset::const_iterator __it = __c.lower_bound(std::make_pair(__k,0u));
+            return __it != __c.end() && __it->first == __k;
+        }
+
+        static void erase_one(pbds_multiset& __c,int __k) {
+            pbds_multiset::iterator __it = __c.lower_bound(std::make_pair(__k,0u));
+            if (__it != __c.end() && __it->first == __k)
+                __c.erase(__it);
+        }
+
+        static unsigned int& _S_seq() {
+            static unsigned int __seq = 0;
+            return __seq;
+        }
+    };
+
+    template <typename _Container>
+    void fill(_Container& __c,const std::vector<int>& __keys) {
+        for (int __k : __keys)
+            ops<_Container>::insert(__c,__k);
+    }
+}
+
+#endif
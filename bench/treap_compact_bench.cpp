@@ -0,0 +1,48 @@
+// find() on a Treap built by random insertion,before and after compact()
+
+#include "treap_bench_common.hpp"
+
+using namespace TreapBench;
+
+typedef TreapTree::_Treap<long> treap_long_multiset;
+
+template <bool _Compact>
+static void BM_compact_find(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_random);
+    std::vector<int> __queries = make_keys(__state.range(0),pattern_random,2);
+    for (std::size_t __i = 0; __i < __queries.size(); __i += 2)
+        __queries[__i] = __keys[mix(__i) % __keys.size()];
+    treap_long_multiset __t;
+    for (int __k : __keys)
+        __t.emplace(__k);
+    if (_Compact)
+        __t.compact();
+    for (auto _ : __state) {
+        std::size_t __hits = 0;
+        for (int __q : __queries)
+            __hits += __t.find(__q) != __t.end();
+        benchmark::DoNotOptimize(__hits);
+    }
+    __state.SetItemsProcessed(__state.iterations() * __queries.size());
+}
+
+static void BM_compact(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_random);
+    for (auto _ : __state) {
+        __state.PauseTiming();
+        treap_long_multiset __t;
+        for (int __k : __keys)
+            __t.emplace(__k);
+        __state.ResumeTiming();
+        __t.compact();
+        benchmark::DoNotOptimize(__t.size());
+        __state.PauseTiming();
+        { treap_long_multiset __dead(std::move(__t)); }
+        __state.ResumeTiming();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+BENCHMARK_TEMPLATE(BM_compact_find,false)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_compact_find,true)->Apply(sizes);
+BENCHMARK(BM_compact)->Apply(sizes);
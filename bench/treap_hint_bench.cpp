@@ -0,0 +1,94 @@
+// emplace_hint() and find_from() finger search on nearly sorted keys
+
+#include <cstdio>
+#include <string>
+#include "treap_bench_common.hpp"
+
+using namespace TreapBench;
+
+typedef TreapTree::_Treap<long> treap_long_multiset;
+typedef std::multiset<long> std_long_multiset;
+typedef TreapTree::_Treap<std::string> treap_string_multiset;
+typedef std::multiset<std::string> std_string_multiset;
+
+enum hint_mode { hint_none,hint_end,hint_last };
+
+/*
+ * @brief i * 16 plus up to 255,so each key lands at most 16 places before the end
+ */
+static long nearly_sorted_key(std::size_t __i,long*) { return static_cast<long>(__i * 16 + mix(__i) % 256); }
+
+/*
+ * @brief the same keys as paths with a long common prefix,where comparisons cost more than the walk
+ */
+static std::string nearly_sorted_key(std::size_t __i,std::string*) {
+    char __buf[48];
+    std::snprintf(__buf,sizeof(__buf),"/usr/share/treap/%012ld",nearly_sorted_key(__i,static_cast<long*>(nullptr)));
+    return __buf;
+}
+
+template <typename _Key>
+static std::vector<_Key> make_nearly_sorted(std::size_t __n) {
+    std::vector<_Key> __keys;
+    __keys.reserve(__n);
+    for (std::size_t __i = 0; __i < __n; ++__i)
+        __keys.push_back(nearly_sorted_key(__i,static_cast<_Key*>(nullptr)));
+    return __keys;
+}
+
+template <typename _Container,hint_mode _Mode>
+static void BM_hint_insert(benchmark::State& __state) {
+    typedef typename _Container::key_type _Key;
+    const std::vector<_Key> __keys = make_nearly_sorted<_Key>(__state.range(0));
+    for (auto _ : __state) {
+        _Container __c;
+        typename _Container::iterator __last = __c.end();
+        for (const _Key& __k : __keys) {
+            if (_Mode == hint_none)
+                __c.emplace(__k);
+            else
+                __last = __c.emplace_hint(_Mode == hint_end ? __c.end() : __last,__k);
+        }
+        benchmark::DoNotOptimize(__c.size());
+        __state.PauseTiming();
+        { _Container __dead(std::move(__c)); }
+        __state.ResumeTiming();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+/*
+ * lookups of the keys in arrival order,each find_from() starts at the previous hit
+ */
+template <typename _Treap,bool _From_last>
+static void BM_hint_find(benchmark::State& __state) {
+    typedef typename _Treap::key_type _Key;
+    const std::vector<_Key> __keys = make_nearly_sorted<_Key>(__state.range(0));
+    _Treap __t;
+    for (const _Key& __k : __keys)
+        __t.emplace_hint(__t.end(),__k);
+    for (auto _ : __state) {
+        std::size_t __hits = 0;
+        typename _Treap::const_iterator __last = __t.begin();
+        for (const _Key& __k : __keys) {
+            typename _Treap::const_iterator __it = _From_last ? __t.find_from(__last,__k) : __t.find(__k);
+            if (__it != __t.end()) {
+                __last = __it;
+                ++__hits;
+            }
+        }
+        benchmark::DoNotOptimize(__hits);
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+#define TREAP_BENCH_HINT(__treap,__std) \
+    BENCHMARK_TEMPLATE(BM_hint_insert,__treap,hint_none)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(BM_hint_insert,__treap,hint_end)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(BM_hint_insert,__treap,hint_last)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(BM_hint_insert,__std,hint_end)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(BM_hint_find,__treap,false)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(BM_hint_find,__treap,true)->Apply(sizes)
+
+TREAP_BENCH_HINT(treap_long_multiset,std_long_multiset);
+TREAP_BENCH_HINT(treap_string_multiset,std_string_multiset);
@@ -0,0 +1,57 @@
+// _Index_treap against the pointer-linked _Treap at 1M,10M and 100M keys
+
+#include "treap_bench_common.hpp"
+#include "treap_index.hpp"
+
+using namespace TreapBench;
+
+typedef TreapTree::_Index_treap<int> index_multiset;
+
+/*
+ * @brief 1M,10M and 100M keys,capped by TREAP_BENCH_MAX_N;build with TREAP_BENCH_LARGE for all three
+ */
+static void layout_sizes(benchmark::internal::Benchmark* __b) {
+    for (long __n = 1000000; __n <= TREAP_BENCH_MAX_N && __n <= 100000000; __n *= 10)
+        __b->Arg(__n);
+}
+
+template <typename _Container>
+static void BM_layout_insert(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_random);
+    for (auto _ : __state) {
+        _Container __c;
+        for (int __k : __keys)
+            __c.emplace(__k);
+        benchmark::DoNotOptimize(__c.size());
+        __state.PauseTiming();
+        __c.clear();
+        __state.ResumeTiming();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+/*
+ * as many lookups as keys,half of them hits
+ */
+template <typename _Container>
+static void BM_layout_lookup(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_random);
+    std::vector<int> __queries = make_keys(__state.range(0),pattern_random,2);
+    for (std::size_t __i = 0; __i < __queries.size(); __i += 2)
+        __queries[__i] = __keys[mix(__i) % __keys.size()];
+    _Container __c;
+    for (int __k : __keys)
+        __c.emplace(__k);
+    for (auto _ : __state) {
+        std::size_t __hits = 0;
+        for (int __q : __queries)
+            __hits += __c.contains(__q);
+        benchmark::DoNotOptimize(__hits);
+    }
+    __state.SetItemsProcessed(__state.iterations() * __queries.size());
+}
+
+BENCHMARK_TEMPLATE(BM_layout_insert,treap_multiset)->Apply(layout_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_layout_insert,index_multiset)->Apply(layout_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_layout_lookup,treap_multiset)->Apply(layout_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_layout_lookup,index_multiset)->Apply(layout_sizes)->Unit(benchmark::kMillisecond);
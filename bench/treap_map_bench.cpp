@@ -0,0 +1,96 @@
+// treap_set and treap_map against std::set and std::map
+
+#include <map>
+#include "treap_bench_common.hpp"
+#include "treap_map.hpp"
+
+using namespace TreapBench;
+
+typedef TreapTree::treap_set<int> treap_set_int;
+typedef std::set<int> std_set_int;
+typedef TreapTree::treap_map<int,int> treap_map_int;
+typedef std::map<int,int> std_map_int;
+
+/*
+ * @brief the element stored for key __k,the key itself in a set,(__k,__k) in a map
+ */
+template <typename _Container>
+static typename _Container::value_type make_value(int __k,std::true_type) { return __k; }
+
+template <typename _Container>
+static typename _Container::value_type make_value(int __k,std::false_type) { return typename _Container::value_type(__k,__k); }
+
+template <typename _Container>
+static typename _Container::value_type make_value(int __k) {
+    return make_value<_Container>(__k,std::is_same<typename _Container::key_type,typename _Container::value_type>());
+}
+
+template <typename _Container>
+static void fill_unique(_Container& __c,const std::vector<int>& __keys) {
+    for (int __k : __keys)
+        __c.insert(make_value<_Container>(__k));
+}
+
+/*
+ * @brief as many queries as keys,half of them present
+ */
+static std::vector<int> make_queries(const std::vector<int>& __keys) {
+    std::vector<int> __queries = make_keys(__keys.size(),pattern_random,2);
+    for (std::size_t __i = 0; __i < __queries.size(); __i += 2)
+        __queries[__i] = __keys[mix(__i) % __keys.size()];
+    return __queries;
+}
+
+template <typename _Container>
+static void BM_unique_insert(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_random);
+    for (auto _ : __state) {
+        _Container __c;
+        fill_unique(__c,__keys);
+        benchmark::DoNotOptimize(__c.size());
+        __state.PauseTiming();
+        { _Container __dead(std::move(__c)); }
+        __state.ResumeTiming();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+template <typename _Container>
+static void BM_unique_find(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_random);
+    const std::vector<int> __queries = make_queries(__keys);
+    _Container __c;
+    fill_unique(__c,__keys);
+    for (auto _ : __state) {
+        std::size_t __hits = 0;
+        for (int __q : __queries)
+            __hits += __c.find(__q) != __c.end();
+        benchmark::DoNotOptimize(__hits);
+    }
+    __state.SetItemsProcessed(__state.iterations() * __queries.size());
+}
+
+template <typename _Container>
+static void BM_unique_lower_bound(benchmark::State& __state) {
+    const std::vector<int> __keys = make_keys(__state.range(0),pattern_random);
+    const std::vector<int> __queries = make_queries(__keys);
+    _Container __c;
+    fill_unique(__c,__keys);
+    for (auto _ : __state) {
+        std::size_t __ends = 0;
+        for (int __q : __queries)
+            __ends += __c.lower_bound(__q) == __c.end();
+        benchmark::DoNotOptimize(__ends);
+    }
+    __state.SetItemsProcessed(__state.iterations() * __queries.size());
+}
+
+#define TREAP_BENCH_UNIQUE(__bm) \
+    BENCHMARK_TEMPLATE(__bm,treap_set_int)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(__bm,std_set_int)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(__bm,treap_map_int)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(__bm,std_map_int)->Apply(sizes)
+
+TREAP_BENCH_UNIQUE(BM_unique_insert);
+TREAP_BENCH_UNIQUE(BM_unique_find);
+TREAP_BENCH_UNIQUE(BM_unique_lower_bound);
@@ -0,0 +1,78 @@
+// Iterative insert,erase,copy and destroy of _Treap,on random and on chain-shaped trees
+
+#include "treap_bench_common.hpp"
+
+using namespace TreapBench;
+
+/*
+ * @brief a Treap whose depth is its size:priorities fall with key order
+ *
+ * Keys come in descending order,each new minimum rotates straight up to the root.
+ */
+static void fill_chain(treap_multiset& __t,std::size_t __n) {
+    for (std::size_t __i = 0; __i < __n; ++__i)
+        __t.emplace_with_priority(static_cast<unsigned int>(__i + 1),static_cast<int>(__n - 1 - __i));
+}
+
+/*
+ * erase(key) of keys present range(1) times each,every equal range goes in one split
+ */
+static void BM_erase_key_range(benchmark::State& __state) {
+    const std::size_t __n = __state.range(0);
+    const std::size_t __copies = __state.range(1);
+    std::vector<int> __keys = make_keys(__n / __copies,pattern_random);
+    std::vector<int> __all;
+    __all.reserve(__n);
+    for (std::size_t __c = 0; __c < __copies; ++__c)
+        __all.insert(__all.end(),__keys.begin(),__keys.end());
+    std::shuffle(__all.begin(),__all.end(),std::mt19937(3));
+    std::shuffle(__keys.begin(),__keys.end(),std::mt19937(4));
+    for (auto _ : __state) {
+        __state.PauseTiming();
+        treap_multiset __t;
+        fill(__t,__all);
+        __state.ResumeTiming();
+        for (int __k : __keys)
+            __t.erase(__k);
+        benchmark::DoNotOptimize(__t.size());
+    }
+    __state.SetItemsProcessed(__state.iterations() * __all.size());
+}
+
+/*
+ * copy construction and destruction of a chain,which a recursive walk could not survive
+ */
+static void BM_copy_chain(benchmark::State& __state) {
+    treap_multiset __t;
+    fill_chain(__t,__state.range(0));
+    for (auto _ : __state) {
+        treap_multiset __c(__t);
+        benchmark::DoNotOptimize(__c.size());
+        __state.PauseTiming();
+        { treap_multiset __dead(std::move(__c)); }
+        __state.ResumeTiming();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __t.size());
+}
+
+static void BM_destroy_chain(benchmark::State& __state) {
+    for (auto _ : __state) {
+        __state.PauseTiming();
+        treap_multiset* __t = new treap_multiset;
+        fill_chain(*__t,__state.range(0));
+        __state.ResumeTiming();
+        delete __t;
+    }
+    __state.SetItemsProcessed(__state.iterations() * __state.range(0));
+}
+
+static void erase_args(benchmark::internal::Benchmark* __b) {
+    for (long __n = 1000; __n <= TREAP_BENCH_MAX_N; __n *= 10) {
+        __b->Args({__n,1});
+        __b->Args({__n,8});
+    }
+}
+
+BENCHMARK(BM_erase_key_range)->Apply(erase_args);
+BENCHMARK(BM_copy_chain)->Apply(sizes);
+BENCHMARK(BM_destroy_chain)->Apply(sizes);
@@ -0,0 +1,67 @@
+// Insertion cost of _Treap under each _PriorityGen policy
+
+#include "treap_bench_common.hpp"
+
+using namespace TreapBench;
+
+typedef TreapTree::treap_random_priority random_priority;
+typedef TreapTree::treap_hash_priority<int> hash_priority;
+
+/*
+ * @brief the draw generaterand() made before the policies,std::mt19937 through uniform_int_distribution
+ */
+struct mt19937_priority
+{
+    std::mt19937 _M_engine;
+    std::uniform_int_distribution<unsigned int> _M_dist;
+
+    mt19937_priority() : _M_engine(std::random_device{}()),_M_dist(0,TreapTree::MAX_PRIORITY - 1) {}
+
+    unsigned int operator()(int) { return _M_dist(_M_engine); }
+};
+
+template <typename _PriorityGen>
+struct priority_treap
+{
+    typedef TreapTree::_Treap<int,std::less<int>,std::allocator<int>,int,std::_Identity<int>,_PriorityGen> type;
+};
+
+/*
+ * a single draw,what the policy adds to every insertion
+ */
+template <typename _PriorityGen>
+static void BM_priority_draw(benchmark::State& __state) {
+    _PriorityGen __gen;
+    int __k = 0;
+    for (auto _ : __state) {
+        unsigned int __p = __gen(__k++);
+        benchmark::DoNotOptimize(__p);
+    }
+    __state.SetItemsProcessed(__state.iterations());
+}
+
+template <typename _PriorityGen,key_pattern _Pattern>
+static void BM_priority_insert(benchmark::State& __state) {
+    typedef typename priority_treap<_PriorityGen>::type _Container;
+    const std::vector<int> __keys = make_keys(__state.range(0),_Pattern);
+    for (auto _ : __state) {
+        _Container __c;
+        for (int __k : __keys)
+            __c.emplace(__k);
+        benchmark::DoNotOptimize(__c.size());
+        __state.PauseTiming();
+        { _Container __dead(std::move(__c)); }
+        __state.ResumeTiming();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __keys.size());
+}
+
+BENCHMARK_TEMPLATE(BM_priority_draw,mt19937_priority);
+BENCHMARK_TEMPLATE(BM_priority_draw,random_priority);
+BENCHMARK_TEMPLATE(BM_priority_draw,hash_priority);
+BENCHMARK_TEMPLATE(BM_priority_insert,mt19937_priority,pattern_random)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_priority_insert,random_priority,pattern_random)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_priority_insert,hash_priority,pattern_random)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_priority_insert,mt19937_priority,pattern_sorted)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_priority_insert,random_priority,pattern_sorted)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_priority_insert,hash_priority,pattern_sorted)->Apply(sizes);
@@ -0,0 +1,138 @@
+// treap_priority_queue against a __gnu_pbds pairing heap kept addressable by an id map
+
+#include <unordered_map>
+#include <ext/pb_ds/priority_queue.hpp>
+#include "treap_bench_common.hpp"
+#include "treap_queue.hpp"
+
+using namespace TreapBench;
+
+typedef TreapTree::treap_priority_queue<int> treap_queue;
+
+/*
+ * @brief a pb_ds heap plus the id -> point_iterator map that push/update/erase by id need
+ *
+ * meld() moves the map of the smaller queue into the larger one and drops ids queued in both,
+ * as treap_priority_queue::meld() does.
+ */
+template <typename _Tag>
+struct pbds_queue
+{
+    typedef std::pair<unsigned int,int> _Entry;
+
+    struct _Entry_less
+    {
+        bool operator()(const _Entry& __a,const _Entry& __b) const { return __a.first < __b.first; }
+    };
+
+    typedef __gnu_pbds::priority_queue<_Entry,_Entry_less,_Tag> _Heap;
+
+    _Heap _M_heap;
+    std::unordered_map<int,typename _Heap::point_iterator> _M_ids;
+
+    bool empty() const { return _M_ids.empty(); }
+
+    std::size_t size() const { return _M_ids.size(); }
+
+    void push(int __id,unsigned int __p) {
+        if (_M_ids.find(__id) == _M_ids.end())
+            _M_ids.emplace(__id,_M_heap.push(_Entry(__p,__id)));
+    }
+
+    void pop() {
+        _M_ids.erase(_M_heap.top().second);
+        _M_heap.pop();
+    }
+
+    void update_priority(int __id,unsigned int __p) {
+        typename std::unordered_map<int,typename _Heap::point_iterator>::iterator __it = _M_ids.find(__id);
+        if (__it != _M_ids.end())
+            _M_heap.modify(__it->second,_Entry(__p,__id));
+    }
+
+    void meld(pbds_queue& __x) {
+        if (_M_ids.size() < __x._M_ids.size()) {
+            _M_ids.swap(__x._M_ids);
+            _M_heap.swap(__x._M_heap);
+        }
+        for (const auto& __e : __x._M_ids)
+            if (!_M_ids.insert(__e).second)
+                __x._M_heap.erase(__e.second);
+        _M_heap.join(__x._M_heap);
+        __x._M_ids.clear();
+    }
+};
+
+typedef pbds_queue<__gnu_pbds::pairing_heap_tag> pairing_queue;
+
+struct _Queue_item { int _M_id; unsigned int _M_priority; };
+
+static std::vector<_Queue_item> make_items(std::size_t __n,std::uint64_t __seed) {
+    const std::vector<int> __ids = make_keys(__n,pattern_random,__seed);
+    std::vector<_Queue_item> __items(__n);
+    for (std::size_t __i = 0; __i < __n; ++__i) {
+        __items[__i]._M_id = __ids[__i];
+        __items[__i]._M_priority = static_cast<unsigned int>(mix(__i + __seed) >> 33);
+    }
+    return __items;
+}
+
+/*
+ * tournament:range(0) items spread over range(1) queues,melded pairwise up to one queue,
+ * each meld followed by 8 pops.Only the melds and pops are timed.
+ */
+template <typename _Queue>
+static void BM_meld_tournament(benchmark::State& __state) {
+    const std::size_t __n = __state.range(0);
+    const std::size_t __nqueues = __state.range(1);
+    const std::vector<_Queue_item> __items = make_items(__n,1);
+    for (auto _ : __state) {
+        __state.PauseTiming();
+        std::vector<_Queue> __q(__nqueues);
+        for (std::size_t __i = 0; __i < __n; ++__i)
+            __q[mix(__i) % __nqueues].push(__items[__i]._M_id,__items[__i]._M_priority);
+        __state.ResumeTiming();
+        for (std::size_t __step = 1; __step < __nqueues; __step *= 2)
+            for (std::size_t __k = 0; __k + __step < __nqueues; __k += 2 * __step) {
+                __q[__k].meld(__q[__k + __step]);
+                for (int __j = 0; __j < 8 && !__q[__k].empty(); ++__j)
+                    __q[__k].pop();
+            }
+        benchmark::DoNotOptimize(__q[0].size());
+        __state.PauseTiming();
+        { std::vector<_Queue> __dead(std::move(__q)); }
+        __state.ResumeTiming();
+    }
+    __state.SetItemsProcessed(__state.iterations() * __n);
+}
+
+/*
+ * no meld:push range(0) items,move the priority of every other one,pop them all
+ */
+template <typename _Queue>
+static void BM_push_update_pop(benchmark::State& __state) {
+    const std::vector<_Queue_item> __items = make_items(__state.range(0),2);
+    for (auto _ : __state) {
+        _Queue __q;
+        for (const _Queue_item& __e : __items)
+            __q.push(__e._M_id,__e._M_priority);
+        for (std::size_t __i = 0; __i < __items.size(); __i += 2)
+            __q.update_priority(__items[__i]._M_id,__items[__i]._M_priority ^ 0x5555555u);
+        while (!__q.empty())
+            __q.pop();
+        benchmark::DoNotOptimize(__q.size());
+    }
+    __state.SetItemsProcessed(__state.iterations() * __items.size());
+}
+
+static void meld_args(benchmark::internal::Benchmark* __b) {
+    for (long __n = 100000; __n <= TREAP_BENCH_MAX_N; __n *= 10) {
+        __b->Args({__n,16});
+        __b->Args({__n,1024});
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_meld_tournament,treap_queue)->Apply(meld_args);
+BENCHMARK_TEMPLATE(BM_meld_tournament,pairing_queue)->Apply(meld_args);
+BENCHMARK_TEMPLATE(BM_push_update_pop,treap_queue)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_push_update_pop,pairing_queue)->Apply(sizes);
@@ -0,0 +1,224 @@
+// Concurrent range-partitioned Treap implementation -*- C++ -*-
+// @file concurrent_treap.hpp
+
+#ifndef _CONCURRENT_TREAP_H_
+#define _CONCURRENT_TREAP_H_ 1
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+#if __cplusplus >= 201402L
+#include <shared_mutex>
+#endif
+#include "treap.hpp"
+
+namespace TreapTree {
+
+    /*
+     * @brief thread-safe ordered set made of key-disjoint _Treap shards,each behind its own mutex
+     *
+     * Shard i holds the keys in [bound(i - 1),bound(i)),so an operation locks exactly one shard and
+     * threads working on different key ranges never contend.The bounds are fixed between calls to
+     * rebalance(),which moves elements with split()/merge() so that every shard gets an equal share.
+     *
+     * insert(),erase(),contains() and count() may run concurrently with each other.contains(),
+     * count(),size(),for_each() and snapshot() only read,from C++14 on they take the shard lock
+     * shared so lookups on one shard do not serialize;a C++11 build has no reader-writer mutex and
+     * locks exclusively.clear(),size(),for_each() and snapshot() lock the shards one after another
+     * and are not atomic as a whole.
+     * rebalance() must not overlap any other call.The allocator must be safe to use from several
+     * threads at once,which rules out _Treap_pool_allocator.
+     */
+    template <typename _Key,typename _Compare = std::less<_Key>,typename _Alloc = std::allocator<_Key>>
+    class concurrent_treap
+    {
+    public :
+        typedef _Key key_type;
+        typedef _Key value_type;
+        typedef size_t size_type;
+        typedef _Alloc allocator_type;
+        typedef _Treap<_Key,_Compare,_Alloc> treap_type;
+
+    private :
+#if __cplusplus >= 201703L
+        typedef std::shared_mutex _Mutex;
+        typedef std::shared_lock<_Mutex> _Read_lock;
+#elif __cplusplus >= 201402L
+        typedef std::shared_timed_mutex _Mutex;
+        typedef std::shared_lock<_Mutex> _Read_lock;
+#else
+        typedef std::mutex _Mutex;
+        typedef std::lock_guard<_Mutex> _Read_lock;
+#endif
+        typedef std::lock_guard<_Mutex> _Write_lock;
+
+        struct _Shard
+        {
+            _Mutex _M_mutex;
+            treap_type _M_tree;
+
+            _Shard(const _Compare& __comp,const allocator_type& __a) : _M_tree(__comp,__a) {}
+        };
+
+        _Compare _M_key_compare;
+        allocator_type _M_alloc;
+        std::vector<_Key> _M_bounds;
+        std::vector<std::unique_ptr<_Shard>> _M_shards;
+
+        _Shard& _M_shard_for(const key_type& __k) {
+            return *_M_shards[std::upper_bound(_M_bounds.begin(),_M_bounds.end(),__k,_M_key_compare) - _M_bounds.begin()];
+        }
+
+        void _M_reset_shards(size_type __n) {
+            _M_shards.clear();
+            for (size_type __i = 0; __i < __n; ++__i)
+                _M_shards.emplace_back(new _Shard(_M_key_compare,_M_alloc));
+        }
+
+    public :
+        /*
+         * @brief one shard holding every key,call rebalance() once some data is in
+         */
+        explicit concurrent_treap(const _Compare& __comp = _Compare(),const allocator_type& __a = allocator_type())
+        : _M_key_compare(__comp),_M_alloc(__a) {
+            _M_reset_shards(1);
+        }
+
+        /*
+         * @brief shards split at __bounds,which must be sorted and free of duplicates
+         */
+        explicit concurrent_treap(std::vector<_Key> __bounds,const _Compare& __comp = _Compare(),const allocator_type& __a = allocator_type())
+        : _M_key_compare(__comp),_M_alloc(__a),_M_bounds(std::move(__bounds)) {
+            _M_reset_shards(_M_bounds.size() + 1);
+        }
+
+        concurrent_treap(const concurrent_treap&) = delete;
+
+        concurrent_treap& operator = (const concurrent_treap&) = delete;
+
+        size_type shard_count() const { return _M_shards.size(); }
+
+        /*
+         * @brief Inserts __k unless an equivalent key is present
+         * @return true if __k was inserted
+         */
+        bool insert(const key_type& __k) {
+            _Shard& __s = _M_shard_for(__k);
+            _Write_lock __lock(__s._M_mutex);
+            if (__s._M_tree.contains(__k))
+                return false;
+            __s._M_tree.emplace(__k);
+            return true;
+        }
+
+        /*
+         * @return number of elements removed,0 or 1
+         */
+        size_type erase(const key_type& __k) {
+            _Shard& __s = _M_shard_for(__k);
+            _Write_lock __lock(__s._M_mutex);
+            return __s._M_tree.erase(__k);
+        }
+
+        bool contains(const key_type& __k) {
+            _Shard& __s = _M_shard_for(__k);
+            _Read_lock __lock(__s._M_mutex);
+            return __s._M_tree.contains(__k);
+        }
+
+        size_type count(const key_type& __k) { return contains(__k) ? 1 : 0; }
+
+        size_type size() {
+            size_type __n = 0;
+            for (std::unique_ptr<_Shard>& __s : _M_shards) {
+                _Read_lock __lock(__s->_M_mutex);
+                __n += __s->_M_tree.size();
+            }
+            return __n;
+        }
+
+        bool empty() { return size() == 0; }
+
+        void clear() {
+            for (std::unique_ptr<_Shard>& __s : _M_shards) {
+                _Write_lock __lock(__s->_M_mutex);
+                __s->_M_tree.clear();
+            }
+        }
+
+        /*
+         * @brief calls __f on every element in key order,holding one shard lock at a time
+         */
+        template <typename _Function>
+        void for_each(_Function __f) {
+            for (std::unique_ptr<_Shard>& __s : _M_shards) {
+                _Read_lock __lock(__s->_M_mutex);
+                for (const value_type& __v : __s->_M_tree)
+                    __f(__v);
+            }
+        }
+
+        /*
+         * @brief copies the elements into a single _Treap,shard by shard
+         */
+        treap_type snapshot() {
+            treap_type __result(_M_key_compare,_M_alloc);
+            for (std::unique_ptr<_Shard>& __s : _M_shards) {
+                _Read_lock __lock(__s->_M_mutex);
+                __result.merge(treap_type(__s->_M_tree));
+            }
+            return __result;
+        }
+
+        /*
+         * @brief Redistributes the elements over __nshards shards of equal size in O(nshards log n)
+         * @param __nshards number of shards,0 keeps the current count;never more than size() are made
+         *
+         * No element is copied,the shards are merged into one _Treap and split again at the
+         * order statistics i * size() / __nshards.The bounds and the new shards are allocated
+         * before any element moves,so if that throws the set is left as it was.
+         */
+        void rebalance(size_type __nshards = 0);
+    };
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    void concurrent_treap<_Key,_Compare,_Alloc>::rebalance(size_type __nshards) {
+        if (__nshards == 0)
+            __nshards = _M_shards.size();
+
+        size_type __n = 0;
+        for (std::unique_ptr<_Shard>& __s : _M_shards)
+            __n += __s->_M_tree.size();
+        if (__nshards > __n)
+            __nshards = __n == 0 ? 1 : __n;
+
+        // the shards are key-disjoint and in key order,so order statistic k lies in the shard
+        // where the running size first exceeds k
+        std::vector<_Key> __bounds;
+        __bounds.reserve(__nshards - 1);
+        size_type __src = 0,__before = 0;
+        for (size_type __i = 1; __i < __nshards; ++__i) {
+            const size_type __k = __n * __i / __nshards;
+            while (__k >= __before + _M_shards[__src]->_M_tree.size())
+                __before += _M_shards[__src++]->_M_tree.size();
+            __bounds.push_back(*_M_shards[__src]->_M_tree.find_by_order(__k - __before));
+        }
+
+        std::vector<std::unique_ptr<_Shard>> __shards;
+        __shards.reserve(__nshards);
+        for (size_type __i = 0; __i < __nshards; ++__i)
+            __shards.emplace_back(new _Shard(_M_key_compare,_M_alloc));
+        treap_type __all(_M_key_compare,_M_alloc);
+
+        for (std::unique_ptr<_Shard>& __s : _M_shards)
+            __all.merge(__s->_M_tree);
+        for (size_type __i = __nshards - 1; __i > 0; --__i)
+            __shards[__i]->_M_tree.merge(__all.split(__bounds[__i - 1]));
+        __shards[0]->_M_tree.merge(__all);
+        _M_shards.swap(__shards);
+        _M_bounds.swap(__bounds);
+    }
+}
+
+#endif
@@ -0,0 +1,532 @@
+// Persistent (path-copying) Treap implementation -*- C++ -*-
+// @file persistent_treap.hpp
+
+#ifndef _PERSISTENT_TREAP_H_
+#define _PERSISTENT_TREAP_H_ 1
+
+#include <atomic>
+#include <vector>
+#include <iterator>
+#include "treap.hpp"
+
+namespace TreapTree {
+
+    /*
+     * @brief node of persistent_treap
+     *
+     * There is no parent link,a node may hang below several versions at once.Each child link and
+     * each version root holds one reference,the count is atomic so that versions can be released
+     * on any thread.
+     */
+    template <typename _Val>
+    struct _Persistent_treap_node
+    {
+        typedef _Persistent_treap_node<_Val>* _Link_type;
+
+        _Link_type _M_children[2];
+        std::atomic<unsigned int> _M_refcount;
+
+        unsigned int _M_size;
+        unsigned int _M_Priority;
+
+        __gnu_cxx::__aligned_membuf<_Val> _M_storage;
+
+        _Val* _M_valptr() { return _M_storage._M_ptr(); }
+
+        const _Val* _M_valptr() const { return _M_storage._M_ptr(); }
+    };
+
+    /*
+     * @brief forward iterator over one version of a persistent_treap,keeps a finger stack
+     *
+     * Valid for as long as some persistent_treap still holds the version it was taken from.
+     */
+    template <typename _Val>
+    struct _Persistent_treap_iterator
+    {
+        typedef _Val value_type;
+        typedef const _Val* pointer;
+        typedef const _Val& reference;
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::ptrdiff_t difference_type;
+
+        typedef _Persistent_treap_iterator<_Val> _Self;
+        typedef const _Persistent_treap_node<_Val>* _Const_Link_type;
+
+        reference operator* () const { return *_M_stack.back()->_M_valptr(); }
+
+        pointer operator->() const { return _M_stack.back()->_M_valptr(); }
+
+        _Self& operator++() {
+            _Const_Link_type __x = _M_stack.back()->_M_children[Direction_Right];
+            _M_stack.pop_back();
+            _M_push_left(__x);
+            return *this;
+        }
+
+        _Self operator++(int) {
+            _Self __tmp = *this;
+            ++*this;
+            return __tmp;
+        }
+
+        bool operator == (const _Self& __x) const {
+            return _M_stack.empty() ? __x._M_stack.empty() : (!__x._M_stack.empty() && _M_stack.back() == __x._M_stack.back());
+        }
+
+        bool operator != (const _Self& __x) const { return !(*this == __x); }
+
+        void _M_push_left(_Const_Link_type __x) {
+            for (; __x != nullptr; __x = __x->_M_children[Direction_Left])
+                _M_stack.push_back(__x);
+        }
+
+        std::vector<_Const_Link_type> _M_stack;
+    };
+
+    /*
+     * @brief fully persistent ordered multiset:every version is an immutable treap sharing structure
+     *
+     * Updates go through split/merge on owned nodes.A node referenced only by the version being
+     * updated is reused in place,a shared one is copied first,so an update allocates at most
+     * O(log n) nodes and snapshot() is a reference-count increment.Every copy is made before the
+     * first link changes,an update that throws leaves the version as it was.
+     *
+     * A persistent_treap object itself is not synchronized:the writer calls snapshot() and hands
+     * the result to readers,which may then search,iterate and destroy it on any thread.
+     */
+    template <typename _Key,typename _Compare = std::less<_Key>,typename _Alloc = std::allocator<_Key>>
+    class persistent_treap
+    {
+        typedef _Persistent_treap_node<_Key> _Node;
+        typedef typename __gnu_cxx::__alloc_traits<_Alloc>::template rebind<_Node>::other _Node_allocator;
+        typedef __gnu_cxx::__alloc_traits<_Node_allocator> _Alloc_traits;
+
+        typedef _Node* _Link_type;
+        typedef const _Node* _Const_Link_type;
+
+    public :
+        typedef _Key key_type;
+        typedef _Key value_type;
+        typedef const value_type& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _Alloc allocator_type;
+
+        typedef _Persistent_treap_iterator<value_type> const_iterator;
+        typedef const_iterator iterator;
+
+    private :
+        struct _Persistent_impl : public _Node_allocator
+        {
+            _Compare _M_key_compare;
+            _Link_type _M_root = nullptr;
+
+            _Persistent_impl() : _Node_allocator(),_M_key_compare() {}
+            _Persistent_impl(const _Compare& __comp,const _Node_allocator& __a) : _Node_allocator(__a),_M_key_compare(__comp) {}
+        };
+
+        _Persistent_impl _M_impl;
+
+        _Node_allocator& _M_get_Node_allocator() { return *static_cast<_Node_allocator*>(&this->_M_impl); }
+
+        const _Node_allocator& _M_get_Node_allocator() const { return *static_cast<const _Node_allocator*>(&this->_M_impl); }
+
+        static const _Key& _S_key(_Const_Link_type __x) { return *__x->_M_valptr(); }
+
+        static unsigned int _S_size(_Const_Link_type __x) { return __x == nullptr ? 0 : __x->_M_size; }
+
+        static void _S_acquire(_Link_type __x) {
+            if (__x != nullptr)
+                __x->_M_refcount.fetch_add(1,std::memory_order_relaxed);
+        }
+
+        template <typename... _Args>
+        _Link_type _M_create_node(unsigned int __priority,_Args&&... __args) {
+            _Link_type __node = _Alloc_traits::allocate(_M_get_Node_allocator(),1);
+            try {
+                _Alloc_traits::construct(_M_get_Node_allocator(),__node->_M_valptr(),std::forward<_Args>(__args)...);
+            }
+            catch (...) {
+                _Alloc_traits::deallocate(_M_get_Node_allocator(),__node,1);
+                throw;
+            }
+            ::new(&__node->_M_refcount) std::atomic<unsigned int>(1);
+            __node->_M_children[Direction_Left] = nullptr;
+            __node->_M_children[Direction_Right] = nullptr;
+            __node->_M_size = 1;
+            __node->_M_Priority = __priority;
+            return __node;
+        }
+
+        void _M_release(_Link_type __x) noexcept;
+
+        void _M_own(_Link_type& __slot);
+
+        template <typename _Pred>
+        size_type _M_own_path(_Pred __goes_left);
+
+        void _M_own_seam(_Link_type* __lslot,_Link_type* __rslot);
+
+        static void _S_split(_Link_type __t,size_type __n,_Link_type& __l,_Link_type& __r) noexcept;
+
+        static _Link_type _S_merge(_Link_type __l,_Link_type __r) noexcept;
+
+        void _M_replace_root(_Link_type __root) {
+            _M_release(_M_impl._M_root);
+            _M_impl._M_root = __root;
+        }
+
+    public :
+        persistent_treap() {}
+
+        explicit persistent_treap(const _Compare& __comp,const allocator_type& __a = allocator_type()) : _M_impl(__comp,_Node_allocator(__a)) {}
+
+        template <typename _InputIterator>
+        persistent_treap(_InputIterator __first,_InputIterator __last,const _Compare& __comp = _Compare(),const allocator_type& __a = allocator_type())
+        : _M_impl(__comp,_Node_allocator(__a)) {
+            for (; __first != __last; ++__first)
+                insert(*__first);
+        }
+
+        /*
+         * @brief O(1),the copy shares every node with __x
+         */
+        persistent_treap(const persistent_treap& __x) : _M_impl(__x._M_impl._M_key_compare,__x._M_get_Node_allocator()) {
+            _S_acquire(__x._M_impl._M_root);
+            _M_impl._M_root = __x._M_impl._M_root;
+        }
+
+        persistent_treap(persistent_treap&& __x) noexcept(std::is_nothrow_copy_constructible<_Compare>::value)
+        : _M_impl(__x._M_impl._M_key_compare,__x._M_get_Node_allocator()) {
+            _M_impl._M_root = __x._M_impl._M_root;
+            __x._M_impl._M_root = nullptr;
+        }
+
+        ~persistent_treap() { _M_release(_M_impl._M_root); }
+
+        persistent_treap& operator = (const persistent_treap& __x) {
+            _S_acquire(__x._M_impl._M_root);
+            _M_replace_root(__x._M_impl._M_root);
+            return *this;
+        }
+
+        persistent_treap& operator = (persistent_treap&& __x) noexcept {
+            if (this != &__x) {
+                _M_replace_root(__x._M_impl._M_root);
+                __x._M_impl._M_root = nullptr;
+            }
+            return *this;
+        }
+
+        /*
+         * @brief an immutable view of the current version in O(1)
+         */
+        persistent_treap snapshot() const { return persistent_treap(*this); }
+
+        allocator_type get_allocator() const { return allocator_type(_M_get_Node_allocator()); }
+
+        const_iterator begin() const {
+            const_iterator __it;
+            __it._M_push_left(_M_impl._M_root);
+            return __it;
+        }
+
+        const_iterator end() const { return const_iterator(); }
+
+        size_type size() const { return _S_size(_M_impl._M_root); }
+
+        bool empty() const { return _M_impl._M_root == nullptr; }
+
+        void clear() { _M_replace_root(nullptr); }
+
+        /*
+         * @brief Inserts a copy of __v,copying at most the O(log n) shared nodes on its path
+         */
+        void insert(const value_type& __v);
+
+        /*
+         * @brief Removes every element equivalent to __k
+         * @return number of elements removed
+         */
+        size_type erase(const key_type& __k);
+
+        /*
+         * @brief Moves every element not less than __k into a new version,both share the untouched nodes
+         */
+        persistent_treap split(const key_type& __k);
+
+        /*
+         * @brief Concatenates __x after this version,every element of __x must not order before ours
+         *
+         * __x keeps its own version,the result shares its nodes.
+         */
+        void merge(const persistent_treap& __x) {
+            persistent_treap __r(__x);
+            _M_own_seam(&_M_impl._M_root,&__r._M_impl._M_root);
+            _M_impl._M_root = _S_merge(_M_impl._M_root,__r._M_impl._M_root);
+            __r._M_impl._M_root = nullptr;
+        }
+
+        const_iterator lower_bound(const key_type& __k) const;
+
+        const_iterator find(const key_type& __k) const {
+            const_iterator __it = lower_bound(__k);
+            return (__it == end() || _M_impl._M_key_compare(__k,*__it)) ? end() : __it;
+        }
+
+        bool contains(const key_type& __k) const {
+            for (_Const_Link_type __x = _M_impl._M_root; __x != nullptr; ) {
+                if (_M_impl._M_key_compare(__k,_S_key(__x)))
+                    __x = __x->_M_children[Direction_Left];
+                else if (_M_impl._M_key_compare(_S_key(__x),__k))
+                    __x = __x->_M_children[Direction_Right];
+                else
+                    return true;
+            }
+            return false;
+        }
+
+        /*
+         * @brief the element at in-order position __k in O(log n),end() if __k >= size()
+         */
+        const_iterator find_by_order(size_type __k) const;
+    };
+
+    /*
+     * @brief drop one reference to __x,freeing every node that becomes unreferenced
+     *
+     * A dead node keeps its right child pending and is pushed on a stack threaded through its
+     * left link,so the teardown needs no memory of its own.
+     */
+    template <typename _Key,typename _Compare,typename _Alloc>
+    void persistent_treap<_Key,_Compare,_Alloc>::_M_release(_Link_type __x) noexcept {
+        _Link_type __dead = nullptr;
+        for (;;) {
+            if (__x != nullptr && __x->_M_refcount.fetch_sub(1,std::memory_order_acq_rel) == 1) {
+                _Alloc_traits::destroy(_M_get_Node_allocator(),__x->_M_valptr());
+                __x->_M_refcount.~atomic();
+                _Link_type __left = __x->_M_children[Direction_Left];
+                __x->_M_children[Direction_Left] = __dead;
+                __dead = __x;
+                __x = __left;
+                continue;
+            }
+            if (__dead == nullptr)
+                break;
+            _Link_type __d = __dead;
+            __dead = __d->_M_children[Direction_Left];
+            __x = __d->_M_children[Direction_Right];
+            _Alloc_traits::deallocate(_M_get_Node_allocator(),__d,1);
+        }
+    }
+
+    /*
+     * @brief make the node in __slot one only the caller references
+     *
+     * A shared node is replaced by a copy that takes a reference to each child,the reference
+     * held by __slot moves to the copy.The tree keeps its contents either way,if the copy throws
+     * nothing has changed.
+     */
+    template <typename _Key,typename _Compare,typename _Alloc>
+    void persistent_treap<_Key,_Compare,_Alloc>::_M_own(_Link_type& __slot) {
+        _Link_type __x = __slot;
+        if (__x->_M_refcount.load(std::memory_order_acquire) == 1)
+            return;
+
+        _Link_type __c = _M_create_node(__x->_M_Priority,*__x->_M_valptr());
+        for (unsigned int __dir = Direction_Left; __dir <= Direction_Right; ++__dir) {
+            __c->_M_children[__dir] = __x->_M_children[__dir];
+            _S_acquire(__c->_M_children[__dir]);
+        }
+        __c->_M_size = __x->_M_size;
+        __slot = __c;
+        _M_release(__x);
+    }
+
+    /*
+     * @brief own every node on the search path of the boundary given by __goes_left
+     * @return the number of elements for which __goes_left holds
+     *
+     * __goes_left must hold for a prefix of the elements.Afterwards _S_split() at the returned
+     * count and the _S_merge() of its halves touch owned nodes only.
+     */
+    template <typename _Key,typename _Compare,typename _Alloc>
+    template <typename _Pred>
+    typename persistent_treap<_Key,_Compare,_Alloc>::size_type
+    persistent_treap<_Key,_Compare,_Alloc>::_M_own_path(_Pred __goes_left) {
+        size_type __n = 0;
+        for (_Link_type* __slot = &_M_impl._M_root; *__slot != nullptr; ) {
+            _M_own(*__slot);
+            _Link_type __x = *__slot;
+            if (__goes_left(__x)) {
+                __n += _S_size(__x->_M_children[Direction_Left]) + 1;
+                __slot = &__x->_M_children[Direction_Right];
+            }
+            else
+                __slot = &__x->_M_children[Direction_Left];
+        }
+        return __n;
+    }
+
+    /*
+     * @brief own the nodes _S_merge() of the trees in *__lslot and *__rslot will relink
+     */
+    template <typename _Key,typename _Compare,typename _Alloc>
+    void persistent_treap<_Key,_Compare,_Alloc>::_M_own_seam(_Link_type* __lslot,_Link_type* __rslot) {
+        while (*__lslot != nullptr && *__rslot != nullptr) {
+            if ((*__lslot)->_M_Priority > (*__rslot)->_M_Priority) {
+                _M_own(*__lslot);
+                __lslot = &(*__lslot)->_M_children[Direction_Right];
+            }
+            else {
+                _M_own(*__rslot);
+                __rslot = &(*__rslot)->_M_children[Direction_Left];
+            }
+        }
+    }
+
+    /*
+     * @brief split consuming the reference to __t,the first __n elements go to __l
+     *
+     * Every node on the boundary path must be owned.Sizes are set on the way down,nothing is
+     * compared or allocated.
+     */
+    template <typename _Key,typename _Compare,typename _Alloc>
+    void persistent_treap<_Key,_Compare,_Alloc>::_S_split(_Link_type __t,size_type __n,_Link_type& __l,_Link_type& __r) noexcept {
+        _Link_type* __lslot = &__l;
+        _Link_type* __rslot = &__r;
+
+        while (__t != nullptr) {
+            // the reference held by the child slot moves into the loop,the slot is refilled later
+            const size_type __lsize = _S_size(__t->_M_children[Direction_Left]);
+            if (__n > __lsize) {
+                __t->_M_size = __n;
+                __n -= __lsize + 1;
+                *__lslot = __t;
+                __lslot = &__t->_M_children[Direction_Right];
+                __t = *__lslot;
+            }
+            else {
+                __t->_M_size -= __n;
+                *__rslot = __t;
+                __rslot = &__t->_M_children[Direction_Left];
+                __t = *__rslot;
+            }
+        }
+        *__lslot = nullptr;
+        *__rslot = nullptr;
+    }
+
+    /*
+     * @brief merge consuming the references to __l and __r,every element of __l orders first
+     *
+     * The nodes on the seam must be owned.A node taken from one side gains all that is left of
+     * the other below it,so sizes are set on the way down.
+     */
+    template <typename _Key,typename _Compare,typename _Alloc>
+    typename persistent_treap<_Key,_Compare,_Alloc>::_Link_type
+    persistent_treap<_Key,_Compare,_Alloc>::_S_merge(_Link_type __l,_Link_type __r) noexcept {
+        _Link_type __root = nullptr;
+        _Link_type* __slot = &__root;
+
+        while (__l != nullptr && __r != nullptr) {
+            if (__l->_M_Priority > __r->_M_Priority) {
+                __l->_M_size += __r->_M_size;
+                *__slot = __l;
+                __slot = &__l->_M_children[Direction_Right];
+                __l = *__slot;
+            }
+            else {
+                __r->_M_size += __l->_M_size;
+                *__slot = __r;
+                __slot = &__r->_M_children[Direction_Left];
+                __r = *__slot;
+            }
+        }
+        *__slot = __l != nullptr ? __l : __r;
+        return __root;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    void persistent_treap<_Key,_Compare,_Alloc>::insert(const value_type& __v) {
+        _Link_type __z = _M_create_node(generaterand(),__v);
+        size_type __n;
+        try {
+            __n = _M_own_path([&](_Link_type __x) { return !_M_impl._M_key_compare(*__z->_M_valptr(),_S_key(__x)); });
+        }
+        catch (...) {
+            _M_release(__z);
+            throw;
+        }
+        _Link_type __l,__r;
+        _S_split(_M_impl._M_root,__n,__l,__r);
+        _M_impl._M_root = _S_merge(_S_merge(__l,__z),__r);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    typename persistent_treap<_Key,_Compare,_Alloc>::size_type
+    persistent_treap<_Key,_Compare,_Alloc>::erase(const key_type& __k) {
+        if (!contains(__k))
+            return 0;
+
+        // the nodes of the equal range between both paths are dropped,the seam of __l and __r lies on the paths
+        const size_type __lo = _M_own_path([&](_Link_type __x) { return _M_impl._M_key_compare(_S_key(__x),__k); });
+        const size_type __hi = _M_own_path([&](_Link_type __x) { return !_M_impl._M_key_compare(__k,_S_key(__x)); });
+
+        _Link_type __l,__m,__r;
+        _S_split(_M_impl._M_root,__lo,__l,__m);
+        _S_split(__m,__hi - __lo,__m,__r);
+        _M_impl._M_root = _S_merge(__l,__r);
+        _M_release(__m);
+        return __hi - __lo;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    persistent_treap<_Key,_Compare,_Alloc> persistent_treap<_Key,_Compare,_Alloc>::split(const key_type& __k) {
+        persistent_treap __right(_M_impl._M_key_compare,get_allocator());
+        const size_type __n = _M_own_path([&](_Link_type __x) { return _M_impl._M_key_compare(_S_key(__x),__k); });
+        _S_split(_M_impl._M_root,__n,_M_impl._M_root,__right._M_impl._M_root);
+        return __right;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    typename persistent_treap<_Key,_Compare,_Alloc>::const_iterator
+    persistent_treap<_Key,_Compare,_Alloc>::lower_bound(const key_type& __k) const {
+        const_iterator __it;
+        for (_Const_Link_type __x = _M_impl._M_root; __x != nullptr; ) {
+            if (!_M_impl._M_key_compare(_S_key(__x),__k)) {
+                __it._M_stack.push_back(__x);
+                __x = __x->_M_children[Direction_Left];
+            }
+            else
+                __x = __x->_M_children[Direction_Right];
+        }
+        return __it;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    typename persistent_treap<_Key,_Compare,_Alloc>::const_iterator
+    persistent_treap<_Key,_Compare,_Alloc>::find_by_order(size_type __k) const {
+        const_iterator __it;
+        if (__k >= size())
+            return __it;
+        for (_Const_Link_type __x = _M_impl._M_root; __x != nullptr; ) {
+            size_type __lsize = _S_size(__x->_M_children[Direction_Left]);
+            if (__k <= __lsize) {
+                __it._M_stack.push_back(__x);
+                if (__k == __lsize)
+                    break;
+                __x = __x->_M_children[Direction_Left];
+            }
+            else {
+                __k -= __lsize + 1;
+                __x = __x->_M_children[Direction_Right];
+            }
+        }
+        return __it;
+    }
+}
+
+#endif
@@ -0,0 +1,717 @@
+// Implicit-key Treap (sequence container) implementation -*- C++ -*-
+// @file sequence_treap.hpp
+
+#ifndef _SEQUENCE_TREAP_H_
+#define _SEQUENCE_TREAP_H_ 1
+
+#include <cassert>
+#include <stdexcept>
+#include "treap.hpp"
+
+namespace TreapTree {
+
+    /*
+     * @brief default _NodeUpdate of sequence_treap,nodes carry no aggregate,only the reversal flag
+     */
+    struct null_sequence_update {};
+
+    /*
+     * Range-aggregate policies for sequence_treap.A policy names the aggregate kept per subtree
+     * and the lazy tag applied to whole subtrees,and provides
+     *     lift(v)                  aggregate of a single value
+     *     combine(a,b)             aggregate of two adjacent runs,a before b
+     *     apply(v,agg,n,t)         apply tag t to a subtree root's value and to its n-element aggregate
+     *     compose(older,newer)     a single tag equivalent to older followed by newer
+     * combine must be commutative for range_reverse() to leave aggregates correct.
+     */
+    template <typename _Tp>
+    struct sequence_sum_update
+    {
+        typedef _Tp aggregate_type;
+        typedef _Tp tag_type;
+
+        static aggregate_type lift(const _Tp& __v) { return __v; }
+        static aggregate_type combine(const aggregate_type& __a,const aggregate_type& __b) { return __a + __b; }
+        static void apply(_Tp& __v,aggregate_type& __agg,size_t __n,const tag_type& __t) { __v += __t; __agg += __t * static_cast<_Tp>(__n); }
+        static tag_type compose(const tag_type& __older,const tag_type& __newer) { return __older + __newer; }
+    };
+
+    template <typename _Tp>
+    struct sequence_min_update
+    {
+        typedef _Tp aggregate_type;
+        typedef _Tp tag_type;
+
+        static aggregate_type lift(const _Tp& __v) { return __v; }
+        static aggregate_type combine(const aggregate_type& __a,const aggregate_type& __b) { return __b < __a ? __b : __a; }
+        static void apply(_Tp& __v,aggregate_type& __agg,size_t,const tag_type& __t) { __v += __t; __agg += __t; }
+        static tag_type compose(const tag_type& __older,const tag_type& __newer) { return __older + __newer; }
+    };
+
+    template <typename _Tp>
+    struct sequence_max_update
+    {
+        typedef _Tp aggregate_type;
+        typedef _Tp tag_type;
+
+        static aggregate_type lift(const _Tp& __v) { return __v; }
+        static aggregate_type combine(const aggregate_type& __a,const aggregate_type& __b) { return __a < __b ? __b : __a; }
+        static void apply(_Tp& __v,aggregate_type& __agg,size_t,const tag_type& __t) { __v += __t; __agg += __t; }
+        static tag_type compose(const tag_type& __older,const tag_type& __newer) { return __older + __newer; }
+    };
+
+    /*
+     * @brief node of a sequence_treap with null_sequence_update
+     *
+     * A node's child order is current once its ancestors have been pushed,_M_reversed is
+     * pending for its children only.
+     */
+    template <typename _Tp>
+    struct _Sequence_reverse_node : public _Treap_node<_Tp>
+    {
+        bool _M_reversed = false;
+    };
+
+    /*
+     * @brief node of an augmented sequence_treap
+     *
+     * A node's own value,aggregate and child order are always current once its ancestors have
+     * been pushed;_M_tag and _M_reversed are pending for its children only.
+     */
+    template <typename _Tp,typename _NodeUpdate>
+    struct _Sequence_node : public _Sequence_reverse_node<_Tp>
+    {
+        typename _NodeUpdate::aggregate_type _M_aggregate;
+        typename _NodeUpdate::tag_type _M_tag;
+        bool _M_has_tag = false;
+    };
+
+    /*
+     * @brief push/pull hooks handed to _M_split/_M_merge for an augmented sequence_treap
+     */
+    template <typename _Tp,typename _NodeUpdate>
+    struct _Sequence_node_update
+    {
+        typedef _Sequence_node<_Tp,_NodeUpdate> _Node;
+        typedef typename _NodeUpdate::tag_type _Tag;
+
+        static _Node* _S_node(_Treap_node_base* __x) { return static_cast<_Node*>(__x); }
+
+        /*
+         * @brief copy the aggregate and the pending tags of __from into its clone __to
+         */
+        static void _S_copy_state(_Treap_node_base* __to,const _Treap_node_base* __from) {
+            const _Node* __f = static_cast<const _Node*>(__from);
+            _S_node(__to)->_M_aggregate = __f->_M_aggregate;
+            _S_node(__to)->_M_tag = __f->_M_tag;
+            _S_node(__to)->_M_has_tag = __f->_M_has_tag;
+            _S_node(__to)->_M_reversed = __f->_M_reversed;
+        }
+
+        static void _S_apply_tag(_Treap_node_base* __x,const _Tag& __t) {
+            _Node* __n = _S_node(__x);
+            _NodeUpdate::apply(*__n->_M_valptr(),__n->_M_aggregate,__n->_M_size,__t);
+            __n->_M_tag = __n->_M_has_tag ? _NodeUpdate::compose(__n->_M_tag,__t) : __t;
+            __n->_M_has_tag = true;
+        }
+
+        static void _S_apply_reverse(_Treap_node_base* __x) {
+            std::swap(__x->_M_children[Direction_Left],__x->_M_children[Direction_Right]);
+            _S_node(__x)->_M_reversed = !_S_node(__x)->_M_reversed;
+        }
+
+        void _M_push(_Treap_node_base* __x) const {
+            _Node* __n = _S_node(__x);
+            for (unsigned int __dir = Direction_Left; __dir <= Direction_Right; ++__dir) {
+                _Treap_node_base* __c = __x->_M_children[__dir];
+                if (__c == nullptr)
+                    continue;
+                if (__n->_M_reversed)
+                    _S_apply_reverse(__c);
+                if (__n->_M_has_tag)
+                    _S_apply_tag(__c,__n->_M_tag);
+            }
+            __n->_M_reversed = false;
+            __n->_M_has_tag = false;
+        }
+
+        void _M_pull(_Treap_node_base* __x) const {
+            __x->_M_maintain();
+            _Node* __n = _S_node(__x);
+            __n->_M_aggregate = _NodeUpdate::lift(*__n->_M_valptr());
+            if (__x->_M_children[Direction_Left])
+                __n->_M_aggregate = _NodeUpdate::combine(_S_node(__x->_M_children[Direction_Left])->_M_aggregate,__n->_M_aggregate);
+            if (__x->_M_children[Direction_Right])
+                __n->_M_aggregate = _NodeUpdate::combine(__n->_M_aggregate,_S_node(__x->_M_children[Direction_Right])->_M_aggregate);
+        }
+    };
+
+    /*
+     * @brief reversal is the only lazy operation without an aggregate,so range_reverse() works
+     * with every policy
+     */
+    template <typename _Tp>
+    struct _Sequence_node_update<_Tp,null_sequence_update> : public _Treap_size_update
+    {
+        typedef _Sequence_reverse_node<_Tp> _Node;
+
+        static _Node* _S_node(_Treap_node_base* __x) { return static_cast<_Node*>(__x); }
+
+        static void _S_copy_state(_Treap_node_base* __to,const _Treap_node_base* __from) {
+            _S_node(__to)->_M_reversed = static_cast<const _Node*>(__from)->_M_reversed;
+        }
+
+        static void _S_apply_reverse(_Treap_node_base* __x) {
+            std::swap(__x->_M_children[Direction_Left],__x->_M_children[Direction_Right]);
+            _S_node(__x)->_M_reversed = !_S_node(__x)->_M_reversed;
+        }
+
+        void _M_push(_Treap_node_base* __x) const {
+            if (!_S_node(__x)->_M_reversed)
+                return;
+            for (unsigned int __dir = Direction_Left; __dir <= Direction_Right; ++__dir)
+                if (__x->_M_children[__dir] != nullptr)
+                    _S_apply_reverse(__x->_M_children[__dir]);
+            _S_node(__x)->_M_reversed = false;
+        }
+    };
+
+    /*
+     * @brief sequence container on _Treap_node_base where a node's key is its in-order position
+     *
+     * Positions are never stored,they are derived from _M_size on the way down,so inserting
+     * or erasing in the middle costs O(log n) instead of shifting the tail.Iterators are the
+     * ordinary _Treap_iterator and stay valid across every operation except erasure of their
+     * element;slice() and concat() move them along with their nodes.
+     *
+     * range_reverse() is O(log n) with every policy.With a _NodeUpdate policy such as
+     * sequence_sum_update every node also keeps the aggregate of its subtree and a lazy tag,
+     * enabling O(log n) range_query() and range_add().
+     *
+     * Range updates leave tags pending below the cut.The non-const begin(),end() and flush() push
+     * them all down in O(n),once per batch of updates;values reached through iterators obtained
+     * before a range update are stale until then.The const accessors never write to the tree,so
+     * concurrent const readers are safe,and require that nothing is pending:call flush() after
+     * the last range update before handing the sequence to them.
+     */
+    template <typename _Tp,typename _NodeUpdate = null_sequence_update,typename _Alloc = std::allocator<_Tp>>
+    class sequence_treap
+    {
+        typedef _Sequence_node_update<_Tp,_NodeUpdate> _Update;
+        typedef typename _Update::_Node _Node;
+
+        typedef typename __gnu_cxx::__alloc_traits<_Alloc>::template rebind<_Node>::other _Node_allocator;
+
+        typedef __gnu_cxx::__alloc_traits<_Node_allocator> _Alloc_traits;
+
+        typedef _Treap_node_base* _Base_ptr;
+        typedef const _Treap_node_base* _Const_Base_ptr;
+        typedef _Node* _Link_type;
+        typedef const _Node* _Const_Link_type;
+
+    public :
+        typedef _Tp value_type;
+        typedef value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _Alloc allocator_type;
+
+        typedef _Treap_iterator<value_type> iterator;
+        typedef _Treap_const_iterator<value_type> const_iterator;
+
+    private :
+        struct _Sequence_impl : public _Node_allocator
+        {
+            _Treap_node_base _M_header;
+            bool _M_lazy_pending = false;
+
+            _Sequence_impl() : _Node_allocator(),_M_header() { _M_reset(); }
+            _Sequence_impl(const _Node_allocator& __a) : _Node_allocator(__a),_M_header() { _M_reset(); }
+
+            void _M_reset() {
+                this->_M_header._M_parent = nullptr;
+                this->_M_header._M_children[Direction_Left] = &this->_M_header;
+                this->_M_header._M_children[Direction_Right] = &this->_M_header;
+                this->_M_header._M_Priority = MAX_PRIORITY;
+            }
+        };
+
+        _Sequence_impl _M_impl;
+
+        _Node_allocator& _M_get_Node_allocator() { return *static_cast<_Node_allocator*>(&this->_M_impl); }
+
+        const _Node_allocator& _M_get_Node_allocator() const { return *static_cast<const _Node_allocator*>(&this->_M_impl); }
+
+        _Base_ptr& _M_root() { return this->_M_impl._M_header._M_parent; }
+
+        _Const_Base_ptr _M_root() const { return this->_M_impl._M_header._M_parent; }
+
+        _Base_ptr _M_end() { return &this->_M_impl._M_header; }
+
+        template <typename... _Args>
+        _Link_type _M_create_node(_Args&&... __args) {
+            _Link_type __node = _Alloc_traits::allocate(_M_get_Node_allocator(),1);
+            try {
+                ::new(__node) _Node;
+                _Alloc_traits::construct(_M_get_Node_allocator(),__node->_M_valptr(),std::forward<_Args>(__args)...);
+            }
+            catch(...) {
+                __node->~_Node();
+                _Alloc_traits::deallocate(_M_get_Node_allocator(),__node,1);
+                throw;
+            }
+            __node->_M_initialize();
+            __node->_M_Priority = generaterand();
+            _Update()._M_pull(__node);
+            return __node;
+        }
+
+        void _M_drop_node(_Link_type __p) {
+            _Alloc_traits::destroy(_M_get_Node_allocator(),__p->_M_valptr());
+            __p->~_Node();
+            _Alloc_traits::deallocate(_M_get_Node_allocator(),__p,1);
+        }
+
+        void _M_erase(_Base_ptr __x);
+
+        /*
+         * @brief hang a detached subtree under the header,pushing tags down both spines so
+         * that leftmost/rightmost are the true ends
+         */
+        void _M_set_root(_Base_ptr __root) {
+            if (__root == nullptr) {
+                _M_impl._M_reset();
+                return;
+            }
+            _M_root() = __root;
+            __root->_M_parent = _M_end();
+            for (unsigned int __dir = Direction_Left; __dir <= Direction_Right; ++__dir) {
+                _Base_ptr __x = __root;
+                for (_Update()._M_push(__x); __x->_M_children[__dir] != nullptr; _Update()._M_push(__x))
+                    __x = __x->_M_children[__dir];
+                _M_impl._M_header._M_children[__dir] = __x;
+            }
+        }
+
+        void _M_flush();
+
+        /*
+         * @brief copy of the subtree __x with its sizes,priorities and pending tags,detached
+         */
+        _Base_ptr _M_clone(_Const_Base_ptr __x);
+
+        _Base_ptr _M_select(size_type __pos) {
+            _Base_ptr __x = _M_root();
+            while (__x != nullptr) {
+                _Update()._M_push(__x);
+                size_type __lsize = _M_subtree_size(__x->_M_children[Direction_Left]);
+                if (__pos == __lsize)
+                    break;
+                if (__pos < __lsize)
+                    __x = __x->_M_children[Direction_Left];
+                else {
+                    __pos -= __lsize + 1;
+                    __x = __x->_M_children[Direction_Right];
+                }
+            }
+            return __x;
+        }
+
+        /*
+         * @brief _M_select() for const access,which reads the tree as it is and pushes nothing
+         */
+        _Const_Base_ptr _M_select(size_type __pos) const {
+            assert(!_M_impl._M_lazy_pending);
+            _Const_Base_ptr __x = _M_root();
+            while (__x != nullptr) {
+                size_type __lsize = _M_subtree_size(__x->_M_children[Direction_Left]);
+                if (__pos == __lsize)
+                    break;
+                if (__pos < __lsize)
+                    __x = __x->_M_children[Direction_Left];
+                else {
+                    __pos -= __lsize + 1;
+                    __x = __x->_M_children[Direction_Right];
+                }
+            }
+            return __x;
+        }
+
+        _Base_ptr _M_release_root() {
+            _Base_ptr __root = _M_root();
+            if (__root != nullptr)
+                __root->_M_parent = nullptr;
+            _M_impl._M_reset();
+            return __root;
+        }
+
+        /*
+         * @brief split a detached subtree so __l holds its first __n elements
+         */
+        static void _S_split_at(_Base_ptr __t,size_type __n,_Base_ptr& __l,_Base_ptr& __r) {
+            _M_split(__t,[&](_Base_ptr __x) {
+                size_type __lsize = _M_subtree_size(__x->_M_children[Direction_Left]);
+                if (__n <= __lsize)
+                    return false;
+                __n -= __lsize + 1;
+                return true;
+            },__l,__r,_Update());
+        }
+
+    public :
+        sequence_treap() {}
+
+        explicit sequence_treap(const allocator_type& __a) : _M_impl(_Node_allocator(__a)) {}
+
+        sequence_treap(size_type __n,const value_type& __v,const allocator_type& __a = allocator_type()) : _M_impl(_Node_allocator(__a)) {
+            for (; __n != 0; --__n)
+                push_back(__v);
+        }
+
+        template <typename _InputIterator,typename = std::_RequireInputIter<_InputIterator>>
+        sequence_treap(_InputIterator __first,_InputIterator __last,const allocator_type& __a = allocator_type()) : _M_impl(_Node_allocator(__a)) {
+            append(__first,__last);
+        }
+
+        /*
+         * @brief copies the tree shape along with any pending tags,so __x need not be flushed
+         */
+        sequence_treap(const sequence_treap& __x) : _M_impl(_Alloc_traits::_S_select_on_copy(__x._M_get_Node_allocator())) {
+            _M_set_root(_M_clone(__x._M_root()));
+            _M_impl._M_lazy_pending = __x._M_impl._M_lazy_pending;
+        }
+
+        sequence_treap(sequence_treap&& __x) : _M_impl(std::move(__x._M_get_Node_allocator())) {
+            _M_impl._M_lazy_pending = __x._M_impl._M_lazy_pending;
+            _M_set_root(__x._M_release_root());
+        }
+
+        ~sequence_treap() { _M_erase(_M_root()); }
+
+        sequence_treap& operator = (const sequence_treap& __x) {
+            if (this != &__x) {
+                clear();
+                _M_set_root(_M_clone(__x._M_root()));
+                _M_impl._M_lazy_pending = __x._M_impl._M_lazy_pending;
+            }
+            return *this;
+        }
+
+        allocator_type get_allocator() const { return allocator_type(_M_get_Node_allocator()); }
+
+        iterator begin() { _M_flush(); return iterator(this->_M_impl._M_header._M_children[Direction_Left]); }
+
+        const_iterator begin() const {
+            assert(!_M_impl._M_lazy_pending);
+            return const_iterator(this->_M_impl._M_header._M_children[Direction_Left]);
+        }
+
+        iterator end() { _M_flush(); return iterator(&this->_M_impl._M_header); }
+
+        const_iterator end() const {
+            assert(!_M_impl._M_lazy_pending);
+            return const_iterator(&this->_M_impl._M_header);
+        }
+
+        /*
+         * @brief push every pending tag down in O(n),a no-op unless a range update came since the last one
+         */
+        void flush() { _M_flush(); }
+
+        size_type size() const { return _M_subtree_size(_M_root()); }
+
+        bool empty() const { return _M_root() == nullptr; }
+
+        void clear() {
+            _M_erase(_M_release_root());
+            _M_impl._M_lazy_pending = false;
+        }
+
+        /*
+         * @brief random access in O(log n),no bounds check
+         */
+        reference operator[] (size_type __pos) { return *static_cast<_Link_type>(_M_select(__pos))->_M_valptr(); }
+
+        const_reference operator[] (size_type __pos) const { return *static_cast<_Const_Link_type>(_M_select(__pos))->_M_valptr(); }
+
+        reference at(size_type __pos) {
+            if (__pos >= size())
+                throw std::out_of_range("sequence_treap::at");
+            return (*this)[__pos];
+        }
+
+        const_reference at(size_type __pos) const {
+            if (__pos >= size())
+                throw std::out_of_range("sequence_treap::at");
+            return (*this)[__pos];
+        }
+
+        reference front() { return *begin(); }
+
+        reference back() { return *static_cast<_Link_type>(this->_M_impl._M_header._M_children[Direction_Right])->_M_valptr(); }
+
+        /*
+         * @brief Builds an element in place so that it ends up at position __pos
+         * @param __pos position in [0,size()]
+         * @return an iterator that points to the new element
+         */
+        template <typename... _Args>
+        iterator emplace_at(size_type __pos,_Args&&... __args);
+
+        iterator insert_at(size_type __pos,const value_type& __v) { return emplace_at(__pos,__v); }
+
+        iterator insert_at(size_type __pos,value_type&& __v) { return emplace_at(__pos,std::move(__v)); }
+
+        void push_back(const value_type& __v) { emplace_at(size(),__v); }
+
+        void push_front(const value_type& __v) { emplace_at(0,__v); }
+
+        /*
+         * @brief Appends [__first,__last) in O(k) with a Cartesian-tree build along the right spine
+         */
+        template <typename _InputIterator>
+        void append(_InputIterator __first,_InputIterator __last);
+
+        /*
+         * @brief Removes __len elements starting at __pos in O(log n + __len),__len is clamped to the end
+         */
+        void erase_range(size_type __pos,size_type __len) { _M_erase(_M_cut(__pos,__len)); }
+
+        void erase_at(size_type __pos) { erase_range(__pos,1); }
+
+        /*
+         * @brief Moves __len elements starting at __pos into a new sequence in O(log n)
+         * @return the cut out elements,in order
+         */
+        sequence_treap slice(size_type __pos,size_type __len) {
+            sequence_treap __r(get_allocator());
+            __r._M_set_root(_M_cut(__pos,__len));
+            __r._M_impl._M_lazy_pending = _M_impl._M_lazy_pending;
+            return __r;
+        }
+
+        /*
+         * @brief Appends every element of __x in O(log n) and leaves __x empty
+         *
+         * The allocators of both sequences must compare equal.
+         */
+        void concat(sequence_treap& __x) {
+            if (this == &__x)
+                return;
+            _Base_ptr __l = _M_release_root();
+            bool __pending = _M_impl._M_lazy_pending || __x._M_impl._M_lazy_pending;
+            _M_set_root(_M_merge(__l,__x._M_release_root(),_Update()));
+            _M_impl._M_lazy_pending = __pending;
+        }
+
+        void concat(sequence_treap&& __x) { concat(__x); }
+
+        /*
+         * @brief aggregate of the __len elements starting at __pos in O(log n)
+         * @return the combined aggregate,a value-initialized one for an empty range
+         */
+        template <typename _Up = _NodeUpdate>
+        typename _Up::aggregate_type range_query(size_type __pos,size_type __len) {
+            typename _Up::aggregate_type __result = typename _Up::aggregate_type();
+            _Base_ptr __m = _M_cut(__pos,__len);
+            if (__m != nullptr)
+                __result = static_cast<_Link_type>(__m)->_M_aggregate;
+            _M_paste(__pos,__m);
+            return __result;
+        }
+
+        /*
+         * @brief apply the tag __t to the __len elements starting at __pos in O(log n)
+         */
+        template <typename _Up = _NodeUpdate>
+        void range_add(size_type __pos,size_type __len,const typename _Up::tag_type& __t) {
+            _Base_ptr __m = _M_cut(__pos,__len);
+            if (__m != nullptr) {
+                _Update::_S_apply_tag(__m,__t);
+                _M_impl._M_lazy_pending = true;
+            }
+            _M_paste(__pos,__m);
+        }
+
+        /*
+         * @brief reverse the order of the __len elements starting at __pos in O(log n)
+         */
+        template <typename _Up = _NodeUpdate>
+        void range_reverse(size_type __pos,size_type __len) {
+            _Base_ptr __m = _M_cut(__pos,__len);
+            if (__m != nullptr) {
+                _Update::_S_apply_reverse(__m);
+                _M_impl._M_lazy_pending = true;
+            }
+            _M_paste(__pos,__m);
+        }
+
+    private :
+        _Base_ptr _M_cut(size_type __pos,size_type __len);
+
+        void _M_paste(size_type __pos,_Base_ptr __m);
+    };
+
+    template <typename _Tp,typename _NodeUpdate,typename _Alloc>
+    template <typename... _Args>
+    typename sequence_treap<_Tp,_NodeUpdate,_Alloc>::iterator
+    sequence_treap<_Tp,_NodeUpdate,_Alloc>::emplace_at(size_type __pos,_Args&&... __args) {
+        _Link_type __z = _M_create_node(std::forward<_Args>(__args)...);
+        _Base_ptr __l,__r;
+        _S_split_at(_M_release_root(),__pos,__l,__r);
+        _M_set_root(_M_merge(_M_merge(__l,__z,_Update()),__r,_Update()));
+        return iterator(__z);
+    }
+
+    template <typename _Tp,typename _NodeUpdate,typename _Alloc>
+    template <typename _InputIterator>
+    void sequence_treap<_Tp,_NodeUpdate,_Alloc>::append(_InputIterator __first,_InputIterator __last) {
+        _Base_ptr __last_node = _M_root() == nullptr ? nullptr : this->_M_impl._M_header._M_children[Direction_Right];
+        _Base_ptr __root = _M_release_root();
+
+        try {
+            for (; __first != __last; ++__first) {
+                _Link_type __z = _M_create_node(*__first);
+                _M_spine_append(__root,__last_node,__z,_Update());
+                __last_node = __z;
+            }
+        }
+        catch (...) {
+            _M_maintain_path(__last_node,_Update());
+            _M_set_root(__root);
+            throw;
+        }
+
+        _M_maintain_path(__last_node,_Update());
+        _M_set_root(__root);
+    }
+
+    /*
+     * @brief detach the elements [__pos,__pos + __len) and return them as a subtree
+     */
+    template <typename _Tp,typename _NodeUpdate,typename _Alloc>
+    typename sequence_treap<_Tp,_NodeUpdate,_Alloc>::_Base_ptr
+    sequence_treap<_Tp,_NodeUpdate,_Alloc>::_M_cut(size_type __pos,size_type __len) {
+        _Base_ptr __l,__m,__r;
+        _S_split_at(_M_release_root(),__pos,__l,__m);
+        _S_split_at(__m,__len,__m,__r);
+        _M_set_root(_M_merge(__l,__r,_Update()));
+        return __m;
+    }
+
+    /*
+     * @brief put a subtree cut by _M_cut back at position __pos
+     */
+    template <typename _Tp,typename _NodeUpdate,typename _Alloc>
+    void sequence_treap<_Tp,_NodeUpdate,_Alloc>::_M_paste(size_type __pos,_Base_ptr __m) {
+        if (__m == nullptr)
+            return;
+        _Base_ptr __l,__r;
+        _S_split_at(_M_release_root(),__pos,__l,__r);
+        _M_set_root(_M_merge(_M_merge(__l,__m,_Update()),__r,_Update()));
+    }
+
+    /*
+     * @brief push every pending tag down so that parent-link iteration sees final values and order
+     */
+    template <typename _Tp,typename _NodeUpdate,typename _Alloc>
+    void sequence_treap<_Tp,_NodeUpdate,_Alloc>::_M_flush() {
+        if (!_M_impl._M_lazy_pending)
+            return;
+
+        _Base_ptr __top = _M_root();
+        _M_impl._M_lazy_pending = false;
+        if (__top == nullptr)
+            return;
+
+        _Base_ptr __x = __top;
+        _Base_ptr __prev = __top->_M_parent;
+        while (__x != __top->_M_parent) {
+            _Base_ptr __next;
+            if (__prev == __x->_M_parent) {
+                _Update()._M_push(__x);
+                __next = __x->_M_children[Direction_Left] ? __x->_M_children[Direction_Left]
+                       : (__x->_M_children[Direction_Right] ? __x->_M_children[Direction_Right] : __x->_M_parent);
+            }
+            else if (__prev == __x->_M_children[Direction_Left] && __x->_M_children[Direction_Right] != nullptr)
+                __next = __x->_M_children[Direction_Right];
+            else
+                __next = __x->_M_parent;
+            __prev = __x;
+            __x = __next;
+        }
+    }
+
+    /*
+     * @brief walks source and clone in lockstep through _M_parent,as _Treap::_M_copy does
+     */
+    template <typename _Tp,typename _NodeUpdate,typename _Alloc>
+    typename sequence_treap<_Tp,_NodeUpdate,_Alloc>::_Base_ptr
+    sequence_treap<_Tp,_NodeUpdate,_Alloc>::_M_clone(_Const_Base_ptr __x) {
+        if (__x == nullptr)
+            return nullptr;
+
+        auto __clone_node = [this](_Const_Base_ptr __s) {
+            _Link_type __z = _M_create_node(*static_cast<_Const_Link_type>(__s)->_M_valptr());
+            __z->_M_Priority = __s->_M_Priority;
+            __z->_M_size = __s->_M_size;
+            _Update::_S_copy_state(__z,__s);
+            return __z;
+        };
+
+        _Base_ptr __root = __clone_node(__x);
+        _Const_Base_ptr __s = __x;
+        _Base_ptr __d = __root;
+        try {
+            for (;;) {
+                unsigned int __dir;
+                if (__s->_M_children[Direction_Left] != nullptr && __d->_M_children[Direction_Left] == nullptr)
+                    __dir = Direction_Left;
+                else if (__s->_M_children[Direction_Right] != nullptr && __d->_M_children[Direction_Right] == nullptr)
+                    __dir = Direction_Right;
+                else {
+                    if (__d == __root)
+                        break;
+                    __s = __s->_M_parent;
+                    __d = __d->_M_parent;
+                    continue;
+                }
+                _Base_ptr __c = __clone_node(__s->_M_children[__dir]);
+                __d->_M_children[__dir] = __c;
+                __c->_M_parent = __d;
+                __s = __s->_M_children[__dir];
+                __d = __c;
+            }
+        }
+        catch (...) {
+            _M_erase(__root);
+            throw;
+        }
+        return __root;
+    }
+
+    /*
+     * @brief erase without balance,same flattening walk as _Treap::_M_erase
+     */
+    template <typename _Tp,typename _NodeUpdate,typename _Alloc>
+    void sequence_treap<_Tp,_NodeUpdate,_Alloc>::_M_erase(_Base_ptr __x) {
+        while (__x != nullptr) {
+            _Base_ptr __y = __x->_M_children[Direction_Left];
+            if (__y != nullptr) {
+                __x->_M_children[Direction_Left] = __y->_M_children[Direction_Right];
+                __y->_M_children[Direction_Right] = __x;
+                __x = __y;
+            }
+            else {
+                __y = __x->_M_children[Direction_Right];
+                _M_drop_node(static_cast<_Link_type>(__x));
+                __x = __y;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,103 @@
+// Threaded stress test of concurrent_treap against per-thread std::set models
+// usage: concurrent_treap_test [rounds [steps [threads]]]
+
+#include <atomic>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "concurrent_treap.hpp"
+#include "treap_check.hpp"
+
+namespace TreapTest {
+
+    typedef TreapTree::concurrent_treap<int> concurrent_type;
+    typedef std::set<int> model_type;
+
+    /*
+     * @brief every key hashes to one writer,so each writer's model is exact while the keys of all
+     * writers interleave across the shards
+     */
+    inline void run_writer(concurrent_type& __c,model_type& __m,unsigned int __seed,unsigned int __id,unsigned int __nwriters,unsigned int __steps) {
+        std::mt19937 __rng(__seed);
+        for (unsigned int __step = 0; __step < __steps; ++__step) {
+            const int __k = static_cast<int>((__rng() % 4096) * __nwriters + __id);
+            switch (__rng() % 4) {
+            case 0: case 1:
+                TREAP_CHECK(__c.insert(__k) == __m.insert(__k).second);
+                break;
+            case 2:
+                TREAP_CHECK(__c.erase(__k) == __m.erase(__k));
+                break;
+            default:
+                TREAP_CHECK(__c.contains(__k) == (__m.count(__k) != 0));
+                TREAP_CHECK(__c.count(__k) == __m.count(__k));
+                break;
+            }
+        }
+    }
+
+    /*
+     * @brief lookups and whole-set scans racing the writers,only checks what holds at any moment
+     */
+    inline void run_reader(concurrent_type& __c,const std::atomic<bool>& __done,unsigned int __seed,unsigned int __nwriters) {
+        std::mt19937 __rng(__seed);
+        while (!__done.load(std::memory_order_acquire)) {
+            const int __k = static_cast<int>(__rng() % (4096 * __nwriters));
+            __c.contains(__k);
+            if (__rng() % 256 == 0) {
+                int __prev = -1;
+                __c.for_each([&](int __v) { TREAP_CHECK(__prev < __v); __prev = __v; });
+                TREAP_CHECK(__c.size() <= 4096 * __nwriters);
+            }
+        }
+    }
+
+    inline void check_equal(concurrent_type& __c,const std::vector<model_type>& __models) {
+        model_type __all;
+        for (const model_type& __m : __models)
+            __all.insert(__m.begin(),__m.end());
+        TREAP_CHECK(__c.size() == __all.size());
+        concurrent_type::treap_type __t = __c.snapshot();
+        TREAP_CHECK(__t.__treap_verify() && __t.size() == __all.size());
+        model_type::const_iterator __j = __all.begin();
+        for (int __v : __t)
+            TREAP_CHECK(__v == *__j++);
+    }
+
+    inline void run_round(unsigned int __seed,unsigned int __steps,unsigned int __nwriters) {
+        concurrent_type __c;
+        std::vector<model_type> __models(__nwriters);
+        for (unsigned int __phase = 0; __phase < 4; ++__phase) {
+            std::atomic<bool> __done(false);
+            std::vector<std::thread> __writers;
+            std::thread __reader(run_reader,std::ref(__c),std::cref(__done),__seed * 131 + __phase,__nwriters);
+            for (unsigned int __id = 0; __id < __nwriters; ++__id)
+                __writers.emplace_back(run_writer,std::ref(__c),std::ref(__models[__id]),__seed * 977 + __phase * 31 + __id,__id,__nwriters,__steps);
+            for (std::thread& __w : __writers)
+                __w.join();
+            __done.store(true,std::memory_order_release);
+            __reader.join();
+
+            // quiescent,rebalance() may not overlap any other call
+            check_equal(__c,__models);
+            __c.rebalance(1 + (__seed + __phase) % 9);
+            TREAP_CHECK(__c.shard_count() >= 1);
+            check_equal(__c,__models);
+        }
+        __c.clear();
+        TREAP_CHECK(__c.empty());
+    }
+}
+
+int main(int argc,char** argv) {
+    const unsigned long __rounds = argc > 1 ? std::stoul(argv[1]) : 10;
+    const unsigned long __steps = argc > 2 ? std::stoul(argv[2]) : 5000;
+    const unsigned long __threads = argc > 3 ? std::stoul(argv[3]) : 4;
+    for (unsigned long __r = 0; __r < __rounds; ++__r)
+        TreapTest::run_round(static_cast<unsigned int>(__r),static_cast<unsigned int>(__steps),static_cast<unsigned int>(__threads));
+    std::printf("%lu rounds of %lu steps on %lu threads ok\n",__rounds,__steps,__threads);
+    return 0;
+}
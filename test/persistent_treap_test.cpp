@@ -0,0 +1,153 @@
+// Seeded differential test of persistent_treap versions against saved std::multiset copies
+// usage: persistent_treap_test [rounds [steps]]
+
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "persistent_treap.hpp"
+#include "treap_check.hpp"
+
+namespace TreapTest {
+
+    static long live_nodes = 0;
+
+    /*
+     * @brief std::allocator that keeps live_nodes up to date,whatever it is rebound to
+     */
+    template <typename _Tp>
+    struct counting_allocator : public std::allocator<_Tp>
+    {
+        template <typename _Up>
+        struct rebind { typedef counting_allocator<_Up> other; };
+
+        counting_allocator() {}
+
+        template <typename _Up>
+        counting_allocator(const counting_allocator<_Up>&) {}
+
+        _Tp* allocate(std::size_t __n) {
+            live_nodes += static_cast<long>(__n);
+            return std::allocator<_Tp>::allocate(__n);
+        }
+
+        void deallocate(_Tp* __p,std::size_t __n) {
+            live_nodes -= static_cast<long>(__n);
+            std::allocator<_Tp>::deallocate(__p,__n);
+        }
+    };
+
+    typedef TreapTree::persistent_treap<int,std::less<int>,counting_allocator<int>> persistent_type;
+    typedef std::multiset<int> model_type;
+    typedef std::pair<persistent_type,model_type> version_type;
+
+    inline void check_version(const persistent_type& __t,const model_type& __m,int __k) {
+        TREAP_CHECK(__t.size() == __m.size());
+        TREAP_CHECK(__t.empty() == __m.empty());
+        model_type::const_iterator __j = __m.begin();
+        for (persistent_type::const_iterator __i = __t.begin(); __i != __t.end(); ++__i,++__j)
+            TREAP_CHECK(__j != __m.end() && *__i == *__j);
+        TREAP_CHECK(__j == __m.end());
+        TREAP_CHECK(__t.contains(__k) == (__m.count(__k) != 0));
+        TREAP_CHECK((__t.find(__k) == __t.end()) == (__m.find(__k) == __m.end()));
+        const std::size_t __lo = std::distance(__m.begin(),__m.lower_bound(__k));
+        TREAP_CHECK(__t.lower_bound(__k) == __t.find_by_order(__lo));
+        if (__lo < __m.size())
+            TREAP_CHECK(*__t.find_by_order(__lo) == *__m.lower_bound(__k));
+    }
+
+    /*
+     * @brief every saved version must still hold exactly what its model held when it was taken
+     */
+    inline void check_versions(const std::vector<version_type>& __saved,int __k) {
+        for (const version_type& __v : __saved)
+            check_version(__v.first,__v.second,__k);
+    }
+
+    inline void run_versions(unsigned int __seed,unsigned int __steps) {
+        std::mt19937 __rng(__seed);
+        {
+            persistent_type __t;
+            model_type __m;
+            std::vector<version_type> __saved;
+            for (unsigned int __step = 0; __step < __steps; ++__step) {
+                const int __k = static_cast<int>(__rng() % 128) - 32;
+                switch (__rng() % 10) {
+                case 0: case 1: case 2:
+                    __t.insert(__k);
+                    __m.insert(__k);
+                    break;
+                case 3: case 4:
+                    TREAP_CHECK(__t.erase(__k) == __m.erase(__k));
+                    break;
+                case 5: {
+                    // both halves are new versions sharing nodes with the saved ones
+                    persistent_type __r = __t.split(__k);
+                    model_type __rm(__m.lower_bound(__k),__m.end());
+                    __m.erase(__m.lower_bound(__k),__m.end());
+                    check_version(__t,__m,__k);
+                    check_version(__r,__rm,__k);
+                    __saved.emplace_back(__r,__rm);
+                    __t.merge(__r);
+                    __m.insert(__rm.begin(),__rm.end());
+                    __r.insert(__k);
+                    __rm.insert(__k);
+                    check_version(__r,__rm,__k);
+                    break;
+                }
+                case 6:
+                    __saved.emplace_back(__t.snapshot(),__m);
+                    break;
+                case 7:
+                    if (!__saved.empty()) {
+                        // continue from an older version
+                        const std::size_t __i = __rng() % __saved.size();
+                        if (__rng() % 2)
+                            __t = __saved[__i].first;
+                        else
+                            __t = persistent_type(__saved[__i].first);
+                        __m = __saved[__i].second;
+                    }
+                    break;
+                case 8:
+                    if (!__saved.empty()) {
+                        const std::size_t __i = __rng() % __saved.size();
+                        __saved.erase(__saved.begin() + __i);
+                    }
+                    break;
+                default:
+                    if (__rng() % 16 == 0) {
+                        __t.clear();
+                        __m.clear();
+                    }
+                    break;
+                }
+                check_version(__t,__m,__k);
+                if (__step % 8 == 0)
+                    check_versions(__saved,__k);
+            }
+            check_versions(__saved,0);
+
+            // dropping the versions in any order frees the shared nodes exactly once
+            while (!__saved.empty()) {
+                __saved.erase(__saved.begin() + __rng() % __saved.size());
+                if (!__saved.empty())
+                    check_version(__saved.front().first,__saved.front().second,0);
+            }
+            check_version(__t,__m,0);
+            TREAP_CHECK(live_nodes >= static_cast<long>(__m.size()));
+        }
+        TREAP_CHECK(live_nodes == 0);
+    }
+}
+
+int main(int argc,char** argv) {
+    const unsigned long __rounds = argc > 1 ? std::stoul(argv[1]) : 100;
+    const unsigned long __steps = argc > 2 ? std::stoul(argv[2]) : 2000;
+    for (unsigned long __r = 0; __r < __rounds; ++__r)
+        TreapTest::run_versions(static_cast<unsigned int>(__r),static_cast<unsigned int>(__steps));
+    std::printf("%lu rounds of %lu steps ok\n",__rounds,__steps);
+    return 0;
+}
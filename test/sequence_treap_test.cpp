@@ -0,0 +1,252 @@
+// Seeded differential test of sequence_treap against std::vector
+// usage: sequence_treap_test [rounds [steps]]
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "sequence_treap.hpp"
+#include "treap_check.hpp"
+
+namespace TreapTest {
+
+    typedef TreapTree::sequence_treap<int> sequence_type;
+    typedef std::vector<int> model_type;
+
+    /*
+     * @brief forward and backward iteration,operator[] and size() all agree with __m
+     */
+    template <typename _Sequence>
+    void check_sequence(_Sequence& __s,const model_type& __m) {
+        TREAP_CHECK(__s.size() == __m.size());
+        TREAP_CHECK(__s.empty() == __m.empty());
+        TREAP_CHECK(static_cast<std::size_t>(std::distance(__s.begin(),__s.end())) == __m.size());
+        std::size_t __i = 0;
+        for (typename _Sequence::iterator __it = __s.begin(); __it != __s.end(); ++__it,++__i)
+            TREAP_CHECK(*__it == __m[__i]);
+        for (typename _Sequence::iterator __it = __s.end(); __it != __s.begin();)
+            TREAP_CHECK(*--__it == __m[--__i]);
+        for (std::size_t __j = 0; __j < __m.size(); __j += 1 + __m.size() / 8)
+            TREAP_CHECK(__s[__j] == __m[__j]);
+    }
+
+    /*
+     * @brief what range_query() over [__first,__last) must return,the fold of _Policy::combine
+     */
+    template <typename _Policy>
+    typename _Policy::aggregate_type fold(model_type::const_iterator __first,model_type::const_iterator __last) {
+        typename _Policy::aggregate_type __agg = typename _Policy::aggregate_type();
+        if (__first == __last)
+            return __agg;
+        for (__agg = _Policy::lift(*__first++); __first != __last; ++__first)
+            __agg = _Policy::combine(__agg,_Policy::lift(*__first));
+        return __agg;
+    }
+
+    /*
+     * @brief the const accessors see the same sequence once it has been flushed
+     */
+    template <typename _Sequence>
+    void check_const(_Sequence& __s,const model_type& __m) {
+        __s.flush();
+        const _Sequence& __c = __s;
+        std::size_t __i = 0;
+        for (typename _Sequence::const_iterator __it = __c.begin(); __it != __c.end(); ++__it,++__i)
+            TREAP_CHECK(*__it == __m[__i]);
+        TREAP_CHECK(__i == __m.size());
+        for (std::size_t __j = 0; __j < __m.size(); __j += 1 + __m.size() / 8)
+            TREAP_CHECK(__c[__j] == __m[__j] && __c.at(__j) == __m[__j]);
+    }
+
+    /*
+     * @brief range_query(),range_add() and range_reverse() interleaved with edits,against std::vector
+     */
+    template <typename _Policy>
+    void run_range(unsigned int __seed,unsigned int __steps) {
+        typedef TreapTree::sequence_treap<int,_Policy> _Sequence;
+        std::mt19937 __rng(__seed);
+        _Sequence __s;
+        model_type __m;
+        for (unsigned int __step = 0; __step < __steps; ++__step) {
+            const int __v = static_cast<int>(__rng() % 1000) - 500;
+            const std::size_t __pos = __rng() % (__m.size() + 1);
+            const std::size_t __len = __rng() % 32;
+            const std::size_t __n = std::min(__len,__m.size() - __pos);
+            switch (__rng() % 8) {
+            case 0: case 1:
+                __s.insert_at(__pos,__v);
+                __m.insert(__m.begin() + __pos,__v);
+                break;
+            case 2:
+                if (__pos < __m.size()) {
+                    __s.erase_at(__pos);
+                    __m.erase(__m.begin() + __pos);
+                }
+                break;
+            case 3:
+                TREAP_CHECK(__s.range_query(__pos,__len) == fold<_Policy>(__m.begin() + __pos,__m.begin() + __pos + __n));
+                break;
+            case 4:
+                __s.range_add(__pos,__len,__v % 16);
+                for (std::size_t __i = __pos; __i < __pos + __n; ++__i)
+                    __m[__i] += __v % 16;
+                break;
+            case 5:
+                __s.range_reverse(__pos,__len);
+                std::reverse(__m.begin() + __pos,__m.begin() + __pos + __n);
+                break;
+            case 6: {
+                // copies carry the pending tags along
+                _Sequence __c(__s);
+                check_sequence(__c,__m);
+                break;
+            }
+            default:
+                if (__pos < __m.size())
+                    TREAP_CHECK(__s[__pos] == __m[__pos]);
+                break;
+            }
+            if (__step % 64 == 0)
+                check_const(__s,__m);
+        }
+        TREAP_CHECK(__s.range_query(0,__m.size()) == fold<_Policy>(__m.begin(),__m.end()));
+        check_sequence(__s,__m);
+    }
+
+    /*
+     * @brief range_reverse() with the default policy
+     */
+    inline void run_reverse(unsigned int __seed,unsigned int __steps) {
+        std::mt19937 __rng(__seed);
+        sequence_type __s;
+        model_type __m;
+        for (unsigned int __step = 0; __step < __steps; ++__step) {
+            const std::size_t __pos = __rng() % (__m.size() + 1);
+            const std::size_t __n = std::min<std::size_t>(__rng() % 32,__m.size() - __pos);
+            if (__rng() % 2) {
+                __s.insert_at(__pos,static_cast<int>(__step));
+                __m.insert(__m.begin() + __pos,static_cast<int>(__step));
+            }
+            else {
+                __s.range_reverse(__pos,__n);
+                std::reverse(__m.begin() + __pos,__m.begin() + __pos + __n);
+            }
+            if (__step % 64 == 0)
+                check_const(__s,__m);
+        }
+        sequence_type __c(__s);
+        check_sequence(__c,__m);
+        check_sequence(__s,__m);
+    }
+
+    inline void run_sequence(unsigned int __seed,unsigned int __steps) {
+        std::mt19937 __rng(__seed);
+        sequence_type __s;
+        model_type __m;
+        for (unsigned int __step = 0; __step < __steps; ++__step) {
+            const int __v = static_cast<int>(__rng() % 1000);
+            const std::size_t __pos = __rng() % (__m.size() + 1);
+            const std::size_t __len = __rng() % 8;
+            switch (__rng() % 12) {
+            case 0: case 1:
+                TREAP_CHECK(*__s.insert_at(__pos,__v) == __v);
+                __m.insert(__m.begin() + __pos,__v);
+                break;
+            case 2:
+                __s.push_back(__v);
+                __m.push_back(__v);
+                break;
+            case 3:
+                __s.push_front(__v);
+                __m.insert(__m.begin(),__v);
+                break;
+            case 4:
+                if (__pos < __m.size()) {
+                    __s.erase_at(__pos);
+                    __m.erase(__m.begin() + __pos);
+                }
+                break;
+            case 5: {
+                const std::size_t __n = std::min(__len,__m.size() - __pos);
+                __s.erase_range(__pos,__len);
+                __m.erase(__m.begin() + __pos,__m.begin() + __pos + __n);
+                break;
+            }
+            case 6: {
+                const std::size_t __n = std::min(__len * 4,__m.size() - __pos);
+                sequence_type __r = __s.slice(__pos,__len * 4);
+                check_sequence(__r,model_type(__m.begin() + __pos,__m.begin() + __pos + __n));
+                __m.erase(__m.begin() + __pos,__m.begin() + __pos + __n);
+                // put the slice back at the end
+                __m.insert(__m.end(),__r.begin(),__r.end());
+                __s.concat(__r);
+                TREAP_CHECK(__r.empty());
+                break;
+            }
+            case 7: {
+                const int __vals[] = { __v,__v + 1,__v + 2 };
+                __s.append(__vals,__vals + __len % 4);
+                __m.insert(__m.end(),__vals,__vals + __len % 4);
+                break;
+            }
+            case 8:
+                if (__pos < __m.size()) {
+                    __s.at(__pos) = __v;
+                    __m[__pos] = __v;
+                }
+                else {
+                    bool __threw = false;
+                    try {
+                        __s.at(__pos);
+                    }
+                    catch (const std::out_of_range&) {
+                        __threw = true;
+                    }
+                    TREAP_CHECK(__threw);
+                }
+                break;
+            case 9: {
+                sequence_type __c(__s);
+                check_sequence(__c,__m);
+                sequence_type __d(3,__v);
+                __d = __c;
+                check_sequence(__d,__m);
+                __s = sequence_type(std::move(__d));
+                break;
+            }
+            case 10:
+                if (!__m.empty()) {
+                    TREAP_CHECK(__s.front() == __m.front());
+                    TREAP_CHECK(__s.back() == __m.back());
+                }
+                break;
+            default:
+                if (__rng() % 32 == 0) {
+                    __s.clear();
+                    __m.clear();
+                }
+                break;
+            }
+            if (__step % 16 == 0)
+                check_sequence(__s,__m);
+        }
+        check_sequence(__s,__m);
+    }
+}
+
+int main(int argc,char** argv) {
+    const unsigned long __rounds = argc > 1 ? std::stoul(argv[1]) : 100;
+    const unsigned long __steps = argc > 2 ? std::stoul(argv[2]) : 2000;
+    for (unsigned long __r = 0; __r < __rounds; ++__r)
+    {
+        const unsigned int __seed = static_cast<unsigned int>(__r);
+        TreapTest::run_sequence(__seed,static_cast<unsigned int>(__steps));
+        TreapTest::run_reverse(__seed,static_cast<unsigned int>(__steps));
+        TreapTest::run_range<TreapTree::sequence_sum_update<int>>(__seed,static_cast<unsigned int>(__steps));
+        TreapTest::run_range<TreapTree::sequence_min_update<int>>(__seed,static_cast<unsigned int>(__steps));
+        TreapTest::run_range<TreapTree::sequence_max_update<int>>(__seed,static_cast<unsigned int>(__steps));
+    }
+    std::printf("%lu rounds of %lu steps ok\n",__rounds,__steps);
+    return 0;
+}
@@ -0,0 +1,135 @@
+// Seeded differential test of treap_union/intersection/difference against the std set algorithms
+// usage: treap_algebra_test [rounds]
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include "treap_algebra.hpp"
+#include "treap_check.hpp"
+
+namespace TreapTest {
+
+    typedef TreapTree::_Treap<int> treap_type;
+    typedef std::set<int> model_type;
+
+    enum algebra_op { op_union,op_intersection,op_difference };
+
+    inline void check_equal(const treap_type& __t,const model_type& __m) {
+        TREAP_CHECK(__t.__treap_verify());
+        TREAP_CHECK(__t.size() == __m.size());
+        TREAP_CHECK(std::equal(__m.begin(),__m.end(),__t.begin()));
+    }
+
+    /*
+     * @brief __n distinct keys in [__lo,__lo + __span)
+     */
+    inline model_type make_set(std::mt19937& __rng,std::size_t __n,int __lo,unsigned int __span) {
+        model_type __m;
+        while (__m.size() < __n && __m.size() < __span)
+            __m.insert(__lo + static_cast<int>(__rng() % __span));
+        return __m;
+    }
+
+    inline treap_type make_treap(const model_type& __m) {
+        treap_type __t;
+        for (int __k : __m)
+            __t.insert_unique(__k);
+        return __t;
+    }
+
+    template <typename _Policy>
+    treap_type apply(algebra_op __op,treap_type& __a,treap_type& __b,const _Policy& __policy) {
+        switch (__op) {
+        case op_union:
+            return TreapTree::treap_union(__a,__b,__policy);
+        case op_intersection:
+            return TreapTree::treap_intersection(__a,__b,__policy);
+        default:
+            return TreapTree::treap_difference(__a,__b,__policy);
+        }
+    }
+
+    inline model_type expected(algebra_op __op,const model_type& __a,const model_type& __b) {
+        model_type __r;
+        std::insert_iterator<model_type> __out(__r,__r.end());
+        switch (__op) {
+        case op_union:
+            std::set_union(__a.begin(),__a.end(),__b.begin(),__b.end(),__out);
+            break;
+        case op_intersection:
+            std::set_intersection(__a.begin(),__a.end(),__b.begin(),__b.end(),__out);
+            break;
+        default:
+            std::set_difference(__a.begin(),__a.end(),__b.begin(),__b.end(),__out);
+            break;
+        }
+        return __r;
+    }
+
+    template <typename _Policy>
+    void check_op(algebra_op __op,const model_type& __a,const model_type& __b,const _Policy& __policy) {
+        treap_type __ta = make_treap(__a);
+        treap_type __tb = make_treap(__b);
+        treap_type __r = apply(__op,__ta,__tb,__policy);
+        check_equal(__r,expected(__op,__a,__b));
+        TREAP_CHECK(__ta.empty() && __tb.empty());
+    }
+
+    /*
+     * @brief the same Treap passed as both operands
+     */
+    template <typename _Policy>
+    void check_self(algebra_op __op,const model_type& __a,const _Policy& __policy) {
+        treap_type __t = make_treap(__a);
+        treap_type __r = apply(__op,__t,__t,__policy);
+        check_equal(__r,__op == op_difference ? model_type() : __a);
+        TREAP_CHECK(__t.empty());
+    }
+
+    /*
+     * @brief self-aliased,disjoint,overlapping,nested and empty operands,large enough for
+     * treap_parallel_policy to fork
+     */
+    template <typename _Policy>
+    void run_algebra(unsigned int __seed,const _Policy& __policy) {
+        std::mt19937 __rng(__seed);
+        const std::size_t __n = 1000 + __rng() % 40000;
+        const std::size_t __m = 1 + __rng() % 40000;
+        const model_type __a = make_set(__rng,__n,0,4 * __n);
+        const model_type __overlap = make_set(__rng,__m,static_cast<int>(__n),4 * __n);
+        const model_type __disjoint = make_set(__rng,__m,static_cast<int>(8 * __n),4 * __n);
+        model_type __nested;
+        for (int __k : __a)
+            if (__rng() % 3 == 0)
+                __nested.insert(__k);
+
+        for (algebra_op __op : { op_union,op_intersection,op_difference }) {
+            check_self(__op,__a,__policy);
+            check_self(__op,model_type(),__policy);
+            check_op(__op,__a,__overlap,__policy);
+            check_op(__op,__overlap,__a,__policy);
+            check_op(__op,__a,__disjoint,__policy);
+            check_op(__op,__disjoint,__a,__policy);
+            check_op(__op,__a,__nested,__policy);
+            check_op(__op,__nested,__a,__policy);
+            check_op(__op,__a,model_type(),__policy);
+            check_op(__op,model_type(),__a,__policy);
+            check_op(__op,model_type(),model_type(),__policy);
+        }
+    }
+}
+
+int main(int argc,char** argv) {
+    const unsigned long __rounds = argc > 1 ? std::stoul(argv[1]) : 3;
+    for (unsigned long __r = 0; __r < __rounds; ++__r) {
+        const unsigned int __seed = static_cast<unsigned int>(__r);
+        TreapTest::run_algebra(__seed,TreapTree::treap_seq);
+        TreapTest::run_algebra(__seed,TreapTree::treap_par);
+        // forks even on a single core
+        TreapTest::run_algebra(__seed,TreapTree::treap_parallel_policy(8));
+    }
+    std::printf("%lu rounds ok\n",__rounds);
+    return 0;
+}
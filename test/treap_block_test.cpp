@@ -0,0 +1,128 @@
+// Seeded differential test of _Block_treap against std::multiset
+// usage: treap_block_test [rounds [steps]]
+
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "treap_block.hpp"
+#include "treap_check.hpp"
+
+namespace TreapTest {
+
+    template <typename _Block_type,typename _Model>
+    void check_equal(const _Block_type& __t,const _Model& __m) {
+        TREAP_CHECK(__t.__block_treap_verify());
+        TREAP_CHECK(__t.size() == __m.size() && __t.empty() == __m.empty());
+        TREAP_CHECK(__t.block_count() <= __t.size());
+        typename _Model::const_iterator __j = __m.begin();
+        for (typename _Block_type::const_iterator __i = __t.begin(); __i != __t.end(); ++__i,++__j)
+            TREAP_CHECK(__j != __m.end() && *__i == *__j);
+        TREAP_CHECK(__j == __m.end());
+    }
+
+    template <typename _Block_type,typename _Model>
+    void check_key(const _Block_type& __t,const _Model& __m,const typename _Model::key_type& __k) {
+        TREAP_CHECK(__t.count(__k) == __m.count(__k));
+        TREAP_CHECK(__t.contains(__k) == (__m.count(__k) != 0));
+        TREAP_CHECK((__t.find(__k) == __t.end()) == (__m.find(__k) == __m.end()));
+        TREAP_CHECK(__t.order_of_key(__k) == static_cast<std::size_t>(std::distance(__m.begin(),__m.lower_bound(__k))));
+        typename _Block_type::const_iterator __lb = __t.lower_bound(__k);
+        if (__m.lower_bound(__k) == __m.end())
+            TREAP_CHECK(__lb == __t.end());
+        else
+            TREAP_CHECK(__lb != __t.end() && *__lb == *__m.lower_bound(__k));
+    }
+
+    /*
+     * @brief same operation mix as treap_fuzz_driver.hpp,with a key range small enough that blocks
+     * fill up,split on insertion and merge on erasure
+     */
+    template <typename _Block_type,typename _Compare>
+    void run_block(unsigned int __seed,unsigned int __steps) {
+        typedef typename _Block_type::key_type _Key;
+        typedef std::multiset<_Key,_Compare> _Model;
+
+        std::mt19937 __rng(__seed);
+        _Block_type __t;
+        _Model __m;
+        for (unsigned int __step = 0; __step < __steps; ++__step) {
+            const _Key __k = static_cast<_Key>(static_cast<int>(__rng() % 256) - 64);
+            switch (__rng() % 12) {
+            case 0: case 1: case 2: case 3:
+                __t.insert(__k);
+                __m.insert(__k);
+                break;
+            case 4:
+                __t.emplace(__k);
+                __m.insert(__k);
+                break;
+            case 5: case 6:
+                TREAP_CHECK(__t.erase(__k) == __m.erase(__k));
+                break;
+            case 7:
+                check_key(__t,__m,__k);
+                break;
+            case 8: {
+                // the block holding __k is cut in two,merge() takes the concatenation path
+                _Block_type __r = __t.split(__k);
+                TREAP_CHECK(__t.__block_treap_verify() && __r.__block_treap_verify());
+                check_equal(__r,_Model(__m.lower_bound(__k),__m.end()));
+                __t.merge(__r);
+                TREAP_CHECK(__r.empty());
+                break;
+            }
+            case 9: {
+                // overlapping keys,merge() inserts them one by one
+                std::vector<_Key> __keys;
+                for (unsigned int __i = __rng() % 40; __i > 0; --__i)
+                    __keys.push_back(static_cast<_Key>(static_cast<int>(__rng() % 256) - 64));
+                _Block_type __x(__keys.begin(),__keys.end());
+                TREAP_CHECK(__x.__block_treap_verify() && __x.size() == __keys.size());
+                __t.merge(__x);
+                __m.insert(__keys.begin(),__keys.end());
+                TREAP_CHECK(__x.empty());
+                break;
+            }
+            case 10: {
+                _Block_type __c(__t);
+                check_equal(__c,__m);
+                _Block_type __d(__m.begin(),__m.end());
+                check_equal(__d,__m);
+                __d.swap(__c);
+                __t = std::move(__d);
+                break;
+            }
+            default:
+                if (__rng() % 16 == 0) {
+                    __t.clear();
+                    __m.clear();
+                }
+                break;
+            }
+            TREAP_CHECK(__t.__block_treap_verify());
+            TREAP_CHECK(__t.size() == __m.size());
+            if (__step % 16 == 0)
+                check_equal(__t,__m);
+        }
+        check_equal(__t,__m);
+    }
+}
+
+int main(int argc,char** argv) {
+    const unsigned long __rounds = argc > 1 ? std::stoul(argv[1]) : 50;
+    const unsigned long __steps = argc > 2 ? std::stoul(argv[2]) : 3000;
+    for (unsigned long __r = 0; __r < __rounds; ++__r) {
+        const unsigned int __seed = static_cast<unsigned int>(__r);
+        // the vector search,the scalar one,and the smallest blocks with 64-bit lanes
+        TreapTest::run_block<TreapTree::_Block_treap<int>,std::less<int>>(__seed,static_cast<unsigned int>(__steps));
+        TreapTest::run_block<TreapTree::_Block_treap<int,std::greater<int>>,std::greater<int>>(__seed,static_cast<unsigned int>(__steps));
+        TreapTest::run_block<TreapTree::_Block_treap<long,std::less<long>,std::allocator<long>,8>,std::less<long>>(__seed,static_cast<unsigned int>(__steps));
+    }
+    std::printf("%lu rounds of %lu steps ok\n",__rounds,__steps);
+    return 0;
+}
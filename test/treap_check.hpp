@@ -0,0 +1,19 @@
+// Assertion macro of the test drivers -*- C++ -*-
+// @file treap_check.hpp
+
+#ifndef _TREAP_CHECK_H_
+#define _TREAP_CHECK_H_ 1
+
+#include <cstdio>
+#include <cstdlib>
+
+// unlike assert() it stays on in release builds,where the tests run
+#define TREAP_CHECK(__cond) \
+    do { \
+        if (!(__cond)) { \
+            std::fprintf(stderr,"%s:%d: check failed: %s\n",__FILE__,__LINE__,#__cond); \
+            std::abort(); \
+        } \
+    } while (0)
+
+#endif
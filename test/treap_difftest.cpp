@@ -0,0 +1,32 @@
+// Seeded differential test of _Treap against std::multiset
+// usage: treap_difftest [streams [bytes]] or treap_difftest file... to replay fuzzer inputs
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "treap_fuzz_driver.hpp"
+
+int main(int argc,char** argv) {
+    if (argc > 1 && std::ifstream(argv[1]).good()) {
+        for (int __i = 1; __i < argc; ++__i) {
+            std::ifstream __in(argv[__i],std::ios::binary);
+            std::vector<std::uint8_t> __data((std::istreambuf_iterator<char>(__in)),std::istreambuf_iterator<char>());
+            TreapTest::run(__data.data(),__data.size());
+        }
+        return 0;
+    }
+
+    const unsigned long __streams = argc > 1 ? std::stoul(argv[1]) : 200;
+    const unsigned long __bytes = argc > 2 ? std::stoul(argv[2]) : 4000;
+    std::vector<std::uint8_t> __data(__bytes);
+    for (unsigned long __s = 0; __s < __streams; ++__s) {
+        std::mt19937 __rng(static_cast<unsigned int>(__s));
+        for (std::uint8_t& __b : __data)
+            __b = static_cast<std::uint8_t>(__rng());
+        TreapTest::run(__data.data(),__data.size());
+    }
+    std::printf("%lu streams of %lu bytes ok\n",__streams,__bytes);
+    return 0;
+}
@@ -0,0 +1,8 @@
+// libFuzzer entry point,see treap_fuzz_driver.hpp
+
+#include "treap_fuzz_driver.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* __data,std::size_t __size) {
+    TreapTest::run(__data,__size);
+    return 0;
+}
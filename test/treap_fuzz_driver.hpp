@@ -0,0 +1,157 @@
+// Differential driver shared by treap_difftest and treap_fuzz -*- C++ -*-
+// @file treap_fuzz_driver.hpp
+
+#ifndef _TREAP_FUZZ_DRIVER_H_
+#define _TREAP_FUZZ_DRIVER_H_ 1
+
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include "treap.hpp"
+#include "treap_check.hpp"
+
+namespace TreapTest {
+
+    typedef TreapTree::_Treap<int> treap_type;
+    typedef std::multiset<int> model_type;
+
+    /*
+     * @brief byte reader,yields zeros once the input runs out
+     */
+    struct byte_stream
+    {
+        const std::uint8_t* _M_data;
+        std::size_t _M_left;
+
+        byte_stream(const std::uint8_t* __data,std::size_t __size) : _M_data(__data),_M_left(__size) {}
+
+        bool empty() const { return _M_left == 0; }
+
+        std::uint8_t next() {
+            if (_M_left == 0)
+                return 0;
+            --_M_left;
+            return *_M_data++;
+        }
+
+        // a small key range,so duplicates and hits are common
+        int key() { return static_cast<int>(next() % 64) - 16; }
+    };
+
+    inline void check_equal(const treap_type& __t,const model_type& __m) {
+        TREAP_CHECK(__t.__treap_verify());
+        TREAP_CHECK(__t.size() == __m.size());
+        model_type::const_iterator __j = __m.begin();
+        for (treap_type::const_iterator __i = __t.begin(); __i != __t.end(); ++__i,++__j)
+            TREAP_CHECK(*__i == *__j);
+    }
+
+    /*
+     * @brief replay __data as a sequence of operations on a _Treap and a std::multiset
+     *
+     * __treap_verify() (sizes,heap order,parent links,leftmost/rightmost) runs after every
+     * operation,the full contents are compared every 16 operations and at the end.
+     */
+    inline void run(const std::uint8_t* __data,std::size_t __size) {
+        byte_stream __in(__data,__size);
+        treap_type __t;
+        model_type __m;
+        for (unsigned int __step = 0; !__in.empty(); ++__step) {
+            const unsigned int __op = __in.next() % 16;
+            const int __k = __in.key();
+            switch (__op) {
+            case 0: case 1: case 2: case 3:
+                __t.emplace(__k);
+                __m.insert(__k);
+                break;
+            case 4: {
+                treap_type::iterator __hint = __t.find_by_order(__in.next() % (__t.size() + 1));
+                __t.emplace_hint(__hint,__k);
+                __m.insert(__k);
+                break;
+            }
+            case 5: case 6:
+                TREAP_CHECK(__t.erase(__k) == __m.erase(__k));
+                break;
+            case 7:
+                if (!__m.empty()) {
+                    const std::size_t __i = __in.next() % __m.size();
+                    __t.erase(__t.find_by_order(__i));
+                    __m.erase(std::next(__m.begin(),__i));
+                }
+                break;
+            case 8: {
+                TREAP_CHECK(__t.count(__k) == __m.count(__k));
+                TREAP_CHECK((__t.find(__k) == __t.end()) == (__m.find(__k) == __m.end()));
+                const std::size_t __lo = std::distance(__m.begin(),__m.lower_bound(__k));
+                const std::size_t __hi = std::distance(__m.begin(),__m.upper_bound(__k));
+                TREAP_CHECK(__t.order_of_key(__k) == __lo);
+                TREAP_CHECK(__t.lower_bound(__k) == __t.find_by_order(__lo));
+                TREAP_CHECK(__t.upper_bound(__k) == __t.find_by_order(__hi));
+                break;
+            }
+            case 9: {
+                treap_type __r = __t.split(__k);
+                TREAP_CHECK(__t.__treap_verify() && __r.__treap_verify());
+                TREAP_CHECK(__r.size() == static_cast<std::size_t>(std::distance(__m.lower_bound(__k),__m.end())));
+                TREAP_CHECK(__r.empty() || *__r.begin() >= __k);
+                __t.merge(__r);
+                TREAP_CHECK(__r.empty());
+                break;
+            }
+            case 10: {
+                const std::size_t __n = __in.next() % (__t.size() + 1);
+                treap_type __r = __t.split_at(__n);
+                TREAP_CHECK(__t.size() == __n && __r.__treap_verify());
+                __r.merge(__t);
+                __t.merge(__r);
+                break;
+            }
+            case 11: {
+                const int __hi = __k + static_cast<int>(__in.next() % 8);
+                const std::size_t __n = std::distance(__m.lower_bound(__k),__m.lower_bound(__hi));
+                TREAP_CHECK(__t.erase_range(__k,__hi) == __n);
+                __m.erase(__m.lower_bound(__k),__m.lower_bound(__hi));
+                break;
+            }
+            case 12: {
+                treap_type __c(__t);
+                check_equal(__c,__m);
+                treap_type __d;
+                __d.emplace(__k);
+                __d = __c;
+                check_equal(__d,__m);
+                __t = std::move(__d);
+                break;
+            }
+            case 13:
+                __t.compact();
+                break;
+            case 14: {
+                treap_type::node_type __nh = __t.extract(__k);
+                if (!__nh.empty()) {
+                    __m.erase(__m.find(__k));
+                    if (__in.next() & 1) {
+                        __t.insert(std::move(__nh));
+                        __m.insert(__k);
+                    }
+                }
+                break;
+            }
+            default:
+                if (__in.next() % 8 == 0) {
+                    __t.clear();
+                    __m.clear();
+                }
+                break;
+            }
+            TREAP_CHECK(__t.__treap_verify());
+            TREAP_CHECK(__t.size() == __m.size());
+            if (__step % 16 == 0)
+                check_equal(__t,__m);
+        }
+        check_equal(__t,__m);
+    }
+}
+
+#endif
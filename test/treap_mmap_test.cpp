@@ -0,0 +1,188 @@
+// treap_save() and mapped_treap: round trips against the saved _Treap,corrupt files are rejected
+// usage: treap_mmap_test [rounds]
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include "treap_mmap.hpp"
+#include "treap_check.hpp"
+
+namespace TreapTest {
+
+    typedef TreapTree::_Treap<int> treap_type;
+    typedef TreapTree::mapped_treap<int> mapped_type;
+    typedef TreapTree::_Treap_file_header header_type;
+    typedef TreapTree::_Treap_file_node<int> file_node_type;
+
+    /*
+     * @brief a fresh path under the temporary directory,removed on destruction
+     */
+    struct temp_file
+    {
+        std::string _M_path;
+
+        temp_file() {
+            char __name[] = "/tmp/treap_mmap_test.XXXXXX";
+            int __fd = ::mkstemp(__name);
+            TREAP_CHECK(__fd >= 0);
+            ::close(__fd);
+            _M_path = __name;
+        }
+
+        ~temp_file() { std::remove(_M_path.c_str()); }
+    };
+
+    inline void check_mapped(const mapped_type& __m,const treap_type& __t) {
+        TREAP_CHECK(__m.size() == __t.size() && __m.empty() == __t.empty());
+        treap_type::const_iterator __j = __t.begin();
+        for (mapped_type::const_iterator __i = __m.begin(); __i != __m.end(); ++__i,++__j)
+            TREAP_CHECK(*__i == *__j);
+        TREAP_CHECK(__j == __t.end());
+        for (mapped_type::const_iterator __i = __m.end(); __i != __m.begin();)
+            TREAP_CHECK(*--__i == *--__j);
+
+        for (int __k = -8; __k < 1040; __k += 3) {
+            TREAP_CHECK(__m.count(__k) == __t.count(__k));
+            TREAP_CHECK(__m.contains(__k) == __t.contains(__k));
+            TREAP_CHECK(__m.order_of_key(__k) == __t.order_of_key(__k));
+            const std::size_t __lo = __t.order_of_key(__k);
+            TREAP_CHECK(__m.lower_bound(__k) == __m.find_by_order(__lo));
+            TREAP_CHECK(__m.upper_bound(__k) == __m.find_by_order(__lo + __t.count(__k)));
+            TREAP_CHECK((__m.find(__k) == __m.end()) == (__t.find(__k) == __t.end()));
+        }
+
+        treap_type __back = __m.to_treap();
+        TREAP_CHECK(__back.__treap_verify() && __back.size() == __t.size());
+        TREAP_CHECK(std::equal(__t.begin(),__t.end(),__back.begin()));
+    }
+
+    inline void run_round_trip(unsigned int __seed) {
+        std::mt19937 __rng(__seed);
+        treap_type __t;
+        const unsigned int __n = __seed < 2 ? __seed : __rng() % 5000;
+        for (unsigned int __i = 0; __i < __n; ++__i)
+            __t.emplace(static_cast<int>(__rng() % 1024));
+
+        temp_file __f;
+        TreapTree::treap_save(__t,__f._M_path);
+        mapped_type __m(__f._M_path);
+        check_mapped(__m,__t);
+
+        // saving again over the same path and reopening gives the same tree
+        TreapTree::treap_save(__m.to_treap(),__f._M_path);
+        mapped_type __again(__f._M_path);
+        check_mapped(__again,__t);
+
+        mapped_type __moved(std::move(__again));
+        check_mapped(__moved,__t);
+        TREAP_CHECK(__again.empty() && __again.begin() == __again.end());
+    }
+
+    inline void patch(const std::string& __path,std::size_t __offset,std::uint32_t __v) {
+        std::fstream __io(__path.c_str(),std::ios::in | std::ios::out | std::ios::binary);
+        __io.seekp(static_cast<std::streamoff>(__offset));
+        __io.write(reinterpret_cast<const char*>(&__v),sizeof(__v));
+        TREAP_CHECK(__io.good());
+    }
+
+    inline std::uint32_t peek(const std::string& __path,std::size_t __offset) {
+        std::uint32_t __v = 0;
+        std::ifstream __in(__path.c_str(),std::ios::binary);
+        __in.seekg(static_cast<std::streamoff>(__offset));
+        __in.read(reinterpret_cast<char*>(&__v),sizeof(__v));
+        TREAP_CHECK(__in.good());
+        return __v;
+    }
+
+    inline std::size_t node_offset(std::uint32_t __i) { return header_type::_S_nodes_offset + __i * sizeof(file_node_type); }
+
+    /*
+     * @return the message of the std::runtime_error thrown while opening __path,"" if none was
+     */
+    inline std::string open_error(const std::string& __path) {
+        try {
+            mapped_type __m(__path);
+        }
+        catch (const std::system_error&) {
+            return "system_error";
+        }
+        catch (const std::runtime_error& __e) {
+            return __e.what();
+        }
+        return "";
+    }
+
+    /*
+     * @brief each patch breaks one invariant _M_valid() checks,or the header checks before it
+     */
+    inline void run_corrupt() {
+        treap_type __t(std::less<int>(),std::allocator<int>(),TreapTree::treap_random_priority(1));
+        for (int __k = 0; __k < 200; ++__k)
+            __t.emplace(__k);
+        temp_file __f;
+        const std::string __corrupt = "mapped_treap: corrupt treap file";
+        const std::string __foreign = "mapped_treap: not a treap file for this element type";
+
+        // preorder puts the root at 0,its left child (if any) at 1
+        TreapTree::treap_save(__t,__f._M_path);
+        const std::uint32_t __left = peek(__f._M_path,node_offset(0) + offsetof(file_node_type,_M_children));
+        const std::uint32_t __leftmost = peek(__f._M_path,offsetof(header_type,_M_leftmost));
+        const std::uint32_t __rightmost = peek(__f._M_path,offsetof(header_type,_M_rightmost));
+        TREAP_CHECK(__left == 1 && __leftmost != __rightmost);
+
+        struct { std::size_t _M_offset; std::uint32_t _M_value; const std::string* _M_error; } const __cases[] = {
+            // a child index past the end
+            { node_offset(0) + offsetof(file_node_type,_M_children),200,&__corrupt },
+            // a child that does not point back at its parent
+            { node_offset(1) + offsetof(file_node_type,_M_parent),5,&__corrupt },
+            // a cycle through the root
+            { node_offset(1) + offsetof(file_node_type,_M_children),0,&__corrupt },
+            // a subtree size that does not add up
+            { node_offset(1) + offsetof(file_node_type,_M_size),1000,&__corrupt },
+            // the root with a parent
+            { node_offset(0) + offsetof(file_node_type,_M_parent),1,&__corrupt },
+            // leftmost and rightmost pointing at the wrong nodes,a root that is not the root
+            { offsetof(header_type,_M_leftmost),__rightmost,&__corrupt },
+            { offsetof(header_type,_M_rightmost),__leftmost,&__corrupt },
+            { offsetof(header_type,_M_root),1,&__corrupt },
+            // more nodes than the file holds,a different element size,a different magic
+            { offsetof(header_type,_M_count),201,&__foreign },
+            { offsetof(header_type,_M_value_size),8,&__foreign },
+            { 0,0x41414141u,&__foreign },
+        };
+        for (const auto& __c : __cases) {
+            TreapTree::treap_save(__t,__f._M_path);
+            TREAP_CHECK(open_error(__f._M_path).empty());
+            patch(__f._M_path,__c._M_offset,__c._M_value);
+            TREAP_CHECK(open_error(__f._M_path) == *__c._M_error);
+        }
+
+        // an empty tree must not claim a root
+        TreapTree::treap_save(treap_type(),__f._M_path);
+        TREAP_CHECK(open_error(__f._M_path).empty());
+        patch(__f._M_path,offsetof(header_type,_M_root),0);
+        TREAP_CHECK(open_error(__f._M_path) == __corrupt);
+
+        // shorter than the header,and missing altogether
+        { std::ofstream __out(__f._M_path.c_str(),std::ios::binary | std::ios::trunc); __out << "TREAP"; }
+        TREAP_CHECK(open_error(__f._M_path) == "mapped_treap: not a treap file");
+        std::remove(__f._M_path.c_str());
+        TREAP_CHECK(open_error(__f._M_path) == "system_error");
+    }
+}
+
+int main(int argc,char** argv) {
+    const unsigned long __rounds = argc > 1 ? std::stoul(argv[1]) : 50;
+    for (unsigned long __r = 0; __r < __rounds; ++__r)
+        TreapTest::run_round_trip(static_cast<unsigned int>(__r));
+    TreapTest::run_corrupt();
+    std::printf("%lu rounds ok\n",__rounds);
+    return 0;
+}
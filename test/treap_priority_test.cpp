@@ -0,0 +1,83 @@
+// Reproducibility of the _PriorityGen policies: seeded Treaps and their copies take the same shape
+// usage: treap_priority_test [rounds]
+
+#include <random>
+#include <string>
+#include <vector>
+#include "treap.hpp"
+#include "treap_check.hpp"
+
+namespace TreapTest {
+
+    typedef TreapTree::_Treap<int> treap_type;
+    typedef TreapTree::_Treap<int,std::less<int>,std::allocator<int>,int,std::_Identity<int>,TreapTree::treap_hash_priority<int>> hash_treap_type;
+
+    /*
+     * @brief same elements with the same priorities,hence the same shape
+     */
+    template <typename _Treap_type>
+    bool same_shape(const _Treap_type& __a,const _Treap_type& __b) {
+        if (__a.size() != __b.size())
+            return false;
+        for (typename _Treap_type::const_iterator __i = __a.begin(),__j = __b.begin(); __i != __a.end(); ++__i,++__j)
+            if (*__i != *__j || __a.priority(__i) != __b.priority(__j))
+                return false;
+        return true;
+    }
+
+    template <typename _Treap_type>
+    void insert_keys(_Treap_type& __t,unsigned int __seed,unsigned int __n) {
+        std::mt19937 __rng(__seed);
+        for (unsigned int __i = 0; __i < __n; ++__i)
+            __t.emplace(static_cast<int>(__rng() % 4096));
+    }
+
+    inline void run_priority(unsigned int __seed) {
+        const TreapTree::treap_random_priority __gen(__seed);
+
+        // the same seed and the same operations
+        treap_type __a(std::less<int>(),std::allocator<int>(),__gen);
+        treap_type __b(std::less<int>(),std::allocator<int>(),__gen);
+        insert_keys(__a,__seed,1000);
+        insert_keys(__b,__seed,1000);
+        TREAP_CHECK(same_shape(__a,__b));
+
+        // copies of one source,each grown the same way afterwards
+        treap_type __c(__a),__d(__a);
+        treap_type __e,__f;
+        __e = __b;
+        __f = __b;
+        TREAP_CHECK(same_shape(__c,__a) && same_shape(__e,__a));
+        insert_keys(__c,__seed + 1,1000);
+        insert_keys(__d,__seed + 1,1000);
+        insert_keys(__e,__seed + 1,1000);
+        insert_keys(__f,__seed + 1,1000);
+        TREAP_CHECK(__c.__treap_verify() && __e.__treap_verify());
+        TREAP_CHECK(same_shape(__c,__d) && same_shape(__e,__f) && same_shape(__c,__e));
+
+        // split() results fork the non-const policy,still reproducible
+        treap_type __ra = __c.split(2048),__rb = __d.split(2048);
+        insert_keys(__ra,__seed + 2,500);
+        insert_keys(__rb,__seed + 2,500);
+        TREAP_CHECK(same_shape(__ra,__rb));
+
+        // key-derived priorities ignore the order of insertion
+        hash_treap_type __h1,__h2;
+        std::vector<int> __keys;
+        for (int __k : __a)
+            __keys.push_back(__k);
+        for (int __k : __keys)
+            __h1.emplace(__k);
+        for (std::size_t __i = __keys.size(); __i-- > 0; )
+            __h2.emplace(__keys[__i]);
+        TREAP_CHECK(same_shape(__h1,__h2));
+    }
+}
+
+int main(int argc,char** argv) {
+    const unsigned long __rounds = argc > 1 ? std::stoul(argv[1]) : 50;
+    for (unsigned long __r = 0; __r < __rounds; ++__r)
+        TreapTest::run_priority(static_cast<unsigned int>(__r));
+    std::printf("%lu rounds ok\n",__rounds);
+    return 0;
+}
@@ -0,0 +1,54 @@
+// _Treap_Stats allocation counters balance once every Treap is gone,whatever frees the nodes
+// usage: treap_stats_test [rounds]
+
+#include <random>
+#include <string>
+#include "treap.hpp"
+#include "treap_pool.hpp"
+#include "treap_check.hpp"
+
+#if !defined _Treap_Stats
+#error "treap_stats_test must be compiled with -D_Treap_Stats"
+#endif
+
+namespace TreapTest {
+
+    /*
+     * @brief inserts,erasures and a compact() in between,then the destructor frees what is left
+     */
+    template <typename _Treap_type>
+    void run_stats(unsigned int __seed) {
+        std::mt19937 __rng(__seed);
+        TreapTree::treap_reset_thread_stats();
+        {
+            _Treap_type __t;
+            for (unsigned int __i = 0; __i < 2000; ++__i)
+                __t.emplace(static_cast<int>(__rng() % 1024));
+            for (unsigned int __i = 0; __i < 500; ++__i)
+                __t.erase(static_cast<int>(__rng() % 1024));
+            if (__seed % 2 == 0)
+                __t.compact();
+            for (unsigned int __i = 0; __i < 500; ++__i)
+                __t.emplace(static_cast<int>(__rng() % 1024));
+            for (unsigned int __i = 0; __i < 200; ++__i)
+                __t.erase(static_cast<int>(__rng() % 1024));
+            if (__seed % 3 == 0)
+                __t.clear();
+        }
+        const TreapTree::treap_stats __s = TreapTree::treap_thread_stats();
+        TREAP_CHECK(__s._M_allocations > 0);
+        TREAP_CHECK(__s._M_allocations == __s._M_deallocations);
+    }
+}
+
+int main(int argc,char** argv) {
+    typedef TreapTree::_Treap<int> treap_type;
+    typedef TreapTree::_Treap<int,std::less<int>,TreapTree::_Treap_pool_allocator<int>> pool_treap_type;
+    const unsigned long __rounds = argc > 1 ? std::stoul(argv[1]) : 20;
+    for (unsigned long __r = 0; __r < __rounds; ++__r) {
+        TreapTest::run_stats<treap_type>(static_cast<unsigned int>(__r));
+        TreapTest::run_stats<pool_treap_type>(static_cast<unsigned int>(__r));
+    }
+    std::printf("%lu rounds ok\n",__rounds);
+    return 0;
+}
@@ -4,12 +4,23 @@
 #ifndef _TREAP_H_
 #define _TREAP_H_ 1
 
+#include <algorithm>
+#include <array>
 #include <limits>
 #include <random>
 #include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <type_traits>
 #include <bits/stl_function.h>
 #include <bits/cpp_type_traits.h>
 #include <ext/alloc_traits.h>
+#include <ext/aligned_buffer.h>
 #include <bits/allocator.h>
 #include <bits/stl_algobase.h>
 
@@ -18,21 +29,118 @@ namespace TreapTree {
     static const unsigned int MIN_PRIORITY = std::numeric_limits<unsigned int>::min();
     static const unsigned int MAX_PRIORITY = std::numeric_limits<unsigned int>::max();
 
-    unsigned int generaterand() {
-        static std::mt19937 engine{ std::random_device{} ()};
-        static std::uniform_int_distribution<unsigned int>distribution(MIN_PRIORITY,MAX_PRIORITY - 1);
-        return distribution(engine);
+    /*
+     * @brief wyrand,a 64-bit generator costing one add and one 64x64->128 multiply per draw
+     */
+    struct _Treap_wyrand
+    {
+        std::uint64_t _M_state;
+
+        explicit _Treap_wyrand(std::uint64_t __seed) : _M_state(__seed) {}
+
+        std::uint64_t operator()() {
+            _M_state += 0xa0761d6478bd642fULL;
+            __uint128_t __m = static_cast<__uint128_t>(_M_state) * (_M_state ^ 0xe7037ed1a0b428dbULL);
+            return static_cast<std::uint64_t>(__m >> 64) ^ static_cast<std::uint64_t>(__m);
+        }
+    };
+
+    /*
+     * @brief splitmix64 finalizer,spreads every input bit over the whole word
+     */
+    inline std::uint64_t _M_mix64(std::uint64_t __x) {
+        __x = (__x ^ (__x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        __x = (__x ^ (__x >> 27)) * 0x94d049bb133111ebULL;
+        return __x ^ (__x >> 31);
+    }
+
+    /*
+     * @brief high half of __x as a node priority,MAX_PRIORITY is kept for the header
+     */
+    inline unsigned int _M_priority_of(std::uint64_t __x) {
+        unsigned int __p = static_cast<unsigned int>(__x >> 32);
+        return __p == MAX_PRIORITY ? MAX_PRIORITY - 1 : __p;
+    }
+
+    /*
+     * @brief draws a node priority,every thread owns its engine so Treaps on different threads never share state
+     */
+    inline unsigned int generaterand() {
+        thread_local _Treap_wyrand __engine(std::random_device{}() * 0x9e3779b97f4a7c15ULL);
+        return _M_priority_of(__engine());
     }
 
+    /*
+     * @brief priority policies for the _PriorityGen parameter of _Treap
+     *
+     * A policy is called as gen(key) once per new node.Every Treap built from another one (copies,
+     * moves,split() results,the chunks of assign_sorted_parallel()) gets the policy returned by
+     * gen.fork() if it has one,else a copy.
+     *
+     * treap_random_priority   wyrand owned by the Treap;default-constructed ones take their seed from
+     *                         a per-thread sequence,treap_random_priority(seed) is reproducible and so
+     *                         are its forks:fork() seeds the new engine from the next output of this
+     *                         one,fork() const from a hash of its state
+     * treap_hash_priority     priority derived from the key alone,so a set of distinct keys always
+     *                         has the same shape whatever the order of insertions and erasures
+     */
+    struct treap_random_priority
+    {
+        _Treap_wyrand _M_engine;
+
+        treap_random_priority() : _M_engine(_S_next_seed()) {}
+
+        explicit treap_random_priority(std::uint64_t __seed) : _M_engine(__seed) {}
+
+        template <typename _Key>
+        unsigned int operator()(const _Key&) { return _M_priority_of(_M_engine()); }
+
+        /*
+         * @brief an engine independent of this one,which moves on past the seed it handed out
+         */
+        treap_random_priority fork() noexcept { return treap_random_priority(_M_engine()); }
+
+        /*
+         * @brief fork() of a policy that must not change,as that of a Treap being copied;the seed is
+         * a hash of the current state,so copies of a seeded Treap are reproducible too
+         */
+        treap_random_priority fork() const noexcept { return treap_random_priority(_M_mix64(_M_engine._M_state)); }
+
+        static std::uint64_t _S_next_seed() {
+            thread_local _Treap_wyrand __seeds(std::random_device{}() * 0x9e3779b97f4a7c15ULL);
+            return __seeds();
+        }
+    };
+
+    template <typename _Key,typename _Hash = std::hash<_Key>>
+    struct treap_hash_priority
+    {
+        _Hash _M_hash;
+        std::uint64_t _M_seed;
+
+        explicit treap_hash_priority(std::uint64_t __seed = 0,const _Hash& __hash = _Hash()) : _M_hash(__hash),_M_seed(__seed) {}
+
+        unsigned int operator()(const _Key& __k) const { return _M_priority_of(_M_mix64(static_cast<std::uint64_t>(_M_hash(__k)) ^ _M_seed)); }
+    };
+
+    /*
+     * @brief the policy of a Treap derived from one using __gen:__gen.fork() if there is one,else a copy
+     */
+    template <typename _PriorityGen>
+    inline auto _M_fork_priority(_PriorityGen& __gen,int) -> decltype(__gen.fork()) { return __gen.fork(); }
+
+    template <typename _PriorityGen>
+    inline typename std::remove_const<_PriorityGen>::type _M_fork_priority(_PriorityGen& __gen,long) { return __gen; }
+
     static const unsigned int Direction_Left = 0;
     static const unsigned int Direction_Right = 1;
 
-    struct _Treap_node_base 
+    struct _Treap_node_base
     {
         typedef _Treap_node_base* _Base_ptr;
         typedef const _Treap_node_base* _Const_Base_ptr;
 
-        _Base_ptr _Base_ptr _M_children[2];
+        _Base_ptr _M_children[2];
         _Base_ptr _M_parent;
 
         unsigned int _M_size = 0;
@@ -81,17 +189,7 @@ namespace TreapTree {
 
         _Val* _M_valptr() { return _M_storage._M_ptr(); }
 
-        const _Val* _M_valptr() { return _M_storage._M_ptr(); }
-
-        #if defined _Treap_Debug
-        void _M_debug() const {
-            std::cout << "value_field: " << (*this->_M_valptr()) << " address:" << std::__addressof(*this);
-            std::cout << " parent address:" << this->_M_parent;
-            std::cout << " left child:" << this->_M_children[Direction_Left] << " rightchild" << this->_M_children[Direction_Right] << std::endl;
-            std::cout << "priority: " << this->_M_Priority << std::endl;
-            std::cout << "size of this node" << this->_M_size << std::endl;
-        }
-        #endif
+        const _Val* _M_valptr() const { return _M_storage._M_ptr(); }
     };
 
     static _Treap_node_base* local_treap_increment(_Treap_node_base* __x) {
@@ -132,10 +230,10 @@ namespace TreapTree {
         return __x;
     }
 
-    _Treap_node_base* treap_increment(_Treap_node_base* __x) { return local_treap_increment(__x); }
-    const _Treap_node_base* treap_increment(const _Treap_node_base* __x) { return local_treap_increment(const_cast<_Treap_node_base*>(__x)); }
-    _Treap_node_base* treap_decrement(_Treap_node_base* __x) { return local_treap_decrement(__x); }
-    const _Treap_node_base* treap_decrement(const _Treap_node_base* __x) { return local_treap_decrement(const_cast<_Treap_node_base*>(__x)); }
+    inline _Treap_node_base* treap_increment(_Treap_node_base* __x) { return local_treap_increment(__x); }
+    inline const _Treap_node_base* treap_increment(const _Treap_node_base* __x) { return local_treap_increment(const_cast<_Treap_node_base*>(__x)); }
+    inline _Treap_node_base* treap_decrement(_Treap_node_base* __x) { return local_treap_decrement(__x); }
+    inline const _Treap_node_base* treap_decrement(const _Treap_node_base* __x) { return local_treap_decrement(const_cast<_Treap_node_base*>(__x)); }
 
     template <typename _Tp>
     struct _Treap_iterator
@@ -145,7 +243,7 @@ namespace TreapTree {
         typedef _Tp& reference;
 
         typedef std::bidirectional_iterator_tag iterator_category;
-        typedef ptrdiff_t difference_type;
+        typedef std::ptrdiff_t difference_type;
 
         typedef _Treap_iterator<_Tp> _Self;
         typedef _Treap_node_base::_Base_ptr _Base_ptr;
@@ -154,10 +252,10 @@ namespace TreapTree {
         _Treap_iterator() : _M_node() {}
 
         explicit _Treap_iterator(_Base_ptr __x) : _M_node(__x) {}
-        
+
         reference operator* () const { return *static_cast<_Link_type>(_M_node)->_M_valptr(); }
 
-        pointer operator->() const { return static_cast<_Link_type>(_M_node)->_M_valptr(); } 
+        pointer operator->() const { return static_cast<_Link_type>(_M_node)->_M_valptr(); }
 
         _Self& operator++() {
             _M_node = treap_increment(_M_node);
@@ -176,9 +274,9 @@ namespace TreapTree {
         }
 
         _Self operator-- (int) {
-            _Self *tmp = *this;
+            _Self __tmp = *this;
             _M_node = treap_decrement(_M_node);
-            return *this;
+            return __tmp;
         }
 
         bool operator == (const _Self& __x) const { return _M_node == __x._M_node;}
@@ -188,7 +286,7 @@ namespace TreapTree {
     };
 
     template <typename _Tp>
-    struct _Treap_const_iterator 
+    struct _Treap_const_iterator
     {
         typedef  _Tp value_type;
         typedef const _Tp* pointer;
@@ -197,21 +295,23 @@ namespace TreapTree {
         typedef _Treap_iterator<_Tp> iterator;
 
         typedef std::bidirectional_iterator_tag iterator_category;
-        typedef ptrdiff_t   difference_type;
+        typedef std::ptrdiff_t   difference_type;
 
         typedef _Treap_const_iterator<_Tp> _Self;
-        typedef _Treap_nobe_base::_Const_Base_ptr _Base_ptr;
+        typedef _Treap_node_base::_Const_Base_ptr _Base_ptr;
         typedef const _Treap_node<_Tp>* _Link_type;
 
         _Treap_const_iterator() : _M_node() {}
 
-        explicit _Treap_const_iterator(const iterator& __it) : _M_node(__it._M_node) {}
+        explicit _Treap_const_iterator(_Base_ptr __x) : _M_node(__x) {}
+
+        _Treap_const_iterator(const iterator& __it) : _M_node(__it._M_node) {}
 
-        iterator _M_const_cast() { return iterator(const_cast<typename iterator::_Base_ptr>(_M_node)); }
+        iterator _M_const_cast() const { return iterator(const_cast<typename iterator::_Base_ptr>(_M_node)); }
 
         reference operator* () const { return *static_cast<_Link_type>(_M_node)->_M_valptr(); }
 
-        pointer operator->() const { return static_cast<_Link_type>(_M_node); }
+        pointer operator->() const { return static_cast<_Link_type>(_M_node)->_M_valptr(); }
 
         _Self& operator++() {
             _M_node = treap_increment(_M_node);
@@ -235,15 +335,15 @@ namespace TreapTree {
             return __tmp;
         }
 
-        bool operator == (const _Self& __x) { return _M_node == __x._M_node; }
-        bool operator != (const _Self& __x) { return _M_node != __x._M_node; }
+        bool operator == (const _Self& __x) const { return _M_node == __x._M_node; }
+        bool operator != (const _Self& __x) const { return _M_node != __x._M_node; }
 
-        _Base_ptr _M_Node;
+        _Base_ptr _M_node;
     };
 
     template <typename _Val>
     inline bool operator == (const _Treap_iterator<_Val>& __x , const _Treap_const_iterator<_Val>& __y) {
-        return __x._M_nodde == __y._M_node;
+        return __x._M_node == __y._M_node;
     }
 
     template <typename _Val>
@@ -251,391 +351,2988 @@ namespace TreapTree {
         return __x._M_node != __y._M_node;
     }
 
+    /*
+     * @brief counters of the calling thread,filled in only when compiled with _Treap_Stats
+     *
+     * _M_searches counts the single-key descents (lookups,bounds,insert positions,order_of_key),
+     * _M_comparisons the key comparisons made along them and _M_path_lengths how many descents
+     * compared against each number of nodes,the last bucket gathering the longer ones.
+     * _M_allocations and _M_deallocations count nodes taken from and given back to the node
+     * allocator,a compact() block counting as one;clear() and the destructor count every node
+     * even when a _Treap_pool_allocator frees them all at once.
+     *
+     * _Treap_Stats changes the bodies of inline functions and of every _Treap member that calls
+     * them,so it must be defined in all translation units of a program or in none:mixing them
+     * breaks the one-definition rule and the linker keeps whichever copy it sees first.Set it
+     * on the compiler command line (-D_Treap_Stats),not in a source file.
+     */
+    struct treap_stats
+    {
+        static const unsigned int _S_path_buckets = 64;
+
+        unsigned long long _M_rotations = 0;
+        unsigned long long _M_comparisons = 0;
+        unsigned long long _M_searches = 0;
+        unsigned long long _M_allocations = 0;
+        unsigned long long _M_deallocations = 0;
+        unsigned long long _M_path_lengths[_S_path_buckets] = {};
+
+        double _M_mean_path_length() const { return _M_searches == 0 ? 0.0 : static_cast<double>(_M_comparisons) / _M_searches; }
+    };
+
+    inline treap_stats& _M_thread_stats() {
+        thread_local treap_stats __stats;
+        return __stats;
+    }
+
+    /*
+     * @brief snapshot of the calling thread's counters,all zero unless compiled with _Treap_Stats
+     */
+    inline treap_stats treap_thread_stats() { return _M_thread_stats(); }
+
+    inline void treap_reset_thread_stats() { _M_thread_stats() = treap_stats(); }
+
+    /*
+     * Hooks of the hot paths,empty unless _Treap_Stats is defined.Counters are per thread,so
+     * they take no lock and cost one thread-local add when enabled.
+     */
+    inline void _M_stat_rotation() {
+        #if defined _Treap_Stats
+        ++_M_thread_stats()._M_rotations;
+        #endif
+    }
+
+    inline void _M_stat_search(unsigned int __steps) {
+        #if defined _Treap_Stats
+        treap_stats& __s = _M_thread_stats();
+        ++__s._M_searches;
+        __s._M_comparisons += __steps;
+        ++__s._M_path_lengths[__steps < treap_stats::_S_path_buckets ? __steps : treap_stats::_S_path_buckets - 1];
+        #else
+        (void)__steps;
+        #endif
+    }
+
+    inline void _M_stat_allocation() {
+        #if defined _Treap_Stats
+        ++_M_thread_stats()._M_allocations;
+        #endif
+    }
+
+    inline void _M_stat_deallocation(unsigned long long __n = 1) {
+        #if defined _Treap_Stats
+        _M_thread_stats()._M_deallocations += __n;
+        #else
+        (void)__n;
+        #endif
+    }
+
     /*
      * @breif rotate node
      * @param _curnode:rotate centre node;
      * @param _dir = 0 represent rotate left,dir = 1 represent rotate right
      */
-    void _M_rotate(_Treap_node_base* __curnode ,unsigned int __dir,_Treap_node_base& __header) {
-        if (__dir >= 2 || _curnode == nullptr || __curnode->_M_children[__dir ^ 1] == nullptr)
+    inline void _M_rotate(_Treap_node_base* __curnode ,unsigned int __dir,_Treap_node_base& __header) {
+        if (__dir >= 2 || __curnode == nullptr || __curnode->_M_children[__dir ^ 1] == nullptr)
             return;
-        
+        _M_stat_rotation();
+
         _Treap_node_base* k = __curnode->_M_children[__dir ^ 1];
         __curnode->_M_children[__dir ^ 1] = k->_M_children[__dir];
         k->_M_children[__dir] = __curnode;
 
-        _Treap_node_base* _parent = __curnode->_M_parent;
+        _Treap_node_base* __parent = __curnode->_M_parent;
         k->_M_parent = __parent;
 
-        if (__parent = &_header)
+        if (__parent == &__header)
             __header._M_parent = k;
         else {
             if (__parent->_M_children[Direction_Left] == __curnode)
                 __parent->_M_children[Direction_Left] = k;
-            if (__parent->_M_children[Direction_Right == __curnode])
-                __parent->_M_Mchildren[Direction_Right] = k;
+            if (__parent->_M_children[Direction_Right] == __curnode)
+                __parent->_M_children[Direction_Right] = k;
         }
 
         __curnode->_M_parent = k;
         if (__curnode->_M_children[__dir ^ 1])
             __curnode->_M_children[__dir ^ 1]->_M_parent = __curnode;
-        
+
         __curnode->_M_maintain();
-        k->maintain():
+        k->_M_maintain();
     }
 
-    template <typename _Key,typename _Compare = std::less<_Key>,typename _Alloc = std::allocator<_Key>>
-    class _Treap 
+    /*
+     * @brief default node hooks of the subtree algorithms below
+     *
+     * _M_push is called on a node before its children are read or relinked,_M_pull after its
+     * children changed.Augmented containers pass hooks that also move lazy tags and aggregates.
+     */
+    struct _Treap_size_update
     {
-        typedef typename __gnu_cxx::__alloc_traits<_Alloc>::template rebind<_Treap_node<_Key>>::other _Node_allocator;
+        void _M_push(_Treap_node_base*) const {}
 
-        typedef __gnu_cxx::_alloc_traits<_Node_allocator> _Alloc_traits;
+        void _M_pull(_Treap_node_base* __x) const { __x->_M_maintain(); }
+    };
 
-    private :
-        typedef _Treap_node_base* _Base_ptr;
-        typedef const _Treap_node_base* _Const_Base_ptr;
-        typedef _Treap_node<_Key>* _Link_type;
-        typedef const _Treap_node<_Key>* _Const_Link_type;
-    
-    private :
-        struct _Alloc_node 
-        {
-            _Alloc_node(_Treap & __t) : _M_t(__t) {}
+    /*
+     * @brief recompute _M_size from __x up to the subtree root
+     * @param __x deepest node whose children changed,may be nullptr
+     */
+    template <typename _NodeUpdate = _Treap_size_update>
+    inline void _M_maintain_path(_Treap_node_base* __x,const _NodeUpdate& __update = _NodeUpdate()) {
+        for (; __x != nullptr; __x = __x->_M_parent)
+            __update._M_pull(__x);
+    }
 
-            template <typename _Arg>
-            _Link_type operator() (_Args&& _arg) const {
-                return _M_t._M_create_node(std::forward<_Arg>(__arg));
+    /*
+     * @brief split a detached subtree into two subtrees in O(log n)
+     * @param __t root of the subtree,its _M_parent is ignored
+     * @param __goes_left predicate on a node,true if the node and its left subtree belong to __l
+     * @param __l,__r roots of the resulting subtrees,their _M_parent is nullptr
+     */
+    template <typename _Pred,typename _NodeUpdate = _Treap_size_update>
+    void _M_split(_Treap_node_base* __t,_Pred __goes_left,_Treap_node_base*& __l,_Treap_node_base*& __r,const _NodeUpdate& __update = _NodeUpdate()) {
+        _Treap_node_base** __lslot = &__l;
+        _Treap_node_base** __rslot = &__r;
+        _Treap_node_base* __lpar = nullptr;
+        _Treap_node_base* __rpar = nullptr;
+
+        while (__t != nullptr) {
+            __update._M_push(__t);
+            if (__goes_left(__t)) {
+                *__lslot = __t;
+                __t->_M_parent = __lpar;
+                __lpar = __t;
+                __lslot = &__t->_M_children[Direction_Right];
+                __t = __t->_M_children[Direction_Right];
+            }
+            else {
+                *__rslot = __t;
+                __t->_M_parent = __rpar;
+                __rpar = __t;
+                __rslot = &__t->_M_children[Direction_Left];
+                __t = __t->_M_children[Direction_Left];
             }
-
-        private :
-            _Treap& _M_t;
-        };
-    
-    public :
-        typedef _Key key_type;
-        typedef _Key value_type;
-        typedef value_type* pointer;
-        typedef const value_type* const_pointer;
-        typedef value_type& reference;
-        typedef const_value_type& cosnt_reference;
-        typedef size_t size_type;
-        typedef ptrdiff_t difference_type;
-        typedef _Alloc allocator_type;
-
-        _Node_allocator& _M_get_Node_allocator() {
-            return *static_cast<_Node_allocator*>(&this->_M_impl);
-        }
-
-        const _Node_allocator& _M_get_Node_allocator() const {
-            return *static_cast<const _Node_allocator*>(&this->_M_impl); 
-        }
-
-        allocator_type get_allocator() const {
-            return allocator_type(_M_get_Node_allocator());
         }
+        *__lslot = nullptr;
+        *__rslot = nullptr;
 
-    private :
-        _Link_type _M_get_node() { return _Alloc_traits::allocate(_M_get_Node_allocator(),1);  }
-
-        void _M_put_node(_Link_type __p) { _Alloc_traits::deallocate(_M_get_Node_allocator(),__p,1); }
+        _M_maintain_path(__lpar,__update);
+        _M_maintain_path(__rpar,__update);
+    }
 
-        template <typename... _Args>
-        void _M_construct_node(_Link_type __node,_Args&&... __args) {
-            try {
-                ::new(_node) _Treap_node<_Key>
-                _Alloc_traits::construct(_M_get_Node_allocator(),__node->_M_valptr(),std::forward<_Args>(__args)...);
+    /*
+     * @brief concatenate two detached subtrees in O(log n)
+     * @param __l,__r roots of the subtrees,every element of __l must order before every element of __r
+     * @return root of the merged subtree,its _M_parent is nullptr
+     */
+    template <typename _NodeUpdate = _Treap_size_update>
+    inline _Treap_node_base* _M_merge(_Treap_node_base* __l,_Treap_node_base* __r,const _NodeUpdate& __update = _NodeUpdate()) {
+        _Treap_node_base* __root = nullptr;
+        _Treap_node_base** __slot = &__root;
+        _Treap_node_base* __par = nullptr;
+
+        while (__l != nullptr && __r != nullptr) {
+            if (__l->_M_Priority > __r->_M_Priority) {
+                __update._M_push(__l);
+                *__slot = __l;
+                __l->_M_parent = __par;
+                __par = __l;
+                __slot = &__l->_M_children[Direction_Right];
+                __l = __l->_M_children[Direction_Right];
             }
-            catch(...) {
-                __node->_Treap_node<_Key>();
-                _M_put_node(__node);
+            else {
+                __update._M_push(__r);
+                *__slot = __r;
+                __r->_M_parent = __par;
+                __par = __r;
+                __slot = &__r->_M_children[Direction_Left];
+                __r = __r->_M_children[Direction_Left];
             }
         }
+        *__slot = __l != nullptr ? __l : __r;
+        if (*__slot != nullptr)
+            (*__slot)->_M_parent = __par;
 
-        void _M_destroy_node(_Link_type __p) {
-            _Alloc_traits::destroy(_M_get_Node_allocator(),__p->_M_valptr());
-            __p->~_Treap_node<_Key>();
-        }
+        _M_maintain_path(__par,__update);
+        return __root;
+    }
 
-        void _M_drop_node(_Link_type __p) {
-            _M_destroy_node(__p);
-            _M_put_node(__p);
+    /*
+     * @brief one step of a linear Cartesian-tree build: hang __z after __last in in-order
+     * @param __root root of the detached subtree being built,updated if __z becomes the root
+     * @param __last the current in-order last node,nullptr for an empty subtree
+     * @param __z initialized node carrying its priority
+     *
+     * The right spine is exactly the stack of the build and is reachable through _M_parent,
+     * so no extra stack is needed.A node's size is final once it is popped off the spine,
+     * call _M_maintain_path(last node) when the build is done to fix the rest of the spine.
+     */
+    template <typename _NodeUpdate = _Treap_size_update>
+    inline void _M_spine_append(_Treap_node_base*& __root,_Treap_node_base* __last,_Treap_node_base* __z,const _NodeUpdate& __update = _NodeUpdate()) {
+        _Treap_node_base* __x = __last;
+        _Treap_node_base* __popped = nullptr;
+        while (__x != nullptr && __x->_M_Priority < __z->_M_Priority) {
+            __update._M_pull(__x);
+            __popped = __x;
+            __x = __x->_M_parent;
         }
 
-        template <typename _NodeGen>
-        _Link_type _M_clone_node(_Const_Link_type __x,_NodeGen& __node_gen) {
-            _Link_type __tmp = __node_gen(*__x->_M_valptr());
-            __tmp->_M_parent = nullptr;
-            __tmp->_M_children[Direction_Left] = nullptr;
-            __tmp->_M_children[Direction_Right] = nullptr;
-            __tmp->_M_Priority = __x->_M_Priority;
-            return __tmp;
-        }
+        __z->_M_children[Direction_Left] = __popped;
+        if (__popped != nullptr)
+            __popped->_M_parent = __z;
+        __z->_M_parent = __x;
+        if (__x != nullptr)
+            __x->_M_children[Direction_Right] = __z;
+        else
+            __root = __z;
+    }
 
-        template <typename _Key_compare>
-        struct _Treap_impl : public _Node_allocator
-        {
-            _Key_compare _M_key_compare;
-            _Treap_node_base _M_header;
+    inline bool _M_is_header(const _Treap_node_base* __x) {
+        return __x->_M_Priority == MAX_PRIORITY && (__x->_M_parent == nullptr || __x->_M_parent->_M_parent == __x);
+    }
 
-            _Treap_impl() : _Node_allocator(), _M_key_compare(),_M_header() { _M_initialize() ; }
-            _Treap_impl(const _Key_compare& __comp,const _Node_allocator& __a) : _Node_allocator(__a),_M_key_compare(__comp),_M_header() { _M_initialize(); }
-            _Treap_impl(const _Key_compare& __comp,_Node_allocator&& __a) : _Node_allocator(std::move(__a)),_M_key_compare(__comp),_M_header() { _M_initialize(); }
+    inline unsigned int _M_subtree_size(const _Treap_node_base* __x) { return __x == nullptr ? 0 : __x->_M_size; }
 
-            void _M_reset() {
-                this->_M_header._M_parent = nullptr;
-                this->_M_header._M_children[Direction_Left] = &this->_M_header;
-                this->_M_header._M_children[Direction_Right] = &this->_M_header;
-                this->_M_header._M_Priority = MAX_PRIORITY;
+    /*
+     * @brief hint that __x will be read soon,a no-op where __builtin_prefetch is unavailable
+     */
+    inline void _M_prefetch(const _Treap_node_base* __x) {
+        #if defined(__GNUC__)
+        __builtin_prefetch(__x);
+        #else
+        (void)__x;
+        #endif
+    }
+
+    /*
+     * @brief in-order position of __x in its Treap in O(log n),the header maps to size()
+     */
+    inline std::size_t _M_node_rank(const _Treap_node_base* __x) {
+        if (_M_is_header(__x))
+            return _M_subtree_size(__x->_M_parent);
+
+        std::size_t __rank = _M_subtree_size(__x->_M_children[Direction_Left]);
+        for (const _Treap_node_base* __p = __x->_M_parent; __p != nullptr && !_M_is_header(__p); __x = __p,__p = __p->_M_parent)
+            if (__p->_M_children[Direction_Right] == __x)
+                __rank += _M_subtree_size(__p->_M_children[Direction_Left]) + 1;
+        return __rank;
+    }
+
+    /*
+     * @brief the node at in-order position __k below __root,nullptr if __k is out of range
+     */
+    inline _Treap_node_base* _M_node_select(_Treap_node_base* __root,std::size_t __k) {
+        while (__root != nullptr) {
+            std::size_t __lsize = _M_subtree_size(__root->_M_children[Direction_Left]);
+            if (__k == __lsize)
+                break;
+            if (__k < __lsize)
+                __root = __root->_M_children[Direction_Left];
+            else {
+                __k -= __lsize + 1;
+                __root = __root->_M_children[Direction_Right];
             }
+        }
+        return __root;
+    }
 
-        private :
-            void _M_initialize() {
-                this->_M_header._M_parent = nullptr;
-                this->_M_header._M_children[Direction_Left] = &this->_M_header;
-                this->_M_header._M_children[Direction_Right] = &this->_M_header;
-                this->_M_header._M_Priority = MAX_PRIORITY;
+    /*
+     * @brief number of levels below and including __x,walked through parent pointers without a stack
+     */
+    inline unsigned int _M_subtree_height(const _Treap_node_base* __x) {
+        if (__x == nullptr)
+            return 0;
+        const _Treap_node_base* const __top = __x;
+        unsigned int __h = 1,__d = 1;
+        for (;;) {
+            if (__d > __h)
+                __h = __d;
+            if (__x->_M_children[Direction_Left] != nullptr) {
+                __x = __x->_M_children[Direction_Left];
+                ++__d;
+                continue;
             }
-        };
+            if (__x->_M_children[Direction_Right] != nullptr) {
+                __x = __x->_M_children[Direction_Right];
+                ++__d;
+                continue;
+            }
+            for (;;) {
+                if (__x == __top)
+                    return __h;
+                const _Treap_node_base* __p = __x->_M_parent;
+                if (__p->_M_children[Direction_Left] == __x && __p->_M_children[Direction_Right] != nullptr) {
+                    __x = __p->_M_children[Direction_Right];
+                    break;
+                }
+                __x = __p;
+                --__d;
+            }
+        }
+    }
 
+    /*
+     * @brief append the nodes less than __h levels below __x in van Emde Boas order
+     *
+     * The top __h / 2 levels come first,then each subtree hanging below them,both laid out the
+     * same way,so any root-to-leaf path of length h crosses O(h / log B) blocks of B nodes.
+     * The recursion runs on an explicit stack,the height of a Treap with user priorities is not
+     * bounded by O(log n).
+     */
+    inline void _M_veb_order(_Treap_node_base* __x,unsigned int __h,std::vector<_Treap_node_base*>& __out) {
+        // lay out the subtrees __depth levels below _M_node,each __h levels high;__depth 0 is the node itself
+        struct _Frame { _Treap_node_base* _M_node; unsigned int _M_depth; unsigned int _M_h; };
+        std::vector<_Frame> __stack;
+        if (__x != nullptr && __h != 0)
+            __stack.push_back(_Frame{__x,0,__h});
+        while (!__stack.empty()) {
+            const _Frame __f = __stack.back();
+            __stack.pop_back();
+            if (__f._M_depth != 0) {
+                // right first,the left subtree is laid out before it
+                _Treap_node_base* __r = __f._M_node->_M_children[Direction_Right];
+                _Treap_node_base* __l = __f._M_node->_M_children[Direction_Left];
+                if (__r != nullptr)
+                    __stack.push_back(_Frame{__r,__f._M_depth - 1,__f._M_h});
+                if (__l != nullptr)
+                    __stack.push_back(_Frame{__l,__f._M_depth - 1,__f._M_h});
+            }
+            else if (__f._M_h == 1)
+                __out.push_back(__f._M_node);
+            else {
+                __stack.push_back(_Frame{__f._M_node,__f._M_h / 2,__f._M_h - __f._M_h / 2});
+                __stack.push_back(_Frame{__f._M_node,0,__f._M_h / 2});
+            }
+        }
+    }
 
-        private :
+    /*
+     * @brief move __x by __n in-order positions in O(log n),landing on the header past either end
+     */
+    inline _Treap_node_base* _M_node_advance(_Treap_node_base* __x,std::ptrdiff_t __n) {
+        _Treap_node_base* __header = __x;
+        while (!_M_is_header(__header))
+            __header = __header->_M_parent;
+
+        std::ptrdiff_t __k = static_cast<std::ptrdiff_t>(_M_node_rank(__x)) + __n;
+        if (__k < 0 || __k >= static_cast<std::ptrdiff_t>(_M_subtree_size(__header->_M_parent)))
+            return __header;
+        return _M_node_select(__header->_M_parent,static_cast<std::size_t>(__k));
+    }
 
-            //internal node definition
-            _Base_ptr& _M_root() { return this->_M_impl._M_header._M_parent; }
+    /*
+     * Overloads of distance/advance found by argument-dependent lookup,they use the subtree
+     * sizes instead of stepping one element at a time.Only an unqualified call reaches them:
+     * std::distance(__first,__last) and std::advance(__it,__n) name the std templates and still
+     * walk in O(n),write using std::distance;distance(__first,__last) to get O(log n) for any
+     * iterator type.
+     */
+    template <typename _Tp>
+    inline std::ptrdiff_t distance(_Treap_iterator<_Tp> __first,_Treap_iterator<_Tp> __last) {
+        return static_cast<std::ptrdiff_t>(_M_node_rank(__last._M_node)) - static_cast<std::ptrdiff_t>(_M_node_rank(__first._M_node));
+    }
 
-            _Const_Base_ptr _M_root() const { return this->_M_impl._M_header._M_parent; }
+    template <typename _Tp>
+    inline std::ptrdiff_t distance(_Treap_const_iterator<_Tp> __first,_Treap_const_iterator<_Tp> __last) {
+        return static_cast<std::ptrdiff_t>(_M_node_rank(__last._M_node)) - static_cast<std::ptrdiff_t>(_M_node_rank(__first._M_node));
+    }
 
-            _Base_ptr& _M_leftmost() { return this->_M_impl._M_header._M_children[Direction_Left]; }
+    template <typename _Tp,typename _Distance>
+    inline void advance(_Treap_iterator<_Tp>& __it,_Distance __n) {
+        __it._M_node = _M_node_advance(__it._M_node,static_cast<std::ptrdiff_t>(__n));
+    }
 
-            _Const_Base_Ptr _M_leftmost() const { return this->_M_impl._M_children[Direction_Left]; }
-            
-            _Base_ptr& _M_rightmost() { return this->_M_impl._M_header._M_children[Direction_Right]; }
+    template <typename _Tp,typename _Distance>
+    inline void advance(_Treap_const_iterator<_Tp>& __it,_Distance __n) {
+        __it._M_node = _M_node_advance(const_cast<_Treap_node_base*>(__it._M_node),static_cast<std::ptrdiff_t>(__n));
+    }
 
-            _Const_Base_ptr _M_rightmost() const { return this->_M_impl._M_header._M_children[Direction_Right]; }
+    /*
+     * @brief read-only in-order cursor that keeps the pending ancestors on a fixed stack
+     *
+     * _Dir is Direction_Right for ascending scans and Direction_Left for descending ones.A step
+     * descends through child links only and pops the next ancestor off the stack,so no _M_parent
+     * is followed and nothing is allocated.Past _S_depth pending ancestors the oldest are dropped
+     * and found again through the parent links once the stack runs dry.
+     */
+    template <typename _Tp,unsigned int _Dir>
+    struct _Treap_scan_cursor
+    {
+        typedef _Tp value_type;
+        typedef const _Tp* pointer;
+        typedef const _Tp& reference;
 
-            _Link_type _M_begin() { return static_cast<_Link_type>(this->_M_impl._M_header._M_parent); }
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::ptrdiff_t difference_type;
 
-            _Const_Link_type _M_begin() const { return static_cast<_Const_Link_type>(this->_M_impl._M_header._M_parent) ; }
+        typedef _Treap_scan_cursor<_Tp,_Dir> _Self;
+        typedef const _Treap_node_base* _Base_ptr;
+        typedef const _Treap_node<_Tp>* _Link_type;
 
-            _Base_ptr _M_end() { return &this->_M_impl._M_header; }
+        static const unsigned int _S_depth = 32;
 
-            _Const_Base_ptr _M_end() const { return &this->_M_impl._M_header; }
+        _Treap_scan_cursor() : _M_node(),_M_top(0),_M_count(0) {}
 
-            static const_reference  _S_value(_Const_Link_type __x)  { return *__x->_M_valptr(): }
+        /*
+         * @param __collect false for a cursor only compared against,such as end()
+         */
+        explicit _Treap_scan_cursor(_Base_ptr __x,bool __collect = true) : _M_node(__x),_M_top(0),_M_count(0) {
+            if (!__collect || _M_is_header(__x))
+                return;
+            _Base_ptr __pending[_S_depth];
+            unsigned int __n = 0;
+            for (_Base_ptr __p = __x->_M_parent; __n < _S_depth && !_M_is_header(__p); __x = __p,__p = __p->_M_parent)
+                if (__p->_M_children[1 - _Dir] == __x)
+                    __pending[__n++] = __p;
+            while (__n > 0)
+                _M_push(__pending[--__n]);
+        }
 
-            static const _Key& _S_key(_Const_Link_type __x) { return *x->_M_valptr(); }
+        reference operator* () const { return *static_cast<_Link_type>(_M_node)->_M_valptr(); }
 
-            static const _Key& _S_Key(_Base_ptr __x) { return *static_cast<_Const_Link_type>(__x)->_M_valptr(): }
+        pointer operator->() const { return static_cast<_Link_type>(_M_node)->_M_valptr(); }
 
-            static _Link_type _S_left(_Base_ptr __x) { return static_cast<_Link_type>(__x->_M_children[Direction_Left]) ;}
+        _Self& operator++() {
+            _Base_ptr __x = _M_node->_M_children[_Dir];
+            if (__x != nullptr) {
+                for (; __x->_M_children[1 - _Dir] != nullptr; __x = __x->_M_children[1 - _Dir])
+                    _M_push(__x);
+                _M_node = __x;
+            }
+            else if (_M_count > 0) {
+                --_M_count;
+                _M_node = _M_stack[--_M_top & (_S_depth - 1)];
+            }
+            else {
+                _Base_ptr __p = _M_node->_M_parent;
+                for (__x = _M_node; !_M_is_header(__p) && __p->_M_children[_Dir] == __x; __p = __p->_M_parent)
+                    __x = __p;
+                _M_node = __p;
+            }
+            return *this;
+        }
 
-            static _Const_Link_type _S_left(_Const_Base_Ptr __x) { return static_cast<_Const_Link_type>(__x->_M_children[Direction_Left]); }
+        _Self operator++(int) {
+            _Self __tmp = *this;
+            ++*this;
+            return __tmp;
+        }
 
-            static _Link_type _S_right(_Base_ptr __x) { return *static_cast<_Link_type>(__x->_M_children[Direction_Right]); }
+        bool operator == (const _Self& __x) const { return _M_node == __x._M_node; }
+        bool operator != (const _Self& __x) const { return _M_node != __x._M_node; }
 
-            static _Const_Link_type _S_right(_Const_Base_ptr __x) { return static_cast<_Const_Link_type>(__x->_M_children[Direction_Right]); }
+        void _M_push(_Base_ptr __x) {
+            _M_stack[_M_top++ & (_S_depth - 1)] = __x;
+            if (_M_count < _S_depth)
+                ++_M_count;
+        }
 
-            static _Base_ptr _S_minimum(_Base_ptr __x) { return _Treap_node_base::_S_minimum(__x); }
+        _Base_ptr _M_node;
+        _Base_ptr _M_stack[_S_depth];
+        unsigned int _M_top;
+        unsigned int _M_count;
+    };
 
-            static _Const_Base_ptr _S_minimumm(_Const_Base_ptr __x) { return _Treap_Node_base::_S_minimum(__x); }
+    /*
+     * @brief the elements between two nodes of a Treap in scan order,see _Treap::range()
+     *
+     * The view holds two node pointers and the comparator,so it is cheap to copy and stays valid
+     * as long as neither bounding node is erased.
+     */
+    template <typename _Val,typename _KeyOfValue,typename _Compare,unsigned int _Dir>
+    class _Treap_range_view
+    {
+    public :
+        typedef _Val value_type;
+        typedef const _Val& reference;
+        typedef const _Val& const_reference;
+        typedef _Treap_scan_cursor<_Val,_Dir> iterator;
+        typedef iterator const_iterator;
 
-            static _Base_ptr _S_maximum(_Base_ptr __x) {return _Treap_node_base::_S_maximum(__x) ; }
+        _Treap_range_view() : _M_first(),_M_last() {}
 
-            static _Const_Base_ptr _S_maximum(_Const_Base_ptr __x) { return _Treap_node_base::_S_maximum(__x); }
+        _Treap_range_view(const _Treap_node_base* __first,const _Treap_node_base* __last,const _Compare& __comp)
+        : _M_key_compare(__comp),_M_first(__first),_M_last(__last) {}
 
-        public :
-            typedef _Treap_iterator<value_type> iterator;
-            typedef _Treap_const_iterator<value_type> const_iterator;
-        
-        private :
-            void _M_insert_equal_node(_Base_ptr __x,_Base_ptr __p,_Link_type __x,unsigned int __dir);
+        iterator begin() const { return iterator(_M_first); }
 
-            #if defined _Treap_debug 
-            void _M_debug(_Const_Base_ptr __curnode,unsigned int __depth) const;
-            #endif
+        iterator end() const { return iterator(_M_last,false); }
 
+        bool empty() const { return _M_first == _M_last; }
 
-            void _M_erase(_Link_type __x);
+        /*
+         * @brief true if __x is met before __y in this scan
+         */
+        bool _M_before(const _Val& __x,const _Val& __y) const {
+            return _Dir == Direction_Right ? _M_key_compare(_KeyOfValue()(__x),_KeyOfValue()(__y))
+                                           : _M_key_compare(_KeyOfValue()(__y),_KeyOfValue()(__x));
+        }
+
+    private :
+        _Compare _M_key_compare;
+        const _Treap_node_base* _M_first;
+        const _Treap_node_base* _M_last;
+    };
+
+    /*
+     * @brief lazy merge of _Nm range views of the same type,see kmerge()
+     *
+     * The iterator keeps one cursor per view and a binary heap of the views that are not exhausted,
+     * each step costs O(log _Nm) comparisons.Equivalent elements come out in the order of the views.
+     * It holds its own copies of the views,so it outlives the _Treap_kmerge_view it came from,as
+     * for (auto& __v : kmerge(...)) relies on.
+     */
+    template <typename _View,std::size_t _Nm>
+    class _Treap_kmerge_view
+    {
+    public :
+        typedef typename _View::value_type value_type;
+        typedef typename _View::const_reference reference;
+        typedef reference const_reference;
+
+        class iterator
+        {
+        public :
+            typedef typename _View::value_type value_type;
+            typedef typename _View::const_reference reference;
+            typedef const value_type* pointer;
+
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::ptrdiff_t difference_type;
+
+            iterator() : _M_live(0) {}
+
+            iterator(const std::array<_View,_Nm>& __views,bool __at_end) : _M_views(__views),_M_live(0) {
+                for (std::size_t __i = 0; __i < _Nm; ++__i) {
+                    const _View& __v = _M_views[__i];
+                    _M_lanes[__i] = __at_end ? __v.end() : __v.begin();
+                    if (_M_lanes[__i] != __v.end())
+                        _M_heap[_M_live++] = __i;
+                }
+                std::make_heap(_M_heap,_M_heap + _M_live,_Lane_after(this));
+            }
+
+            reference operator* () const { return *_M_lanes[_M_heap[0]]; }
+
+            pointer operator->() const { return std::__addressof(**this); }
+
+            iterator& operator++() {
+                std::pop_heap(_M_heap,_M_heap + _M_live,_Lane_after(this));
+                std::size_t __i = _M_heap[_M_live - 1];
+                if (++_M_lanes[__i] == _M_views[__i].end())
+                    --_M_live;
+                else
+                    std::push_heap(_M_heap,_M_heap + _M_live,_Lane_after(this));
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator __tmp = *this;
+                ++*this;
+                return __tmp;
+            }
+
+            bool operator == (const iterator& __x) const {
+                for (std::size_t __i = 0; __i < _Nm; ++__i)
+                    if (_M_lanes[__i] != __x._M_lanes[__i])
+                        return false;
+                return true;
+            }
+
+            bool operator != (const iterator& __x) const { return !(*this == __x); }
+
+        private :
+            /*
+             * @brief heap order,the lane whose element comes first sits on top and ties go to the lower lane
+             */
+            struct _Lane_after
+            {
+                const iterator* _M_it;
+
+                explicit _Lane_after(const iterator* __it) : _M_it(__it) {}
+
+                bool operator()(std::size_t __a,std::size_t __b) const {
+                    const _View& __v = _M_it->_M_views[0];
+                    if (__v._M_before(*_M_it->_M_lanes[__b],*_M_it->_M_lanes[__a]))
+                        return true;
+                    return !__v._M_before(*_M_it->_M_lanes[__a],*_M_it->_M_lanes[__b]) && __b < __a;
+                }
+            };
+
+            std::array<_View,_Nm> _M_views;
+            typename _View::iterator _M_lanes[_Nm];
+            std::size_t _M_heap[_Nm];
+            std::size_t _M_live;
+        };
+
+        typedef iterator const_iterator;
+
+        _Treap_kmerge_view() {}
+
+        explicit _Treap_kmerge_view(const std::array<_View,_Nm>& __views) : _M_views(__views) {}
+
+        iterator begin() const { return iterator(_M_views,false); }
+
+        iterator end() const { return iterator(_M_views,true); }
+
+        bool empty() const { return begin() == end(); }
+
+    private :
+        std::array<_View,_Nm> _M_views;
+    };
+
+    /*
+     * @brief merges range views of several Treaps into one ordered scan,without copying any element
+     *
+     * All views must have the same type,ascending views give an ascending merge and views from
+     * reverse_range() a descending one.The result and its iterators refer to the Treaps,not to the
+     * views passed in,and an iterator stays valid after the result is destroyed.
+     */
+    template <typename _View,typename... _Views>
+    inline _Treap_kmerge_view<_View,1 + sizeof...(_Views)> kmerge(const _View& __v,const _Views&... __vs) {
+        std::array<_View,1 + sizeof...(_Views)> __views = {{ __v,__vs... }};
+        return _Treap_kmerge_view<_View,1 + sizeof...(_Views)>(__views);
+    }
+
+    /*
+     * @brief owner of a node taken out of a Treap by extract(),see _Treap::insert(node_type&&)
+     *
+     * The handle holds a copy of the node allocator and frees the node with it unless the node is
+     * linked again,into any Treap of the same node type whose allocator compares equal.
+     */
+    template <typename _Val,typename _NodeAlloc>
+    class _Treap_node_handle
+    {
+        typedef __gnu_cxx::__alloc_traits<_NodeAlloc> _Alloc_traits;
+        typedef _Treap_node<_Val>* _Link_type;
+
+    public :
+        typedef _Val value_type;
+        typedef typename _Alloc_traits::template rebind<_Val>::other allocator_type;
+
+        _Treap_node_handle() noexcept : _M_ptr() {}
+
+        /*
+         * @brief takes __p over,its value constructed and its links no longer used by any Treap
+         */
+        _Treap_node_handle(_Link_type __p,const _NodeAlloc& __a) : _M_ptr(__p) {
+            ::new(_M_alloc_storage._M_addr()) _NodeAlloc(__a);
+        }
+
+        _Treap_node_handle(_Treap_node_handle&& __nh) noexcept : _M_ptr() { _M_take(__nh); }
+
+        _Treap_node_handle& operator = (_Treap_node_handle&& __nh) noexcept {
+            if (this != &__nh) {
+                _M_reset();
+                _M_take(__nh);
+            }
+            return *this;
+        }
+
+        ~_Treap_node_handle() { _M_reset(); }
+
+        bool empty() const noexcept { return _M_ptr == nullptr; }
+
+        explicit operator bool() const noexcept { return _M_ptr != nullptr; }
+
+        value_type& value() const { return *_M_ptr->_M_valptr(); }
+
+        allocator_type get_allocator() const { return allocator_type(_M_get_Node_allocator()); }
+
+        void swap(_Treap_node_handle& __nh) noexcept {
+            _Treap_node_handle __tmp(std::move(__nh));
+            __nh = std::move(*this);
+            *this = std::move(__tmp);
+        }
+
+        _Link_type _M_node() const { return _M_ptr; }
+
+        const _NodeAlloc& _M_get_Node_allocator() const { return *_M_alloc_storage._M_ptr(); }
+
+        /*
+         * @brief gives the node up once it is linked into a Treap,leaving the handle empty
+         */
+        _Link_type _M_release() {
+            _Link_type __p = _M_ptr;
+            _M_alloc_storage._M_ptr()->~_NodeAlloc();
+            _M_ptr = nullptr;
+            return __p;
+        }
+
+    private :
+        void _M_take(_Treap_node_handle& __nh) {
+            if (__nh._M_ptr == nullptr)
+                return;
+            ::new(_M_alloc_storage._M_addr()) _NodeAlloc(std::move(*__nh._M_alloc_storage._M_ptr()));
+            _M_ptr = __nh._M_release();
+        }
+
+        void _M_reset() {
+            if (_M_ptr == nullptr)
+                return;
+            _NodeAlloc& __a = *_M_alloc_storage._M_ptr();
+            _Alloc_traits::destroy(__a,_M_ptr->_M_valptr());
+            _M_ptr->~_Treap_node<_Val>();
+            _M_stat_deallocation();
+            _Alloc_traits::deallocate(__a,_M_ptr,1);
+            _M_release();
+        }
+
+        _Link_type _M_ptr;
+        __gnu_cxx::__aligned_membuf<_NodeAlloc> _M_alloc_storage;
+    };
+
+    template <typename _Val,typename _NodeAlloc>
+    inline void swap(_Treap_node_handle<_Val,_NodeAlloc>& __x,_Treap_node_handle<_Val,_NodeAlloc>& __y) noexcept { __x.swap(__y); }
+
+    /*
+     * @brief result of inserting a node handle into a Treap of unique keys,as std::set::insert_return_type
+     */
+    template <typename _Iterator,typename _NodeHandle>
+    struct _Treap_insert_return
+    {
+        _Iterator position;
+        bool inserted;
+        _NodeHandle node;
+    };
+
+    /*
+     * @brief opt-in for node allocators that can hand back every block at once
+     *
+     * A specialization deriving from std::true_type promises the allocator provides
+     * _M_is_sole_owner() and _M_release_all(),clear() and the destructor then skip
+     * the per-node deallocation.
+     */
+    template <typename _Alloc>
+    struct _Treap_bulk_release : public std::false_type {};
+
+    template <typename _Treap_type>
+    struct _Treap_set_algebra;
+
+    /*
+     * @brief has a member type "type" only if _Compare::is_transparent exists,enables lookup by any _Kt
+     */
+    template <typename _Compare,typename _Kt,typename _Tp = void>
+    struct _Treap_transparent {};
+
+    template <typename _Compare,typename _Kt>
+    struct _Treap_transparent<_Compare,_Kt,typename std::conditional<true,void,typename _Compare::is_transparent>::type>
+    { typedef void type; };
+
+    /*
+     * @brief _Val is the stored element and _KeyOfValue extracts its key,as in _Rb_tree;the defaults give a multiset of _Key
+     *
+     * _PriorityGen draws the priority of every new node,see treap_random_priority.
+     */
+    template <typename _Key,typename _Compare = std::less<_Key>,typename _Alloc = std::allocator<_Key>,typename _Val = _Key,typename _KeyOfValue = std::_Identity<_Key>,
+              typename _PriorityGen = treap_random_priority>
+    class _Treap
+    {
+        typedef typename __gnu_cxx::__alloc_traits<_Alloc>::template rebind<_Treap_node<_Val>>::other _Node_allocator;
+
+        typedef __gnu_cxx::__alloc_traits<_Node_allocator> _Alloc_traits;
+
+    private :
+        typedef _Treap_node_base* _Base_ptr;
+        typedef const _Treap_node_base* _Const_Base_ptr;
+        typedef _Treap_node<_Val>* _Link_type;
+        typedef const _Treap_node<_Val>* _Const_Link_type;
+
+    private :
+        struct _Alloc_node
+        {
+            _Alloc_node(_Treap & __t) : _M_t(__t) {}
+
+            template <typename _Arg>
+            _Link_type operator() (_Arg&& __arg) const {
+                return _M_t._M_create_node(std::forward<_Arg>(__arg));
+            }
+
+        private :
+            _Treap& _M_t;
+        };
+
+        /*
+         * @brief node generator for copy assignment,hands out the old nodes of the target before allocating
+         *
+         * The old tree is flattened lazily by right rotations,each node taken costs O(1) amortized.
+         * Nodes left over are freed on destruction.
+         */
+        struct _Reuse_or_alloc_node
+        {
+            _Reuse_or_alloc_node(_Treap& __t) : _M_nodes(__t._M_release_root()),_M_t(__t) {}
+
+            _Reuse_or_alloc_node(const _Reuse_or_alloc_node&) = delete;
+
+            ~_Reuse_or_alloc_node() { _M_t._M_erase(static_cast<_Link_type>(_M_nodes)); }
+
+            template <typename _Arg>
+            _Link_type operator() (_Arg&& __arg) {
+                _Link_type __node = _M_extract();
+                if (__node != nullptr) {
+                    _M_t._M_destroy_node(__node);
+                    _M_t._M_construct_node(__node,std::forward<_Arg>(__arg));
+                    return __node;
+                }
+                return _M_t._M_create_node(std::forward<_Arg>(__arg));
+            }
+
+        private :
+            _Link_type _M_extract() {
+                _Base_ptr __x = _M_nodes;
+                if (__x == nullptr)
+                    return nullptr;
+                while (__x->_M_children[Direction_Left] != nullptr) {
+                    _Base_ptr __y = __x->_M_children[Direction_Left];
+                    __x->_M_children[Direction_Left] = __y->_M_children[Direction_Right];
+                    __y->_M_children[Direction_Right] = __x;
+                    __x = __y;
+                }
+                _M_nodes = __x->_M_children[Direction_Right];
+                return static_cast<_Link_type>(__x);
+            }
+
+            _Base_ptr _M_nodes;
+            _Treap& _M_t;
+        };
+
+        /*
+         * @brief wraps a node generator so _M_copy() moves the values out of a source about to be cleared
+         */
+        template <typename _NodeGen>
+        struct _Move_values
+        {
+            _Move_values(_NodeGen& __gen) : _M_gen(__gen) {}
+
+            _Link_type operator() (const _Val& __v) { return _M_gen(std::move(const_cast<_Val&>(__v))); }
+
+        private :
+            _NodeGen& _M_gen;
+        };
+
+    public :
+        typedef _Key key_type;
+        typedef _Val value_type;
+        typedef value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _Alloc allocator_type;
+
+        _Node_allocator& _M_get_Node_allocator() {
+            return *static_cast<_Node_allocator*>(&this->_M_impl);
+        }
+
+        const _Node_allocator& _M_get_Node_allocator() const {
+            return *static_cast<const _Node_allocator*>(&this->_M_impl);
+        }
+
+        allocator_type get_allocator() const {
+            return allocator_type(_M_get_Node_allocator());
+        }
+
+        _Compare key_comp() const { return _M_impl._M_key_compare; }
+
+    private :
+        _Link_type _M_get_node() {
+            _M_stat_allocation();
+            return _Alloc_traits::allocate(_M_get_Node_allocator(),1);
+        }
+
+        /*
+         * @brief give a node back,nodes inside the block laid out by compact() are only counted off
+         */
+        void _M_put_node(_Link_type __p) {
+            if (_M_in_block(__p)) {
+                if (--_M_impl._M_block_live == 0)
+                    _M_release_block();
+                return;
+            }
+            _M_stat_deallocation();
+            _Alloc_traits::deallocate(_M_get_Node_allocator(),__p,1);
+        }
+
+        bool _M_in_block(_Link_type __p) const {
+            return _M_impl._M_block != nullptr && !std::less<_Link_type>()(__p,_M_impl._M_block)
+                   && std::less<_Link_type>()(__p,_M_impl._M_block + _M_impl._M_block_nodes);
+        }
+
+        void _M_release_block() {
+            _M_stat_deallocation();
+            _Alloc_traits::deallocate(_M_get_Node_allocator(),_M_impl._M_block,_M_impl._M_block_nodes);
+            _M_impl._M_block = nullptr;
+            _M_impl._M_block_nodes = _M_impl._M_block_live = 0;
+        }
+
+        template <typename... _Args>
+        void _M_construct_node(_Link_type __node,_Args&&... __args) {
+            try {
+                ::new(__node) _Treap_node<_Val>;
+                _Alloc_traits::construct(_M_get_Node_allocator(),__node->_M_valptr(),std::forward<_Args>(__args)...);
+            }
+            catch(...) {
+                __node->~_Treap_node<_Val>();
+                _M_put_node(__node);
+                throw;
+            }
+        }
+
+        template <typename... _Args>
+        _Link_type _M_create_node(_Args&&... __args) {
+            _Link_type __tmp = _M_get_node();
+            _M_construct_node(__tmp,std::forward<_Args>(__args)...);
+            return __tmp;
+        }
+
+        void _M_destroy_node(_Link_type __p) {
+            _Alloc_traits::destroy(_M_get_Node_allocator(),__p->_M_valptr());
+            __p->~_Treap_node<_Val>();
+        }
+
+        void _M_drop_node(_Link_type __p) {
+            _M_destroy_node(__p);
+            _M_put_node(__p);
+        }
+
+        template <typename _NodeGen>
+        _Link_type _M_clone_node(_Const_Link_type __x,_NodeGen& __node_gen) {
+            _Link_type __tmp = __node_gen(*__x->_M_valptr());
+            __tmp->_M_parent = nullptr;
+            __tmp->_M_children[Direction_Left] = nullptr;
+            __tmp->_M_children[Direction_Right] = nullptr;
+            __tmp->_M_Priority = __x->_M_Priority;
+            return __tmp;
+        }
+
+        template <typename _Key_compare>
+        struct _Treap_impl : public _Node_allocator
+        {
+            _Key_compare _M_key_compare;
+            _PriorityGen _M_priority_gen;
+            _Treap_node_base _M_header;
+            // array of nodes allocated by compact(),freed once none of its nodes is in use
+            _Link_type _M_block = nullptr;
+            size_type _M_block_nodes = 0;
+            size_type _M_block_live = 0;
+
+            _Treap_impl() : _Node_allocator(), _M_key_compare(),_M_priority_gen(),_M_header() { _M_initialize() ; }
+            _Treap_impl(const _Key_compare& __comp,const _Node_allocator& __a,const _PriorityGen& __gen = _PriorityGen())
+            : _Node_allocator(__a),_M_key_compare(__comp),_M_priority_gen(__gen),_M_header() { _M_initialize(); }
+            _Treap_impl(const _Key_compare& __comp,_Node_allocator&& __a,const _PriorityGen& __gen = _PriorityGen())
+            : _Node_allocator(std::move(__a)),_M_key_compare(__comp),_M_priority_gen(__gen),_M_header() { _M_initialize(); }
+
+            void _M_reset() {
+                this->_M_header._M_parent = nullptr;
+                this->_M_header._M_children[Direction_Left] = &this->_M_header;
+                this->_M_header._M_children[Direction_Right] = &this->_M_header;
+                this->_M_header._M_Priority = MAX_PRIORITY;
+            }
+
+        private :
+            void _M_initialize() {
+                this->_M_header._M_parent = nullptr;
+                this->_M_header._M_children[Direction_Left] = &this->_M_header;
+                this->_M_header._M_children[Direction_Right] = &this->_M_header;
+                this->_M_header._M_Priority = MAX_PRIORITY;
+            }
+        };
+
+        _Treap_impl<_Compare> _M_impl;
+
+        private :
+
+            //internal node definition
+            _Base_ptr& _M_root() { return this->_M_impl._M_header._M_parent; }
+
+            _Const_Base_ptr _M_root() const { return this->_M_impl._M_header._M_parent; }
+
+            _Base_ptr& _M_leftmost() { return this->_M_impl._M_header._M_children[Direction_Left]; }
+
+            _Const_Base_ptr _M_leftmost() const { return this->_M_impl._M_header._M_children[Direction_Left]; }
+
+            _Base_ptr& _M_rightmost() { return this->_M_impl._M_header._M_children[Direction_Right]; }
+
+            _Const_Base_ptr _M_rightmost() const { return this->_M_impl._M_header._M_children[Direction_Right]; }
+
+            _Link_type _M_begin() { return static_cast<_Link_type>(this->_M_impl._M_header._M_parent); }
+
+            _Const_Link_type _M_begin() const { return static_cast<_Const_Link_type>(this->_M_impl._M_header._M_parent) ; }
+
+            _Base_ptr _M_end() { return &this->_M_impl._M_header; }
+
+            _Const_Base_ptr _M_end() const { return &this->_M_impl._M_header; }
+
+            static const_reference  _S_value(_Const_Link_type __x)  { return *__x->_M_valptr(); }
+
+            static const _Key& _S_key(_Const_Link_type __x) { return _KeyOfValue()(*__x->_M_valptr()); }
+
+            static const _Key& _S_key(_Const_Base_ptr __x) { return _KeyOfValue()(*static_cast<_Const_Link_type>(__x)->_M_valptr()); }
+
+            static _Link_type _S_left(_Base_ptr __x) { return static_cast<_Link_type>(__x->_M_children[Direction_Left]) ;}
+
+            static _Const_Link_type _S_left(_Const_Base_ptr __x) { return static_cast<_Const_Link_type>(__x->_M_children[Direction_Left]); }
+
+            static _Link_type _S_right(_Base_ptr __x) { return static_cast<_Link_type>(__x->_M_children[Direction_Right]); }
+
+            static _Const_Link_type _S_right(_Const_Base_ptr __x) { return static_cast<_Const_Link_type>(__x->_M_children[Direction_Right]); }
+
+            static _Base_ptr _S_minimum(_Base_ptr __x) { return _Treap_node_base::_S_minimum(__x); }
+
+            static _Const_Base_ptr _S_minimum(_Const_Base_ptr __x) { return _Treap_node_base::_S_minimum(__x); }
+
+            static _Base_ptr _S_maximum(_Base_ptr __x) {return _Treap_node_base::_S_maximum(__x) ; }
+
+            static _Const_Base_ptr _S_maximum(_Const_Base_ptr __x) { return _Treap_node_base::_S_maximum(__x); }
+
+        public :
+            typedef _Treap_iterator<value_type> iterator;
+            typedef _Treap_const_iterator<value_type> const_iterator;
+            typedef _Treap_range_view<value_type,_KeyOfValue,_Compare,Direction_Right> range_type;
+            typedef _Treap_range_view<value_type,_KeyOfValue,_Compare,Direction_Left> reverse_range_type;
+            typedef _Treap_node_handle<value_type,_Node_allocator> node_type;
+            typedef _Treap_insert_return<iterator,node_type> insert_return_type;
+
+        private :
+            void _M_insert_equal_node(_Base_ptr __z) { _M_insert_equal_node(__z,_M_draw_priority(__z)); }
+
+            void _M_insert_equal_node(_Base_ptr __z,unsigned int __priority);
+
+            void _M_erase_node(_Base_ptr __x);
+
+            void _M_unlink_node(_Base_ptr __x);
+
+            /*
+             * @brief split a detached subtree after its first __n elements
+             */
+            void _M_split_rank(_Base_ptr __t,size_type __n,_Base_ptr& __l,_Base_ptr& __r) {
+                _M_split(__t,[&__n](_Base_ptr __x) {
+                    size_type __lsize = _M_subtree_size(__x->_M_children[Direction_Left]);
+                    if (__n <= __lsize)
+                        return false;
+                    __n -= __lsize + 1;
+                    return true;
+                },__l,__r);
+            }
+
+            /*
+             * @brief detach the elements with keys in [__lo,__hi) as one subtree,nullptr if there are none
+             */
+            _Base_ptr _M_cut_range(const key_type& __lo,const key_type& __hi) {
+                _Base_ptr __lroot,__mroot,__rroot;
+                _M_split(_M_release_root(),[&](_Base_ptr __x) { return _M_impl._M_key_compare(_S_key(__x),__lo); },__lroot,__mroot);
+                _M_split(__mroot,[&](_Base_ptr __x) { return _M_impl._M_key_compare(_S_key(__x),__hi); },__mroot,__rroot);
+                _M_set_root(_M_merge(__lroot,__rroot));
+                return __mroot;
+            }
+
+            /*
+             * @brief one pass over the subtree at __x,flattened on the fly as _M_erase() does:nodes
+             *        matching __drop are freed,the others appended to the spine build at __root/__last
+             */
+            template <typename _Predicate>
+            size_type _M_rebuild_if(_Base_ptr& __x,_Base_ptr& __root,_Base_ptr& __last,_Predicate& __drop);
+
+            /*
+             * @brief move [__first,__last) out into a new Treap by two splits,then concatenate the rest again
+             */
+            _Treap _M_cut(const_iterator __first,const_iterator __last) {
+                const size_type __lo = _M_node_rank(__first._M_node),__hi = _M_node_rank(__last._M_node);
+                _Treap __cut = split_at(__lo);
+                _Treap __tail = __cut.split_at(__hi - __lo);
+                merge(__tail);
+                return __cut;
+            }
+
+            void _M_erase(_Link_type __x);
+
+            //template <typename _Arg,typename _NodeGen>
+            //iterator _M_insert(_Base_ptr __x,_Base_ptr __y,_Args&& __v,_NodeGen);
+
+            //iterator _M_insert_node(_Base_ptr __x,_Base_ptr __y,_Link_type __z);
+
+            template <typename _NodeGen>
+            _Link_type _M_copy(_Const_Link_type __x,_Base_ptr __p,_NodeGen&);
+
+            _Link_type _M_copy(_Const_Link_type __x,_Base_ptr __p) {
+                _Alloc_node __an(*this);
+                return _M_copy(__x,__p,__an);
+            }
+
+            void _M_move_data(_Treap& __x,std::true_type) {
+                _M_set_root(__x._M_root());
+                __x._M_impl._M_reset();
+                std::swap(_M_impl._M_block,__x._M_impl._M_block);
+                std::swap(_M_impl._M_block_nodes,__x._M_impl._M_block_nodes);
+                std::swap(_M_impl._M_block_live,__x._M_impl._M_block_live);
+            }
+
+            /*
+             * @brief take the elements of __x whose allocator may differ from ours,nodes are stolen only if they compare equal
+             */
+            void _M_move_data(_Treap& __x,std::false_type) {
+                if (_M_get_Node_allocator() == __x._M_get_Node_allocator()) {
+                    _M_move_data(__x,std::true_type());
+                    return;
+                }
+                _Alloc_node __an(*this);
+                _Move_values<_Alloc_node> __mv(__an);
+                _M_set_root(_M_copy(__x._M_begin(),_M_end(),__mv));
+                __x.clear();
+            }
+
+            void _M_move_assign(_Treap& __x,std::true_type) {
+                clear();
+                if (__x._M_root() != nullptr)
+                    _M_move_data(__x,std::true_type());
+                std::__alloc_on_move(_M_get_Node_allocator(),__x._M_get_Node_allocator());
+            }
+
+            /*
+             * @brief move assignment between allocators that do not propagate,elements move into our old nodes when they differ
+             */
+            void _M_move_assign(_Treap& __x,std::false_type) {
+                if (_M_get_Node_allocator() == __x._M_get_Node_allocator()) {
+                    _M_move_assign(__x,std::true_type());
+                    return;
+                }
+                _Reuse_or_alloc_node __roan(*this);
+                if (__x._M_root() != nullptr) {
+                    _Move_values<_Reuse_or_alloc_node> __mv(__roan);
+                    _M_set_root(_M_copy(__x._M_begin(),_M_end(),__mv));
+                    __x.clear();
+                }
+            }
+
+            /*
+             * @brief move every node into fresh memory laid out in van Emde Boas order
+             * @param __contiguous one array for all nodes if true,else one allocation per node
+             */
+            void _M_relocate(bool __contiguous);
+
+            /*
+             * @brief give every node its own allocation again before nodes move to another Treap
+             */
+            void _M_thaw() {
+                if (_M_impl._M_block != nullptr)
+                    _M_relocate(false);
+            }
+
+            /*
+             * @brief hang a detached subtree under the header and refresh leftmost/rightmost
+             * @param __root root of the subtree,nullptr leaves the Treap empty
+             */
+            void _M_set_root(_Base_ptr __root) {
+                if (__root == nullptr) {
+                    _M_impl._M_reset();
+                    return;
+                }
+                _M_root() = __root;
+                __root->_M_parent = _M_end();
+                _M_leftmost() = _S_minimum(__root);
+                _M_rightmost() = _S_maximum(__root);
+            }
+
+            /*
+             * @brief unhook the whole tree from the header,leaving this Treap empty
+             * @return detached root,nullptr if the Treap was empty
+             */
+            _Base_ptr _M_release_root() {
+                _Base_ptr __root = _M_root();
+                if (__root != nullptr)
+                    __root->_M_parent = nullptr;
+                _M_impl._M_reset();
+                return __root;
+            }
+
+            _Base_ptr _M_join(_Base_ptr __a,_Base_ptr __b);
+
+            template <typename _Treap_type>
+            friend struct _Treap_set_algebra;
+
+            size_type _M_count_less(const key_type& __k) const;
+
+            void _M_destroy_values(_Link_type __x);
+
+            void _M_erase_all() { _M_erase_all(_Treap_bulk_release<_Node_allocator>()); }
+
+            void _M_erase_all(std::false_type) { _M_erase(_M_begin()); }
+
+            void _M_erase_all(std::true_type) {
+                if (!_M_get_Node_allocator()._M_is_sole_owner()) {
+                    _M_erase(_M_begin());
+                    return;
+                }
+                // the nodes inside a compact() block are counted off with the block
+                _M_stat_deallocation(size() - _M_impl._M_block_live);
+                if (!std::is_trivially_destructible<_Val>::value)
+                    _M_destroy_values(_M_begin());
+                _M_get_Node_allocator()._M_release_all();
+                if (_M_impl._M_block != nullptr)
+                    _M_release_block();
+            }
+
+            template <typename _InputIterator>
+            void _M_append_sorted(_InputIterator& __first,_InputIterator __last);
+
+            unsigned int _M_draw_priority(_Const_Base_ptr __z) { return _M_impl._M_priority_gen(_S_key(__z)); }
+
+            static unsigned int _S_clamp_priority(unsigned int __p) { return __p == MAX_PRIORITY ? MAX_PRIORITY - 1 : __p; }
+
+            /*
+             * @brief the position is found before __v is moved into a node,a duplicate leaves __v as it was
+             */
+            template <typename _Arg>
+            std::pair<iterator,bool> _M_insert_unique_with_priority(unsigned int __p,_Arg&& __v) {
+                unsigned int __dir;
+                std::pair<_Base_ptr,bool> __pos = _M_get_insert_unique_pos(_KeyOfValue()(__v),__dir);
+                if (!__pos.second)
+                    return std::make_pair(iterator(__pos.first),false);
+                _Link_type __z = _M_create_node(std::forward<_Arg>(__v));
+                _M_insert_node_at(__pos.first,__dir,__z,_S_clamp_priority(__p));
+                return std::make_pair(iterator(__z),true);
+            }
+
+            /*
+             * @brief first node below __x whose key is not less than __k,__y if there is none
+             */
+            template <typename _Kt>
+            _Base_ptr _M_lower_bound(_Const_Base_ptr __x,_Const_Base_ptr __y,const _Kt& __k) const {
+                unsigned int __steps = 0;
+                for (; __x != nullptr; ++__steps) {
+                    if (!_M_impl._M_key_compare(_S_key(__x),__k)) {
+                        __y = __x;
+                        __x = __x->_M_children[Direction_Left];
+                    }
+                    else
+                        __x = __x->_M_children[Direction_Right];
+                }
+                _M_stat_search(__steps);
+                return const_cast<_Base_ptr>(__y);
+            }
+
+            /*
+             * @brief first node below __x whose key is greater than __k,__y if there is none
+             */
+            template <typename _Kt>
+            _Base_ptr _M_upper_bound(_Const_Base_ptr __x,_Const_Base_ptr __y,const _Kt& __k) const {
+                unsigned int __steps = 0;
+                for (; __x != nullptr; ++__steps) {
+                    if (_M_impl._M_key_compare(__k,_S_key(__x))) {
+                        __y = __x;
+                        __x = __x->_M_children[Direction_Left];
+                    }
+                    else
+                        __x = __x->_M_children[Direction_Right];
+                }
+                _M_stat_search(__steps);
+                return const_cast<_Base_ptr>(__y);
+            }
+
+            template <typename _Kt>
+            _Base_ptr _M_find(const _Kt& __k) const {
+                _Base_ptr __j = _M_lower_bound(_M_root(),_M_end(),__k);
+                return (__j == _M_end() || _M_impl._M_key_compare(__k,_S_key(__j))) ? const_cast<_Base_ptr>(_M_end()) : __j;
+            }
+
+            /*
+             * @brief lowest ancestor of __h whose subtree holds the position marked out by __before
+             * @param __h a node of this Treap,not the header
+             * @param __before tells whether the position lies before a given node,monotone in key order
+             * @param __lo,__hi set to the ancestor the climb stopped at,on the side of the position it lies;
+             *        the other one is left as nullptr or the header
+             *
+             * The climb stops at the first ancestor on the far side of the position,so a position
+             * d elements away from __h is reached in O(log d) expected steps instead of O(log n).
+             */
+            template <typename _Pred>
+            _Base_ptr _M_finger_subtree(_Const_Base_ptr __h,_Pred __before,_Base_ptr& __lo,_Base_ptr& __hi) const {
+                __lo = nullptr;
+                __hi = const_cast<_Base_ptr>(_M_end());
+                const bool __is_before = __before(__h);
+                _Const_Base_ptr __x = __h;
+                for (_Const_Base_ptr __p = __x->_M_parent; __p != _M_end(); __x = __p,__p = __p->_M_parent) {
+                    if (__is_before) {
+                        if (__p->_M_children[Direction_Right] == __x && !__before(__p)) {
+                            __lo = const_cast<_Base_ptr>(__p);
+                            break;
+                        }
+                    }
+                    else if (__p->_M_children[Direction_Left] == __x && __before(__p)) {
+                        __hi = const_cast<_Base_ptr>(__p);
+                        break;
+                    }
+                }
+                return const_cast<_Base_ptr>(__x);
+            }
+
+            template <typename _Kt>
+            range_type _M_range(const _Kt& __lo,const _Kt& __hi) const {
+                _Const_Base_ptr __last = _M_lower_bound(_M_root(),_M_end(),__hi);
+                if (!_M_impl._M_key_compare(__lo,__hi))
+                    return range_type(__last,__last,_M_impl._M_key_compare);
+                return range_type(_M_lower_bound(_M_root(),_M_end(),__lo),__last,_M_impl._M_key_compare);
+            }
+
+            /*
+             * @brief the reverse view starts before lower_bound(__hi) and stops before lower_bound(__lo)
+             */
+            template <typename _Kt>
+            reverse_range_type _M_reverse_range(const _Kt& __lo,const _Kt& __hi) const {
+                _Const_Base_ptr __last = _M_before_node(_M_lower_bound(_M_root(),_M_end(),__lo));
+                if (!_M_impl._M_key_compare(__lo,__hi))
+                    return reverse_range_type(__last,__last,_M_impl._M_key_compare);
+                return reverse_range_type(_M_before_node(_M_lower_bound(_M_root(),_M_end(),__hi)),__last,_M_impl._M_key_compare);
+            }
+
+            /*
+             * @brief in-order predecessor of __x,the header for the leftmost node
+             */
+            _Const_Base_ptr _M_before_node(_Const_Base_ptr __x) const {
+                return __x == _M_impl._M_header._M_children[Direction_Left] ? _M_end() : treap_decrement(__x);
+            }
+
+            /*
+             * @brief _M_lower_bound() of the whole Treap,searched from __h instead of the root
+             */
+            _Base_ptr _M_lower_bound_from(_Const_Base_ptr __h,const key_type& __k) const {
+                if (_M_root() == nullptr)
+                    return const_cast<_Base_ptr>(_M_end());
+                if (__h == _M_end()) {
+                    __h = _M_rightmost();
+                    if (_M_impl._M_key_compare(_S_key(__h),__k))
+                        return const_cast<_Base_ptr>(_M_end());
+                }
+                _Base_ptr __lo,__hi;
+                _Base_ptr __x = _M_finger_subtree(__h,[this,&__k](_Const_Base_ptr __y) { return !_M_impl._M_key_compare(_S_key(__y),__k); },__lo,__hi);
+                return _M_lower_bound(__x,__hi,__k);
+            }
+
+            static const unsigned int _S_batch_lanes = 16;
+
+            /*
+             * @brief _M_lower_bound() for every key in [__first,__last),_S_batch_lanes searches at a time
+             * @param __f called as __f(node,key iterator) for each key,in input order
+             *
+             * The searches of a group move down one level per round,and each child is prefetched a
+             * round before it is compared against,so the cache misses of all lanes overlap.
+             */
+            template <typename _ForwardIterator,typename _Function>
+            void _M_lower_bound_batch(_ForwardIterator __first,_ForwardIterator __last,_Function __f) const {
+                _Const_Base_ptr __x[_S_batch_lanes];
+                _Const_Base_ptr __y[_S_batch_lanes];
+                _ForwardIterator __k[_S_batch_lanes];
+                while (__first != __last) {
+                    unsigned int __n = 0;
+                    for (; __n < _S_batch_lanes && __first != __last; ++__n,++__first) {
+                        __x[__n] = _M_root();
+                        __y[__n] = _M_end();
+                        __k[__n] = __first;
+                    }
+                    for (bool __active = true; __active;) {
+                        __active = false;
+                        for (unsigned int __i = 0; __i < __n; ++__i) {
+                            if (__x[__i] == nullptr)
+                                continue;
+                            if (!_M_impl._M_key_compare(_S_key(__x[__i]),*__k[__i])) {
+                                __y[__i] = __x[__i];
+                                __x[__i] = __x[__i]->_M_children[Direction_Left];
+                            }
+                            else
+                                __x[__i] = __x[__i]->_M_children[Direction_Right];
+                            if (__x[__i] != nullptr) {
+                                _M_prefetch(__x[__i]);
+                                __active = true;
+                            }
+                        }
+                    }
+                    for (unsigned int __i = 0; __i < __n; ++__i)
+                        __f(const_cast<_Base_ptr>(__y[__i]),__k[__i]);
+                }
+            }
+
+            /*
+             * @brief where a node with key __k would be linked,in one descent with one comparison per level
+             * @param __dir set to the free child slot of the returned parent
+             * @return (node holding an equivalent key,false),or (parent of the new leaf,true);
+             *         the parent is the header for an empty Treap
+             */
+            std::pair<_Base_ptr,bool> _M_get_insert_unique_pos(const key_type& __k,unsigned int& __dir) {
+                return _M_get_insert_unique_pos(_M_root(),nullptr,__k,__dir);
+            }
+
+            /*
+             * @brief same,descending from __x only
+             * @param __j greatest node known not to be greater than __k,nullptr if there is none
+             */
+            std::pair<_Base_ptr,bool> _M_get_insert_unique_pos(_Base_ptr __x,_Base_ptr __j,const key_type& __k,unsigned int& __dir);
+
+            /*
+             * @brief _M_get_insert_unique_pos() starting from the hint __h
+             *
+             * A key past _M_rightmost() is placed without any descent,otherwise the search climbs
+             * from __h with _M_finger_subtree() and descends from there.
+             */
+            std::pair<_Base_ptr,bool> _M_get_insert_hint_unique_pos(_Base_ptr __h,const key_type& __k,unsigned int& __dir);
+
+            /*
+             * @brief leaf position for a key equivalent to __k,after any equivalent element,searched from __h
+             */
+            _Base_ptr _M_get_insert_hint_equal_pos(_Base_ptr __h,const key_type& __k,unsigned int& __dir);
+
+            /*
+             * @brief link __z as the __dir child of leaf position __p,then rotate it up by priority
+             */
+            void _M_insert_node_at(_Base_ptr __p,unsigned int __dir,_Base_ptr __z) { _M_insert_node_at(__p,__dir,__z,_M_draw_priority(__z)); }
+
+            void _M_insert_node_at(_Base_ptr __p,unsigned int __dir,_Base_ptr __z,unsigned int __priority);
+
+        public :
+            _Treap() {}
+
+            _Treap(const _Compare& __comp,const allocator_type& __a = allocator_type(),const _PriorityGen& __gen = _PriorityGen())
+            : _M_impl(__comp,_Node_allocator(__a),__gen) {}
+
+            _Treap(const _Treap& __x)
+            : _M_impl(__x._M_impl._M_key_compare,_Alloc_traits::_S_select_on_copy(__x._M_get_Node_allocator()),_M_fork_priority(__x._M_impl._M_priority_gen,0)) {
+                if (__x._M_root() != nullptr) {
+                    _M_root() = _M_copy(__x._M_begin(),_M_end());
+                    _M_leftmost() = _S_minimum(_M_root());
+                    _M_rightmost() = _S_maximum(_M_root());
+                }
+            }
+
+            /*
+             * @brief Builds a Treap from [__first,__last),in O(n) when the range is already sorted
+             */
+            template <typename _InputIterator>
+            _Treap(_InputIterator __first,_InputIterator __last,const _Compare& __comp = _Compare(),const allocator_type& __a = allocator_type(),
+                   const _PriorityGen& __gen = _PriorityGen())
+            : _M_impl(__comp,_Node_allocator(__a),__gen) {
+                assign_sorted(__first,__last);
+            }
+
+            /*
+             * @brief O(1),the nodes and any compact() block of __x change owner
+             */
+            _Treap(_Treap&& __x) noexcept(std::is_nothrow_copy_constructible<_Compare>::value && std::is_nothrow_copy_constructible<_PriorityGen>::value)
+            : _M_impl(__x._M_impl._M_key_compare,std::move(__x._M_get_Node_allocator()),_M_fork_priority(__x._M_impl._M_priority_gen,0)) {
+                if (__x._M_root() != nullptr)
+                    _M_move_data(__x,std::true_type());
+            }
+
+            /*
+             * @brief O(1) if __a compares equal to the allocator of __x,else the elements are moved one by one
+             */
+            _Treap(_Treap&& __x,const allocator_type& __a)
+            : _M_impl(__x._M_impl._M_key_compare,_Node_allocator(__a),_M_fork_priority(__x._M_impl._M_priority_gen,0)) {
+                if (__x._M_root() != nullptr)
+                    _M_move_data(__x,std::integral_constant<bool,_Alloc_traits::_S_always_equal()>());
+            }
+
+            ~_Treap() { _M_erase_all(); }
+
+        /*
+         * @brief copy of __x built in the nodes this Treap already owns,allocating only when __x is larger
+         */
+        _Treap& operator = (const _Treap& __x);
+
+        _Treap& operator = (_Treap&& __x) noexcept(_Alloc_traits::_S_nothrow_move() && std::is_nothrow_move_assignable<_Compare>::value
+                                                   && std::is_nothrow_move_assignable<_PriorityGen>::value) {
+            _M_impl._M_key_compare = std::move(__x._M_impl._M_key_compare);
+            _M_impl._M_priority_gen = _M_fork_priority(__x._M_impl._M_priority_gen,0);
+            _M_move_assign(__x,std::integral_constant<bool,_Alloc_traits::_S_nothrow_move()>());
+            return *this;
+        }
+
+        /*
+         * @brief O(1) exchange of contents,comparators,priority generators and (if they propagate) allocators
+         */
+        void swap(_Treap& __x) noexcept;
+
+        iterator begin() { return iterator(this->_M_impl._M_header._M_children[Direction_Left]); }
+
+        const_iterator begin() const { return const_iterator(this->_M_impl._M_header._M_children[Direction_Left]);}
+
+        iterator end() { return iterator(&this->_M_impl._M_header); }
+
+        const_iterator end() const { return const_iterator(&this->_M_impl._M_header); }
+
+        size_type size() const { return _M_root() == nullptr ? 0 : _M_root()->_M_size; }
+
+        /*
+         * @brief the element at in-order position __k (0-based) in O(log n),end() if __k >= size()
+         */
+        iterator find_by_order(size_type __k) {
+            _Base_ptr __x = _M_node_select(_M_root(),__k);
+            return __x == nullptr ? end() : iterator(__x);
+        }
+
+        const_iterator find_by_order(size_type __k) const {
+            _Base_ptr __x = _M_node_select(const_cast<_Base_ptr>(_M_root()),__k);
+            return __x == nullptr ? end() : const_iterator(__x);
+        }
+
+        /*
+         * @brief number of elements strictly less than __k in O(log n)
+         */
+        size_type order_of_key(const key_type& __k) const { return _M_count_less(__k); }
+
+        /*
+         * @brief number of elements in [__lo,__hi) in O(log n)
+         */
+        size_type count_range(const key_type& __lo,const key_type& __hi) const {
+            if (!_M_impl._M_key_compare(__lo,__hi))
+                return 0;
+            return _M_count_less(__hi) - _M_count_less(__lo);
+        }
+
+        /*
+         * @brief ascending view of the elements in [__lo,__hi),or of the whole Treap
+         *
+         * Iterating the view uses _Treap_scan_cursor,faster than const_iterator and free of allocation.
+         */
+        range_type range() const { return range_type(_M_impl._M_header._M_children[Direction_Left],_M_end(),_M_impl._M_key_compare); }
+
+        range_type range(const key_type& __lo,const key_type& __hi) const { return _M_range(__lo,__hi); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        range_type range(const _Kt& __lo,const _Kt& __hi) const { return _M_range(__lo,__hi); }
+
+        /*
+         * @brief descending view of the elements in [__lo,__hi),or of the whole Treap
+         */
+        reverse_range_type reverse_range() const { return reverse_range_type(_M_impl._M_header._M_children[Direction_Right],_M_end(),_M_impl._M_key_compare); }
+
+        reverse_range_type reverse_range(const key_type& __lo,const key_type& __hi) const { return _M_reverse_range(__lo,__hi); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        reverse_range_type reverse_range(const _Kt& __lo,const _Kt& __hi) const { return _M_reverse_range(__lo,__hi); }
+
+        bool empty() const { return size() == 0; }
+
+        void clear() { _M_erase_all(); _M_impl._M_reset(); }
+
+        /*
+         * @brief lookups in O(log n),the _Kt overloads take part only if _Compare::is_transparent exists
+         */
+        iterator lower_bound(const key_type& __k) { return iterator(_M_lower_bound(_M_root(),_M_end(),__k)); }
+
+        const_iterator lower_bound(const key_type& __k) const { return const_iterator(_M_lower_bound(_M_root(),_M_end(),__k)); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        iterator lower_bound(const _Kt& __k) { return iterator(_M_lower_bound(_M_root(),_M_end(),__k)); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        const_iterator lower_bound(const _Kt& __k) const { return const_iterator(_M_lower_bound(_M_root(),_M_end(),__k)); }
+
+        iterator upper_bound(const key_type& __k) { return iterator(_M_upper_bound(_M_root(),_M_end(),__k)); }
+
+        const_iterator upper_bound(const key_type& __k) const { return const_iterator(_M_upper_bound(_M_root(),_M_end(),__k)); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        iterator upper_bound(const _Kt& __k) { return iterator(_M_upper_bound(_M_root(),_M_end(),__k)); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        const_iterator upper_bound(const _Kt& __k) const { return const_iterator(_M_upper_bound(_M_root(),_M_end(),__k)); }
+
+        iterator find(const key_type& __k) { return iterator(_M_find(__k)); }
+
+        const_iterator find(const key_type& __k) const { return const_iterator(_M_find(__k)); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        iterator find(const _Kt& __k) { return iterator(_M_find(__k)); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        const_iterator find(const _Kt& __k) const { return const_iterator(_M_find(__k)); }
+
+        std::pair<iterator,iterator> equal_range(const key_type& __k) { return std::make_pair(lower_bound(__k),upper_bound(__k)); }
+
+        std::pair<const_iterator,const_iterator> equal_range(const key_type& __k) const { return std::make_pair(lower_bound(__k),upper_bound(__k)); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        std::pair<iterator,iterator> equal_range(const _Kt& __k) { return std::make_pair(lower_bound(__k),upper_bound(__k)); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        std::pair<const_iterator,const_iterator> equal_range(const _Kt& __k) const { return std::make_pair(lower_bound(__k),upper_bound(__k)); }
+
+        /*
+         * @brief number of elements equivalent to __k in O(log n),whatever their multiplicity
+         */
+        size_type count(const key_type& __k) const {
+            std::pair<const_iterator,const_iterator> __r = equal_range(__k);
+            return static_cast<size_type>(TreapTree::distance(__r.first,__r.second));
+        }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        size_type count(const _Kt& __k) const {
+            std::pair<const_iterator,const_iterator> __r = equal_range(__k);
+            return static_cast<size_type>(TreapTree::distance(__r.first,__r.second));
+        }
+
+        bool contains(const key_type& __k) const { return _M_find(__k) != _M_end(); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        bool contains(const _Kt& __k) const { return _M_find(__k) != _M_end(); }
+
+        /*
+         * @brief find() starting at __hint rather than at the root
+         * @param __hint any iterator into this Treap,end() included
+         *
+         * The search climbs from __hint to the lowest ancestor covering __k and descends from there,
+         * O(log d) expected where d is the number of elements between __hint and __k.
+         */
+        iterator find_from(const_iterator __hint,const key_type& __k) {
+            _Base_ptr __j = _M_lower_bound_from(__hint._M_node,__k);
+            return (__j == _M_end() || _M_impl._M_key_compare(__k,_S_key(__j))) ? end() : iterator(__j);
+        }
+
+        const_iterator find_from(const_iterator __hint,const key_type& __k) const {
+            _Base_ptr __j = _M_lower_bound_from(__hint._M_node,__k);
+            return (__j == _M_end() || _M_impl._M_key_compare(__k,_S_key(__j))) ? end() : const_iterator(__j);
+        }
+
+        /*
+         * @brief lower_bound() of every key in [__first,__last),written to __out in input order
+         * @return __out past the last result
+         *
+         * Up to 16 independent searches advance in lockstep with the next node of each prefetched,
+         * so on a Treap larger than the cache the memory latency of the lanes overlaps.
+         */
+        template <typename _ForwardIterator,typename _OutputIterator>
+        _OutputIterator lower_bound_batch(_ForwardIterator __first,_ForwardIterator __last,_OutputIterator __out) {
+            _M_lower_bound_batch(__first,__last,[&__out](_Base_ptr __y,_ForwardIterator) { *__out++ = iterator(__y); });
+            return __out;
+        }
+
+        template <typename _ForwardIterator,typename _OutputIterator>
+        _OutputIterator lower_bound_batch(_ForwardIterator __first,_ForwardIterator __last,_OutputIterator __out) const {
+            _M_lower_bound_batch(__first,__last,[&__out](_Base_ptr __y,_ForwardIterator) { *__out++ = const_iterator(__y); });
+            return __out;
+        }
+
+        /*
+         * @brief find() of every key in [__first,__last),see lower_bound_batch()
+         */
+        template <typename _ForwardIterator,typename _OutputIterator>
+        _OutputIterator find_batch(_ForwardIterator __first,_ForwardIterator __last,_OutputIterator __out) {
+            _M_lower_bound_batch(__first,__last,[this,&__out](_Base_ptr __y,_ForwardIterator __k) {
+                *__out++ = (__y == _M_end() || _M_impl._M_key_compare(*__k,_S_key(__y))) ? end() : iterator(__y);
+            });
+            return __out;
+        }
+
+        template <typename _ForwardIterator,typename _OutputIterator>
+        _OutputIterator find_batch(_ForwardIterator __first,_ForwardIterator __last,_OutputIterator __out) const {
+            _M_lower_bound_batch(__first,__last,[this,&__out](_Base_ptr __y,_ForwardIterator __k) {
+                *__out++ = (__y == _M_end() || _M_impl._M_key_compare(*__k,_S_key(__y))) ? end() : const_iterator(__y);
+            });
+            return __out;
+        }
+
+        /*
+         * @brief Inserts __v unless an element with an equivalent key is present
+         * @return the element with that key,and whether __v was inserted
+         *
+         * The position is found before a node is allocated,so a duplicate costs one descent only.
+         */
+        std::pair<iterator,bool> insert_unique(const value_type& __v) { return _M_emplace_unique_key(_KeyOfValue()(__v),__v); }
+
+        std::pair<iterator,bool> insert_unique(value_type&& __v) {
+            const key_type& __k = _KeyOfValue()(__v);
+            return _M_emplace_unique_key(__k,std::move(__v));
+        }
+
+        /*
+         * @brief Like insert_unique(),but the key can only be known once the element is built
+         *
+         * The node is always allocated and dropped again on a duplicate,prefer insert_unique()
+         * or _M_emplace_unique_key() when the key is at hand.
+         */
+        template <typename... _Args>
+        std::pair<iterator,bool> emplace_unique(_Args&&... __args);
+
+        /*
+         * @brief Builds an element from __args only if no element has a key equivalent to __k
+         * @param __k the key the new element will have
+         */
+        template <typename... _Args>
+        std::pair<iterator,bool> _M_emplace_unique_key(const key_type& __k,_Args&&... __args);
+
+        /*
+         * @brief _M_emplace_unique_key() and emplace_unique() searching from __hint,see emplace_hint()
+         */
+        template <typename... _Args>
+        std::pair<iterator,bool> _M_emplace_hint_unique_key(const_iterator __hint,const key_type& __k,_Args&&... __args);
+
+        template <typename... _Args>
+        std::pair<iterator,bool> emplace_hint_unique(const_iterator __hint,_Args&&... __args);
+
+        /*
+         * @brief Builds and inserts an element into the Treap
+         * @param __args Arguments used to generate the element isntance to be inserted;
+         * @return an iterator that points to the insert element
+         */
+        template <typename... _Args>
+        iterator emplace(_Args&&... __args);
+
+        /*
+         * @brief Like emplace(),but the position is searched from __hint instead of the root
+         * @param __hint an iterator near the new element,end() for keys arriving in ascending order
+         *
+         * A key not less than the last element is appended without any comparison but that one,
+         * else the cost is O(log d) comparisons where d is the rank distance from __hint.
+         * Equivalent elements are still placed after the existing ones,as emplace() does.
+         * Sizes along the path to the root are updated either way,so the gain is in comparisons:
+         * with keys as cheap to compare as integers a plain emplace() is no slower.
+         */
+        template <typename... _Args>
+        iterator emplace_hint(const_iterator __hint,_Args&&... __args);
+
+        /*
+         * @brief Like emplace(),but the node takes priority __p instead of one drawn by _PriorityGen
+         *
+         * With user priorities the Treap is a Cartesian tree:top() is the element of highest
+         * priority.The O(log n) bounds of this and every other operation no longer hold,each costs
+         * O(depth) and the depth reaches n when priorities rise or fall with key order.Values from
+         * MAX_PRIORITY on are lowered to MAX_PRIORITY - 1.
+         */
+        template <typename... _Args>
+        iterator emplace_with_priority(unsigned int __p,_Args&&... __args) {
+            _Link_type __z = _M_create_node(std::forward<_Args>(__args)...);
+            try {
+                _M_insert_equal_node(__z,_S_clamp_priority(__p));
+                return iterator(__z);
+            }
+            catch (...) {
+                _M_drop_node(__z);
+                throw;
+            }
+        }
+
+        /*
+         * @brief Like insert_unique(),with priority __p as in emplace_with_priority()
+         *
+         * O(depth) like emplace_with_priority(),not O(log n),once priorities follow key order.
+         */
+        std::pair<iterator,bool> insert_unique_with_priority(unsigned int __p,const value_type& __v) { return _M_insert_unique_with_priority(__p,__v); }
+
+        std::pair<iterator,bool> insert_unique_with_priority(unsigned int __p,value_type&& __v) { return _M_insert_unique_with_priority(__p,std::move(__v)); }
+
+        /*
+         * @brief the element of highest priority,the root,end() if empty
+         */
+        iterator top() { return _M_root() == nullptr ? end() : iterator(_M_root()); }
+
+        const_iterator top() const { return _M_root() == nullptr ? end() : const_iterator(_M_root()); }
+
+        unsigned int priority(const_iterator __position) const { return __position._M_node->_M_Priority; }
+
+        /*
+         * @brief gives the element at __position priority __p,rotating it up or down in O(depth)
+         *
+         * Iterators stay valid,the in-order sequence is unchanged.The depth is O(log n) expected
+         * only while priorities are independent of key order,see emplace_with_priority().
+         */
+        void update_priority(const_iterator __position,unsigned int __p);
+
+        /*
+         * @brief Removes the element at __position in O(log n)
+         * @return an iterator to the element following the removed one
+         */
+        iterator erase(const_iterator __position) {
+            iterator __result = __position._M_const_cast();
+            ++__result;
+            _M_erase_node(__position._M_const_cast()._M_node);
+            return __result;
+        }
+
+        iterator erase(iterator __position) { return erase(const_iterator(__position)); }
+
+        /*
+         * @brief Removes every element equivalent to __k in O(log n + count)
+         * @return number of elements removed
+         */
+        size_type erase(const key_type& __k);
+
+        /*
+         * @brief Removes [__first,__last) in O(log n + k) for k removed elements
+         * @return __last
+         *
+         * The range is cut out as one subtree by two splits and freed in a single pass.
+         */
+        iterator erase(const_iterator __first,const_iterator __last);
+
+        /*
+         * @brief Removes every element with a key in [__lo,__hi) in O(log n + k)
+         * @return number of elements removed
+         */
+        size_type erase_range(const key_type& __lo,const key_type& __hi);
+
+        /*
+         * @brief Moves every element with a key in [__lo,__hi) into a new Treap in O(log n)
+         *
+         * Lets the cost of destroying a large range be paid elsewhere,e.g. by handing the
+         * result to a reclamation thread.
+         */
+        _Treap extract_range(const key_type& __lo,const key_type& __hi);
+
+        /*
+         * @brief Removes every element for which __pred returns true in O(n),with no allocation
+         * @return number of elements removed
+         *
+         * The tree is flattened and the survivors are relinked along the right spine with their
+         * priorities,in the same pass.Should __pred throw,the elements not yet visited are kept.
+         */
+        template <typename _Predicate>
+        size_type erase_if(_Predicate __pred);
+
+        /*
+         * @brief Unlinks the element at __position in O(log n) and hands its node over
+         *
+         * The node is neither copied nor reallocated,unless it sits in the array laid out by
+         * compact(),which it cannot leave.
+         */
+        node_type extract(const_iterator __position);
+
+        /*
+         * @brief extract() of the first element equivalent to __k,an empty handle if there is none
+         */
+        node_type extract(const key_type& __k) {
+            const_iterator __it = find(__k);
+            return __it == end() ? node_type() : extract(__it);
+        }
+
+        /*
+         * @brief Links the node owned by __nh in O(log n),after the elements with an equivalent key
+         * @param __nh a handle from a Treap whose allocator compares equal to ours
+         * @return the inserted element,end() if __nh is empty
+         */
+        iterator insert(node_type&& __nh);
+
+        /*
+         * @brief insert() searching the position from __hint,see emplace_hint()
+         */
+        iterator insert(const_iterator __hint,node_type&& __nh);
+
+        /*
+         * @brief Links the node owned by __nh unless an element with an equivalent key is present
+         * @return the element with that key,whether the node was linked,and the node if it was not
+         */
+        insert_return_type insert_unique(node_type&& __nh);
+
+        /*
+         * @brief Moves the elements [__first,__last) of __x into this Treap
+         *
+         * With equal allocators [__first,__last) is cut out of __x by two splits and the remaining
+         * parts are concatenated again,then the cut is merged into this Treap:O(log n) when its
+         * keys all order after (or all before) ours,as merge().No node is allocated or freed,only a
+         * compact() array of __x is given up first.With unequal allocators every element is moved
+         * into a new node instead.
+         */
+        void splice(_Treap& __x,const_iterator __first,const_iterator __last);
+
+        /*
+         * @brief Like splice(),but an element whose key is already present here stays in __x
+         *
+         * Only when the keys of the cut interleave with ours are its nodes linked one by one.
+         */
+        void splice_unique(_Treap& __x,const_iterator __first,const_iterator __last);
+
+        /*
+         * @brief Moves every element not less than __k into a new Treap in O(log n)
+         * @param __k split key
+         * @return a Treap holding the elements that were in [lower_bound(__k),end())
+         *
+         * No element is copied or reallocated,iterators to moved elements stay valid
+         * and now refer into the returned Treap.
+         */
+        _Treap split(const key_type& __k);
+
+        /*
+         * @brief Keeps the first __n elements and moves the rest into a new Treap in O(log n)
+         * @param __n number of elements to keep,clamped to size()
+         * @return a Treap holding the elements from position __n onwards
+         */
+        _Treap split_at(size_type __n);
+
+        /*
+         * @brief Concatenates __x into this Treap in O(log n) and leaves __x empty
+         * @param __x a Treap whose elements all order after (or all before) this Treap's elements
+         *
+         * The allocators of both Treaps must compare equal.If the key ranges of the two
+         * Treaps overlap,this falls back to join().
+         */
+        void merge(_Treap& __x);
+
+        void merge(_Treap&& __x) { merge(__x); }
+
+        /*
+         * @brief Moves every element of __x into this Treap and leaves __x empty
+         * @param __x a Treap with arbitrary keys,its allocator must compare equal to ours
+         *
+         * Unlike merge() the key ranges may interleave,the cost is O(m log(n/m + 1))
+         * where m is the size of the smaller Treap.
+         */
+        void join(_Treap& __x);
+
+        void join(_Treap&& __x) { join(__x); }
+
+        /*
+         * @brief Replaces the contents with [__first,__last) using a linear Cartesian-tree build
+         * @param __first,__last a range sorted by the Treap's comparator
+         *
+         * Elements are appended along the right spine,so a sorted range costs O(n) in total.
+         * Should the range turn out not to be sorted,the remaining elements are inserted one by one.
+         */
+        template <typename _InputIterator>
+        void assign_sorted(_InputIterator __first,_InputIterator __last);
+
+        /*
+         * @brief Like assign_sorted(),but builds __nthreads disjoint chunks concurrently and merges them
+         * @param __nthreads number of worker threads,0 picks std::thread::hardware_concurrency()
+         *
+         * The allocator must be safe to use from several threads at once.
+         */
+        template <typename _RandomAccessIterator>
+        void assign_sorted_parallel(_RandomAccessIterator __first,_RandomAccessIterator __last,unsigned int __nthreads = 0);
+
+        /*
+         * @brief Moves every node into one contiguous array laid out in van Emde Boas order
+         *
+         * Meant for a Treap that is read-mostly from now on:a lookup then touches O(log n / log B)
+         * cache lines of B nodes instead of one per level.Costs O(n log log n) and invalidates every
+         * iterator,the Treap itself stays fully usable.Nodes inserted later get an allocation of their
+         * own,erased ones leave their slot unused until the whole array is released.Elements that move
+         * to another Treap through split(),split_at(),merge(),join() or the set algebra first get their
+         * own allocations back,except when the receiving Treap is empty.
+         */
+        void compact() {
+            if (_M_root() != nullptr)
+                _M_relocate(true);
+        }
+
+        /*
+         * @brief checks every structural invariant in O(n) without recursion,as _Rb_tree::__rb_verify()
+         * @return false on the first broken one:parent links,subtree sizes,heap order of the priorities,
+         *         key order,the header's root/leftmost/rightmost links or the count of nodes in the block
+         */
+        bool __treap_verify() const;
+
+        /*
+         * @brief number of nodes at every depth,the root being at depth 0,so size() of the result is the height
+         *
+         * Walked through the parent links in O(n) and available whatever _Treap_Stats says;a healthy
+         * Treap of n elements has its mean depth near 2 ln n.
+         */
+        std::vector<size_type> depth_histogram() const;
+    };
+
+
+    /*
+     * @brief link __z below the leaf position chosen by key,then rotate it up by priority
+     * @param __z node to be inserted,its value must already be constructed
+     * @param __priority heap order of __z,below MAX_PRIORITY
+     *
+     * Every node on the descent path gains one element,so sizes are bumped on the way
+     * down and each rotation only has to refresh the two nodes it moves.
+     *
+     * __z is taken as _Base_ptr on purpose:with the node also accessed as _Link_type,GCC 12.2
+     * at -O2 kept __z->_M_parent in a register across _M_rotate and never left the loop.
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_insert_equal_node(_Base_ptr __z,unsigned int __priority) {
+        __z->_M_initialize();
+        __z->_M_Priority = __priority;
 
-            //template <typename _Arg,typename _NodeGen>
-            //iterator _M_insert(_Base_ptr __x,_Base_ptr __y,_Args&& __v,_NodeGen);
+        _Base_ptr __x = _M_root();
+        if (__x == nullptr) {
+            __z->_M_parent = _M_end();
+            _M_root() = __z;
+            _M_leftmost() = __z;
+            _M_rightmost() = __z;
+            return;
+        }
 
-            //iterator _M_insert_node(_Base_ptr __x,_Base_ptr __y,_Link_type __z);
+        bool __is_leftmost = true,__is_rightmost = true;
+        unsigned int __dir,__steps = 0;
+        for (;; ++__steps) {
+            ++__x->_M_size;
+            __dir = _M_impl._M_key_compare(_S_key(__z),_S_key(__x)) ? Direction_Left : Direction_Right;
+            if (__dir == Direction_Left)
+                __is_rightmost = false;
+            else
+                __is_leftmost = false;
+            if (__x->_M_children[__dir] == nullptr)
+                break;
+            __x = __x->_M_children[__dir];
+        }
+        _M_stat_search(__steps + 1);
+
+        __x->_M_children[__dir] = __z;
+        __z->_M_parent = __x;
+        if (__is_leftmost)
+            _M_leftmost() = __z;
+        if (__is_rightmost)
+            _M_rightmost() = __z;
+
+        _Base_ptr __p;
+        while ((__p = __z->_M_parent) != _M_end() && __p->_M_Priority < __z->_M_Priority)
+            _M_rotate(__p,__p->_M_children[Direction_Left] == __z ? Direction_Right : Direction_Left,_M_impl._M_header);
+    }
 
-            template <typename _NodeGen>
-            _Link_type _M_copy(_Const_Link_type __x,_Base_ptr __p,_NodeGen&);
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    std::pair<typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_Base_ptr,bool>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_get_insert_unique_pos(_Base_ptr __x,_Base_ptr __j,const key_type& __k,unsigned int& __dir) {
+        _Base_ptr __p = _M_end();
+        __dir = Direction_Left;
+        unsigned int __steps = 0;
+        for (; __x != nullptr; ++__steps) {
+            __p = __x;
+            __dir = _M_impl._M_key_compare(__k,_S_key(__x)) ? Direction_Left : Direction_Right;
+            if (__dir == Direction_Right)
+                __j = __x;
+            __x = __x->_M_children[__dir];
+        }
+        _M_stat_search(__steps);
+        // __j is the greatest node not greater than __k,it is equivalent unless it is less
+        if (__j != nullptr && !_M_impl._M_key_compare(_S_key(__j),__k))
+            return std::make_pair(__j,false);
+        return std::make_pair(__p,true);
+    }
 
-            _Link_type _M_copy(_Const_Link_type __x,_Base_ptr __p) {
-                _Alloc_node __an(*this);
-                return _M_copy(__x,__p,__an);
-            }
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    std::pair<typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_Base_ptr,bool>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_get_insert_hint_unique_pos(_Base_ptr __h,const key_type& __k,unsigned int& __dir) {
+        if (_M_root() == nullptr)
+            return _M_get_insert_unique_pos(__k,__dir);
+        if (_M_impl._M_key_compare(_S_key(_M_rightmost()),__k)) {
+            __dir = Direction_Right;
+            return std::make_pair(_M_rightmost(),true);
+        }
+        if (__h == _M_end())
+            __h = _M_rightmost();
+        _Base_ptr __lo,__hi;
+        _Base_ptr __x = _M_finger_subtree(__h,[this,&__k](_Const_Base_ptr __y) { return _M_impl._M_key_compare(__k,_S_key(__y)); },__lo,__hi);
+        return _M_get_insert_unique_pos(__x,__lo,__k,__dir);
+    }
 
-            //iterator _M_lower_bound(_Link_type __x,_Base_ptr __y,const _Key& __k);
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_Base_ptr
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_get_insert_hint_equal_pos(_Base_ptr __h,const key_type& __k,unsigned int& __dir) {
+        __dir = Direction_Right;
+        if (_M_root() == nullptr)
+            return _M_end();
+        if (!_M_impl._M_key_compare(__k,_S_key(_M_rightmost())))
+            return _M_rightmost();
+        if (__h == _M_end())
+            __h = _M_rightmost();
+        _Base_ptr __lo,__hi;
+        _Base_ptr __x = _M_finger_subtree(__h,[this,&__k](_Const_Base_ptr __y) { return _M_impl._M_key_compare(__k,_S_key(__y)); },__lo,__hi);
+        _Base_ptr __p;
+        unsigned int __steps = 0;
+        do {
+            __p = __x;
+            __dir = _M_impl._M_key_compare(__k,_S_key(__x)) ? Direction_Left : Direction_Right;
+            __x = __x->_M_children[__dir];
+            ++__steps;
+        } while (__x != nullptr);
+        _M_stat_search(__steps);
+        return __p;
+    }
 
-            //const_iterator _M_lower_bound(_Const_Link_type __x,_Const_Base_Ptr __y,const _Key& __k) const;
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_insert_node_at(_Base_ptr __p,unsigned int __dir,_Base_ptr __z,unsigned int __priority) {
+        __z->_M_initialize();
+        __z->_M_Priority = __priority;
 
-            //iterator _M_upper_bound(_Link_type __x,_Base_ptr __y,const _Key& __k);
+        if (__p == _M_end()) {
+            __z->_M_parent = _M_end();
+            _M_root() = __z;
+            _M_leftmost() = __z;
+            _M_rightmost() = __z;
+            return;
+        }
 
-            //const_iterator _M_upper_bound(_Const_Link_type __x,_Const_Base_ptr __y,const _Key& __k) const;
+        __p->_M_children[__dir] = __z;
+        __z->_M_parent = __p;
+        if (__dir == Direction_Left && __p == _M_leftmost())
+            _M_leftmost() = __z;
+        else if (__dir == Direction_Right && __p == _M_rightmost())
+            _M_rightmost() = __z;
+        for (_Base_ptr __x = __p; __x != _M_end(); __x = __x->_M_parent)
+            ++__x->_M_size;
+
+        while ((__p = __z->_M_parent) != _M_end() && __p->_M_Priority < __z->_M_Priority)
+            _M_rotate(__p,__p->_M_children[Direction_Left] == __z ? Direction_Right : Direction_Left,_M_impl._M_header);
+    }
 
-        public :
-            _Treap() {}
-            _Treap(const _Treap& __x) : _M_impl(__x._M_impl._M_key_compare,_Alloc_traits::_S_select_on_copy(__x._M_get_Node_allocator())) {
-                if (__x._M_root() != nullptr) {
-                    _M_root() = _M_copy(__x._M_begin(),_M_end());
-                    _M_leftmost() = _S_minimum(_M_rooot());
-                    _M_rightmost() = _S_maximum(_M_root());
-                }
-            }
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::update_priority(const_iterator __position,unsigned int __p) {
+        _Base_ptr __z = __position._M_const_cast()._M_node;
+        const unsigned int __old = __z->_M_Priority;
+        __z->_M_Priority = __p = _S_clamp_priority(__p);
 
-            _Treap(_Treap&& __x) : _M_impl(__x._M_impl._M_keycompre,std::move(__x._M_get_Node_allocator())) {
-                if (__x._M_root() != nullptr) 
-                    _M_move_data(__x,std::true_type());
+        _Base_ptr __q;
+        if (__p > __old) {
+            while ((__q = __z->_M_parent) != _M_end() && __q->_M_Priority < __p)
+                _M_rotate(__q,__q->_M_children[Direction_Left] == __z ? Direction_Right : Direction_Left,_M_impl._M_header);
+            return;
+        }
+        // the child of higher priority moves above __z until neither outranks it
+        for (;;) {
+            _Base_ptr __l = __z->_M_children[Direction_Left];
+            _Base_ptr __r = __z->_M_children[Direction_Right];
+            if (__l != nullptr && (__r == nullptr || __r->_M_Priority <= __l->_M_Priority)) {
+                if (__l->_M_Priority <= __p)
+                    break;
+                _M_rotate(__z,Direction_Right,_M_impl._M_header);
             }
+            else if (__r != nullptr && __r->_M_Priority > __p)
+                _M_rotate(__z,Direction_Left,_M_impl._M_header);
+            else
+                break;
+        }
+    }
 
-            ~_Treap() { _M_erase(_M_begin()); }
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename... _Args>
+    std::pair<typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::iterator,bool>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_emplace_unique_key(const key_type& __k,_Args&&... __args) {
+        unsigned int __dir;
+        std::pair<_Base_ptr,bool> __pos = _M_get_insert_unique_pos(__k,__dir);
+        if (!__pos.second)
+            return std::make_pair(iterator(__pos.first),false);
 
-        _Treap& operator = (const _Treap& __x);
+        _Link_type __z = _M_create_node(std::forward<_Args>(__args)...);
+        _M_insert_node_at(__pos.first,__dir,__z);
+        return std::make_pair(iterator(__z),true);
+    }
 
-        iterator begin() { return iterator(this->_M_impl._M_header._M_children[Direction_Left]); }
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename... _Args>
+    std::pair<typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::iterator,bool>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::emplace_unique(_Args&&... __args) {
+        _Link_type __z = _M_create_node(std::forward<_Args>(__args)...);
+        unsigned int __dir;
+        std::pair<_Base_ptr,bool> __pos;
+        try {
+            __pos = _M_get_insert_unique_pos(_S_key(__z),__dir);
+        }
+        catch (...) {
+            _M_drop_node(__z);
+            throw;
+        }
+        if (!__pos.second) {
+            _M_drop_node(__z);
+            return std::make_pair(iterator(__pos.first),false);
+        }
+        _M_insert_node_at(__pos.first,__dir,__z);
+        return std::make_pair(iterator(__z),true);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename... _Args>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::iterator
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::emplace(_Args&&... __args) {
+        _Link_type __z = _M_create_node(std::forward<_Args>(__args)...);
+        try {
+            _M_insert_equal_node(__z);
+            return iterator(__z);
+        }
+        catch (...) {
+            _M_drop_node(__z);
+            throw;
+        }
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename... _Args>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::iterator
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::emplace_hint(const_iterator __hint,_Args&&... __args) {
+        _Link_type __z = _M_create_node(std::forward<_Args>(__args)...);
+        try {
+            unsigned int __dir;
+            _Base_ptr __p = _M_get_insert_hint_equal_pos(__hint._M_const_cast()._M_node,_S_key(__z),__dir);
+            _M_insert_node_at(__p,__dir,__z);
+            return iterator(__z);
+        }
+        catch (...) {
+            _M_drop_node(__z);
+            throw;
+        }
+    }
 
-        const_iterator begin() const { return const_iterator(this->_M_impl._M_header->_M_children[Direction_Left]);}
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename... _Args>
+    std::pair<typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::iterator,bool>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_emplace_hint_unique_key(const_iterator __hint,const key_type& __k,_Args&&... __args) {
+        unsigned int __dir;
+        std::pair<_Base_ptr,bool> __pos = _M_get_insert_hint_unique_pos(__hint._M_const_cast()._M_node,__k,__dir);
+        if (!__pos.second)
+            return std::make_pair(iterator(__pos.first),false);
 
-        iteraotr end() { return iterator(&this->_M_impl._M_header); }
+        _Link_type __z = _M_create_node(std::forward<_Args>(__args)...);
+        _M_insert_node_at(__pos.first,__dir,__z);
+        return std::make_pair(iterator(__z),true);
+    }
 
-        const_iterator end() const { return const_iterator(&this->_M_impl._M_header); }
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename... _Args>
+    std::pair<typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::iterator,bool>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::emplace_hint_unique(const_iterator __hint,_Args&&... __args) {
+        _Link_type __z = _M_create_node(std::forward<_Args>(__args)...);
+        unsigned int __dir;
+        std::pair<_Base_ptr,bool> __pos;
+        try {
+            __pos = _M_get_insert_hint_unique_pos(__hint._M_const_cast()._M_node,_S_key(__z),__dir);
+        }
+        catch (...) {
+            _M_drop_node(__z);
+            throw;
+        }
+        if (!__pos.second) {
+            _M_drop_node(__z);
+            return std::make_pair(iterator(__pos.first),false);
+        }
+        _M_insert_node_at(__pos.first,__dir,__z);
+        return std::make_pair(iterator(__z),true);
+    }
 
-        size_type size() const { return _M_root() == nullptr ? 0 : _M_root()->_M_size; }
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen> _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::split(const key_type& __k) {
+        _Treap __r(_M_impl._M_key_compare,get_allocator(),_M_fork_priority(_M_impl._M_priority_gen,0));
+        _M_thaw();
+        _Base_ptr __lroot,__rroot;
+        _M_split(_M_release_root(),[&](_Base_ptr __x) { return _M_impl._M_key_compare(_S_key(__x),__k); },__lroot,__rroot);
+        _M_set_root(__lroot);
+        __r._M_set_root(__rroot);
+        return __r;
+    }
 
-        bool empty() const { return size() == 0; }
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen> _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::split_at(size_type __n) {
+        _Treap __r(_M_impl._M_key_compare,get_allocator(),_M_fork_priority(_M_impl._M_priority_gen,0));
+        _M_thaw();
+        _Base_ptr __lroot,__rroot;
+        _M_split_rank(_M_release_root(),__n,__lroot,__rroot);
+        _M_set_root(__lroot);
+        __r._M_set_root(__rroot);
+        return __r;
+    }
 
-        void clear() { _M_erase(_M_begin()); _M_impl._M_reset(); }
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::merge(_Treap& __x) {
+        if (this == &__x || __x._M_root() == nullptr)
+            return;
+        if (_M_root() == nullptr) {
+            _M_move_data(__x,std::true_type());
+            return;
+        }
 
-        /*
-         * @brief Builds and inserts an element into the Treap
-         * @param __args Arguments used to generate the element isntance to be inserted;
-         * @return an iterator that points to the insert element
-         */
-        template <typename... _Args>
-        iterator emplace(_Args&&... __args);
+        __x._M_thaw();
+        if (!_M_impl._M_key_compare(_S_key(__x._M_leftmost()),_S_key(_M_rightmost()))) {
+            _Base_ptr __l = _M_release_root();
+            _M_set_root(_M_merge(__l,__x._M_release_root()));
+        }
+        else if (!_M_impl._M_key_compare(_S_key(_M_leftmost()),_S_key(__x._M_rightmost()))) {
+            _Base_ptr __r = _M_release_root();
+            _M_set_root(_M_merge(__x._M_release_root(),__r));
+        }
+        else
+            join(__x);
+    }
 
-        #if defined _Treap_debug
-        /*
-         * @brief output current Treap's structure,contains node's value and priority;
-         */
-        void debug() const { _M_debug(_M_root(),0); }
-        #endif
-    };
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::join(_Treap& __x) {
+        if (this == &__x || __x._M_root() == nullptr)
+            return;
+        __x._M_thaw();
+        _Base_ptr __a = _M_release_root();
+        _M_set_root(_M_join(__a,__x._M_release_root()));
+    }
 
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::size_type
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_count_less(const key_type& __k) const {
+        size_type __n = 0;
+        unsigned int __steps = 0;
+        for (_Const_Base_ptr __x = _M_root(); __x != nullptr; ++__steps) {
+            if (_M_impl._M_key_compare(_S_key(__x),__k)) {
+                __n += _M_subtree_size(__x->_M_children[Direction_Left]) + 1;
+                __x = __x->_M_children[Direction_Right];
+            }
+            else
+                __x = __x->_M_children[Direction_Left];
+        }
+        _M_stat_search(__steps);
+        return __n;
+    }
 
     /*
-     * @param __x pos for new node insert to treap
-     * @param __p __x's parent node
-     * @param __z node to be inserted
-     * @param __dir insert to direction 0->left 1->right
+     * @brief append a sorted run after the current rightmost element
+     * @param __first advanced past every element consumed,stops at the first one out of order
      */
-    template <typename _Key,typename _Compare,typename _Alloc>
-    void _Treap<_Key,_Compare,_Alloc>::_M_insert_equal_node(_Base_ptr __x,_Base_ptr __p,_Link_type __z,unsigned int __dir) {
-        if (__x == nullptr) {
-            __z->_M_initialize();
-            __z->_M_parent = __p;
-            __z->_M_priority = generaterand();
-
-            if (__dir == Direction_Left) {
-                __p->_M_children[Direction_Left] = __z;
-                if (__p == &_M_impl._M_header) {
-                    _M_impl._M_header._M_parent = __z;
-                    _M_impl._M_header._M_children[Direction_Right] = __z;
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename _InputIterator>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_append_sorted(_InputIterator& __first,_InputIterator __last) {
+        _Base_ptr __last_node = _M_root() == nullptr ? nullptr : _M_rightmost();
+        _Base_ptr __root = _M_release_root();
+
+        try {
+            for (; __first != __last; ++__first) {
+                _Link_type __z = _M_create_node(*__first);
+                if (__last_node != nullptr && _M_impl._M_key_compare(_S_key(__z),_S_key(__last_node))) {
+                    _M_drop_node(__z);
+                    break;
                 }
-                else if (__p == _M_impl._M_header._M_chldren[Direction_Left])
-                    _M_impl._M_header._M_children[Direction_Left] = __z;
+                __z->_M_initialize();
+                __z->_M_Priority = _M_draw_priority(__z);
+
+                _M_spine_append(__root,__last_node,__z);
+                __last_node = __z;
             }
         }
-        else {
-            unsigned int dir = _M_impl._M_key_compare(_S_key(__z),_S_key(__x)) ? Direction_Left : Direction_Right;
-            _M_insert_equal_node(__x->_M_children[dir],__x,__z,dir);
-            if (__x->_M_children[dir] && __x->_M_children[dir]->_M_Priority > __x->_M_Priority)
-                _M_rotate(__x,dir ^ 1,_M_impl._M_header);
-            __x->_M_maintain();
+        catch (...) {
+            _M_maintain_path(__last_node);
+            _M_set_root(__root);
+            throw;
         }
+
+        _M_maintain_path(__last_node);
+        _M_set_root(__root);
     }
 
-    template <typename _Key,typename _Comapre,typename _Alloc>
-    template <typename... Args>
-    typename _Treap<_Key,_Compare,_Alloc>::iterator 
-    _Treap<_Key,_Compare,_Alloc>::emplace(_Args&&... __args) {
-        _Link_type __z = _M_create_node(std::forward<_Args>(__args)...);
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename _InputIterator>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::assign_sorted(_InputIterator __first,_InputIterator __last) {
+        clear();
+        _M_append_sorted(__first,__last);
+        for (; __first != __last; ++__first)
+            emplace(*__first);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename _RandomAccessIterator>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::assign_sorted_parallel(_RandomAccessIterator __first,_RandomAccessIterator __last,unsigned int __nthreads) {
+        typedef typename std::iterator_traits<_RandomAccessIterator>::difference_type _Distance;
+
+        if (__nthreads == 0)
+            __nthreads = std::thread::hardware_concurrency();
+        const _Distance __n = __last - __first;
+        const _Distance __min_chunk = 1 << 16;
+        if (__nthreads < 2 || __n < 2 * __min_chunk) {
+            assign_sorted(__first,__last);
+            return;
+        }
+        if (__n / __nthreads < __min_chunk)
+            __nthreads = static_cast<unsigned int>(__n / __min_chunk);
+
+        clear();
+        std::vector<_Treap> __chunks;
+        std::vector<_RandomAccessIterator> __stops(__nthreads);
+        std::vector<std::exception_ptr> __errors(__nthreads);
+        std::vector<std::thread> __workers;
+        __chunks.reserve(__nthreads);
+        __workers.reserve(__nthreads);
+        for (unsigned int __i = 0; __i < __nthreads; ++__i)
+            __chunks.emplace_back(_M_impl._M_key_compare,get_allocator(),_M_fork_priority(_M_impl._M_priority_gen,0));
+
         try {
-            _M_insert_equal_node(_M_root(),&_M_impl._M_header,__z,Direction_Left);
-            return iterator(__z);
+            for (unsigned int __i = 0; __i < __nthreads; ++__i) {
+                _RandomAccessIterator __lo = __first + __n * __i / __nthreads;
+                _RandomAccessIterator __hi = __first + __n * (__i + 1) / __nthreads;
+                __workers.emplace_back([&__chunks,&__stops,&__errors,__i,__lo,__hi]() {
+                    _RandomAccessIterator __it = __lo;
+                    try {
+                        __chunks[__i]._M_append_sorted(__it,__hi);
+                    }
+                    catch (...) {
+                        __errors[__i] = std::current_exception();
+                    }
+                    __stops[__i] = __it;
+                });
+            }
         }
         catch (...) {
-            _M_drop_node(__z);
+            // a thread that failed to start leaves the others running on our locals
+            for (std::thread& __t : __workers)
+                __t.join();
             throw;
         }
+        for (std::thread& __t : __workers)
+            __t.join();
+        for (std::exception_ptr& __e : __errors)
+            if (__e)
+                std::rethrow_exception(__e);
+
+        for (unsigned int __i = 0; __i < __nthreads; ++__i)
+            merge(__chunks[__i]);
+        for (unsigned int __i = 0; __i < __nthreads; ++__i)
+            for (_RandomAccessIterator __it = __stops[__i],__hi = __first + __n * (__i + 1) / __nthreads; __it != __hi; ++__it)
+                emplace(*__it);
     }
 
-    #if defined _Treap_Debug
-    template <typename _Key,typename _Compare,typename _Alloc>
-    void _Treap<_Key,_Compare,_Alloc>::_M_debug(_Const_Base_ptr __curnode,unsigned int __depth) const {
-        if (__curnode == nullptr)
-            return;
-        
-        _Const_Link_type _tmpnode = static_cast<_Const_Link_type>(__curnode);
-        if (!_tmpnode) 
-            return;
-
-        if (__depth == 0) {
-            std::cout << "header's priority: " << _M_impl._M_header._M_Priority << std::endl;
-            std::cout << "header's address: " << std::__addressof(_M_impl._M_header) << std::endl;
-            std::cout << "header's parent" << _M_impl._M_header._M_parent << std::endl;
-            std::cout << "header's leftchild" << _M_impl._M_header._M_children[Direction_Left] << std::endl;
-            std::cout << "header's rightchild" << _M_impl._M_header._M_children[Direction_Right] << std::endl;
+    /*
+     * @brief union of two detached subtrees,the root with the higher priority splits the other one
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_Base_ptr
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_join(_Base_ptr __a,_Base_ptr __b) {
+        if (__a == nullptr)
+            return __b;
+        if (__b == nullptr)
+            return __a;
+        if (__a->_M_Priority < __b->_M_Priority)
+            std::swap(__a,__b);
+
+        _Base_ptr __bl,__br;
+        const _Key& __k = _S_key(__a);
+        _M_split(__b,[&](_Base_ptr __x) { return _M_impl._M_key_compare(_S_key(__x),__k); },__bl,__br);
+
+        for (unsigned int __dir = Direction_Left; __dir <= Direction_Right; ++__dir) {
+            _Base_ptr __child = __a->_M_children[__dir];
+            if (__child != nullptr)
+                __child->_M_parent = nullptr;
+            __child = _M_join(__child,__dir == Direction_Left ? __bl : __br);
+            __a->_M_children[__dir] = __child;
+            if (__child != nullptr)
+                __child->_M_parent = __a;
         }
+        __a->_M_maintain();
+        __a->_M_parent = nullptr;
+        return __a;
+    }
 
-        std::cout << "depth = " << __depth << std::endl;
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    bool _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::__treap_verify() const {
+        _Const_Base_ptr __header = _M_end();
+        if (__header->_M_Priority != MAX_PRIORITY)
+            return false;
+        if (_M_root() == nullptr)
+            return _M_impl._M_header._M_children[Direction_Left] == __header && _M_impl._M_header._M_children[Direction_Right] == __header
+                   && _M_impl._M_block_live == 0;
+        if (_M_root()->_M_parent != __header || _M_impl._M_header._M_children[Direction_Left] != _S_minimum(_M_root())
+            || _M_impl._M_header._M_children[Direction_Right] != _S_maximum(_M_root()))
+            return false;
+
+        size_type __count = 0,__in_block = 0;
+        _Const_Base_ptr __prev = nullptr;
+        for (_Const_Base_ptr __x = _M_impl._M_header._M_children[Direction_Left]; __x != __header; __prev = __x,__x = treap_increment(__x)) {
+            unsigned int __size = 1;
+            for (unsigned int __dir = Direction_Left; __dir <= Direction_Right; ++__dir) {
+                _Const_Base_ptr __c = __x->_M_children[__dir];
+                if (__c == nullptr)
+                    continue;
+                if (__c->_M_parent != __x || __c->_M_Priority > __x->_M_Priority)
+                    return false;
+                __size += __c->_M_size;
+            }
+            if (__x->_M_size != __size || __x->_M_Priority == MAX_PRIORITY)
+                return false;
+            if (__prev != nullptr && _M_impl._M_key_compare(_S_key(__x),_S_key(__prev)))
+                return false;
+            if (_M_in_block(static_cast<_Link_type>(const_cast<_Base_ptr>(__x))))
+                ++__in_block;
+            if (++__count > _M_root()->_M_size)
+                return false;
+        }
+        return __count == _M_root()->_M_size && __in_block == _M_impl._M_block_live;
+    }
 
-        _tmpnode->_M_debug();
-        _M_debug(__curnode->_M_children[Direction_Left],depth + 1);
-        _M_debug(__curnode->_M_children[Direction_Right],depth + 1);
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    std::vector<typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::size_type>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::depth_histogram() const {
+        std::vector<size_type> __hist;
+        size_type __depth = 0;
+        _Const_Base_ptr __x = _M_root();
+        while (__x != nullptr) {
+            if (__hist.size() <= __depth)
+                __hist.resize(__depth + 1);
+            ++__hist[__depth];
+            if (__x->_M_children[Direction_Left] != nullptr || __x->_M_children[Direction_Right] != nullptr) {
+                __x = __x->_M_children[__x->_M_children[Direction_Left] != nullptr ? Direction_Left : Direction_Right];
+                ++__depth;
+                continue;
+            }
+            // climb to the first ancestor whose right subtree is still to be walked
+            for (_Const_Base_ptr __p = __x->_M_parent; ; __x = __p,__p = __p->_M_parent,--__depth) {
+                if (__p == _M_end()) {
+                    __x = nullptr;
+                    break;
+                }
+                if (__p->_M_children[Direction_Left] == __x && __p->_M_children[Direction_Right] != nullptr) {
+                    __x = __p->_M_children[Direction_Right];
+                    break;
+                }
+            }
+        }
+        return __hist;
     }
-    #endif
 
     /*
      * @breif erase without balance
+     *
+     * A left child is rotated above its parent until the current node has none,
+     * which flattens the subtree into a right list without recursion or a stack.
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_erase(_Link_type __x) {
+        while (__x != nullptr) {
+            _Link_type __y = _S_left(__x);
+            if (__y != nullptr) {
+                __x->_M_children[Direction_Left] = __y->_M_children[Direction_Right];
+                __y->_M_children[Direction_Right] = __x;
+                __x = __y;
+            }
+            else {
+                __y = _S_right(__x);
+                _M_drop_node(__x);
+                __x = __y;
+            }
+        }
+    }
+
+    /*
+     * @brief run the value destructors of a subtree but leave the memory to the allocator
      */
-    template <typename _Key,typename _Compare,typename _Alloc>
-    void _Treap<_Key,_Compare,_Alloc>::_M_erase(_Link_type __x) {
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_destroy_values(_Link_type __x) {
         while (__x != nullptr) {
-            _M_erase(_S_right(__x));
             _Link_type __y = _S_left(__x);
-            _M_drop_node(__x);
+            if (__y != nullptr) {
+                __x->_M_children[Direction_Left] = __y->_M_children[Direction_Right];
+                __y->_M_children[Direction_Right] = __x;
+                __x = __y;
+            }
+            else {
+                __y = _S_right(__x);
+                _M_destroy_node(__x);
+                __x = __y;
+            }
+        }
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_relocate(bool __contiguous) {
+        const size_type __n = size();
+        std::vector<_Base_ptr> __order;
+        __order.reserve(__n);
+        _M_veb_order(_M_root(),_M_subtree_height(_M_root()),__order);
+
+        std::vector<_Link_type> __to(__n);
+        _Link_type __block = nullptr;
+        size_type __built = 0,__allocated = 0;
+        try {
+            if (__contiguous) {
+                _M_stat_allocation();
+                __block = _Alloc_traits::allocate(_M_get_Node_allocator(),__n);
+                for (; __allocated < __n; ++__allocated)
+                    __to[__allocated] = __block + __allocated;
+            }
+            else
+                for (; __allocated < __n; ++__allocated)
+                    __to[__allocated] = _M_get_node();
+            for (; __built < __n; ++__built) {
+                ::new(__to[__built]) _Treap_node<_Val>;
+                _Alloc_traits::construct(_M_get_Node_allocator(),__to[__built]->_M_valptr(),std::move_if_noexcept(*static_cast<_Link_type>(__order[__built])->_M_valptr()));
+            }
+        }
+        catch (...) {
+            while (__built > 0)
+                _M_destroy_node(__to[--__built]);
+            if (__contiguous) {
+                if (__block != nullptr)
+                    _Alloc_traits::deallocate(_M_get_Node_allocator(),__block,__n);
+            }
+            else
+                while (__allocated > 0)
+                    _Alloc_traits::deallocate(_M_get_Node_allocator(),__to[--__allocated],1);
+            throw;
+        }
+
+        // the old parent links are no longer needed,they now point at the copies
+        for (size_type __i = 0; __i < __n; ++__i) {
+            __to[__i]->_M_Priority = __order[__i]->_M_Priority;
+            __to[__i]->_M_size = __order[__i]->_M_size;
+            __order[__i]->_M_parent = __to[__i];
+        }
+        for (size_type __i = 0; __i < __n; ++__i)
+            for (unsigned int __dir = Direction_Left; __dir <= Direction_Right; ++__dir) {
+                _Base_ptr __child = __order[__i]->_M_children[__dir];
+                if (__child != nullptr) {
+                    __child = __child->_M_parent;
+                    __child->_M_parent = __to[__i];
+                }
+                __to[__i]->_M_children[__dir] = __child;
+            }
+        __to[0]->_M_parent = _M_end();
+        _M_root() = __to[0];
+        _M_leftmost() = _M_leftmost()->_M_parent;
+        _M_rightmost() = _M_rightmost()->_M_parent;
+
+        for (size_type __i = 0; __i < __n; ++__i)
+            _M_drop_node(static_cast<_Link_type>(__order[__i]));
+        if (__contiguous) {
+            _M_impl._M_block = __block;
+            _M_impl._M_block_nodes = _M_impl._M_block_live = __n;
+        }
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_erase_node(_Base_ptr __x) {
+        _M_unlink_node(__x);
+        _M_drop_node(static_cast<_Link_type>(__x));
+    }
+
+    /*
+     * @brief take __x out of the tree by merging its two subtrees into its place
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_unlink_node(_Base_ptr __x) {
+        if (__x == _M_leftmost())
+            _M_leftmost() = treap_increment(__x);
+        if (__x == _M_rightmost())
+            _M_rightmost() = treap_decrement(__x);
+
+        _Base_ptr __l = __x->_M_children[Direction_Left];
+        _Base_ptr __r = __x->_M_children[Direction_Right];
+        if (__l != nullptr)
+            __l->_M_parent = nullptr;
+        if (__r != nullptr)
+            __r->_M_parent = nullptr;
+        _Base_ptr __child = _M_merge(__l,__r);
+
+        _Base_ptr __p = __x->_M_parent;
+        if (__child != nullptr)
+            __child->_M_parent = __p;
+        if (__p == _M_end())
+            _M_root() = __child;
+        else {
+            __p->_M_children[__p->_M_children[Direction_Left] == __x ? Direction_Left : Direction_Right] = __child;
+            for (; __p != _M_end(); __p = __p->_M_parent)
+                --__p->_M_size;
+        }
+
+        if (_M_root() == nullptr)
+            _M_impl._M_reset();
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::node_type
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::extract(const_iterator __position) {
+        _Link_type __z = static_cast<_Link_type>(__position._M_const_cast()._M_node);
+        if (_M_in_block(__z)) {
+            _Link_type __n = _M_create_node(std::move_if_noexcept(*__z->_M_valptr()));
+            _M_erase_node(__z);
+            __z = __n;
+        }
+        else
+            _M_unlink_node(__z);
+        return node_type(__z,_M_get_Node_allocator());
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::iterator
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::insert(node_type&& __nh) {
+        if (__nh.empty())
+            return end();
+        _Link_type __z = __nh._M_node();
+        _M_insert_equal_node(__z);
+        __nh._M_release();
+        return iterator(__z);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::iterator
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::insert(const_iterator __hint,node_type&& __nh) {
+        if (__nh.empty())
+            return end();
+        _Link_type __z = __nh._M_node();
+        unsigned int __dir;
+        _Base_ptr __p = _M_get_insert_hint_equal_pos(__hint._M_const_cast()._M_node,_S_key(__z),__dir);
+        _M_insert_node_at(__p,__dir,__z);
+        __nh._M_release();
+        return iterator(__z);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::insert_return_type
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::insert_unique(node_type&& __nh) {
+        if (__nh.empty())
+            return insert_return_type{end(),false,node_type()};
+        _Link_type __z = __nh._M_node();
+        unsigned int __dir;
+        std::pair<_Base_ptr,bool> __pos = _M_get_insert_unique_pos(_S_key(__z),__dir);
+        if (!__pos.second)
+            return insert_return_type{iterator(__pos.first),false,std::move(__nh)};
+        _M_insert_node_at(__pos.first,__dir,__z);
+        __nh._M_release();
+        return insert_return_type{iterator(__z),true,node_type()};
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::splice(_Treap& __x,const_iterator __first,const_iterator __last) {
+        if (this == &__x || __first == __last)
+            return;
+        if (!_Alloc_traits::_S_always_equal() && _M_get_Node_allocator() != __x._M_get_Node_allocator()) {
+            while (__first != __last) {
+                emplace(std::move(*__first._M_const_cast()));
+                __first = __x.erase(__first);
+            }
+            return;
+        }
+
+        merge(__x._M_cut(__first,__last));
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::splice_unique(_Treap& __x,const_iterator __first,const_iterator __last) {
+        if (this == &__x || __first == __last)
+            return;
+        if (!_Alloc_traits::_S_always_equal() && _M_get_Node_allocator() != __x._M_get_Node_allocator()) {
+            while (__first != __last) {
+                if (insert_unique(std::move(*__first._M_const_cast())).second)
+                    __first = __x.erase(__first);
+                else
+                    ++__first;
+            }
+            return;
+        }
+
+        _Treap __cut = __x._M_cut(__first,__last);
+        if (_M_root() == nullptr || _M_impl._M_key_compare(_S_key(_M_rightmost()),_S_key(__cut._M_leftmost()))
+            || _M_impl._M_key_compare(_S_key(__cut._M_rightmost()),_S_key(_M_leftmost()))) {
+            merge(__cut);
+            return;
+        }
+        while (__cut._M_root() != nullptr) {
+            insert_return_type __r = insert_unique(__cut.extract(__cut.begin()));
+            if (!__r.inserted)
+                __x.insert(std::move(__r.node));
+        }
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::iterator
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::erase(const_iterator __first,const_iterator __last) {
+        if (__first == begin() && __last == end())
+            clear();
+        else if (__first != __last) {
+            const size_type __lo = _M_node_rank(__first._M_node),__hi = _M_node_rank(__last._M_node);
+            _Base_ptr __lroot,__mroot,__rroot;
+            _M_split_rank(_M_release_root(),__lo,__lroot,__mroot);
+            _M_split_rank(__mroot,__hi - __lo,__mroot,__rroot);
+            _M_set_root(_M_merge(__lroot,__rroot));
+            _M_erase(static_cast<_Link_type>(__mroot));
+        }
+        return __last._M_const_cast();
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::size_type
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::erase_range(const key_type& __lo,const key_type& __hi) {
+        if (!_M_impl._M_key_compare(__lo,__hi))
+            return 0;
+        _Base_ptr __mroot = _M_cut_range(__lo,__hi);
+        size_type __n = _M_subtree_size(__mroot);
+        _M_erase(static_cast<_Link_type>(__mroot));
+        return __n;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen> _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::extract_range(const key_type& __lo,const key_type& __hi) {
+        _Treap __r(_M_impl._M_key_compare,get_allocator(),_M_fork_priority(_M_impl._M_priority_gen,0));
+        if (_M_impl._M_key_compare(__lo,__hi)) {
+            _M_thaw();
+            __r._M_set_root(_M_cut_range(__lo,__hi));
+        }
+        return __r;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename _Predicate>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::size_type
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_rebuild_if(_Base_ptr& __x,_Base_ptr& __root,_Base_ptr& __last,_Predicate& __drop) {
+        size_type __n = 0;
+        while (__x != nullptr) {
+            _Base_ptr __y = __x->_M_children[Direction_Left];
+            if (__y != nullptr) {
+                __x->_M_children[Direction_Left] = __y->_M_children[Direction_Right];
+                __y->_M_children[Direction_Right] = __x;
+                __x = __y;
+                continue;
+            }
+            __y = __x->_M_children[Direction_Right];
+            if (__drop(*static_cast<_Link_type>(__x)->_M_valptr())) {
+                _M_drop_node(static_cast<_Link_type>(__x));
+                ++__n;
+            }
+            else {
+                __x->_M_initialize();
+                _M_spine_append(__root,__last,__x);
+                __last = __x;
+            }
             __x = __y;
         }
+        return __n;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    template <typename _Predicate>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::size_type
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::erase_if(_Predicate __pred) {
+        _Base_ptr __x = _M_release_root();
+        _Base_ptr __root = nullptr,__last = nullptr;
+        size_type __n;
+        try {
+            __n = _M_rebuild_if(__x,__root,__last,__pred);
+        }
+        catch (...) {
+            auto __keep = [](const value_type&) { return false; };
+            _M_rebuild_if(__x,__root,__last,__keep);
+            _M_maintain_path(__last);
+            _M_set_root(__root);
+            throw;
+        }
+        _M_maintain_path(__last);
+        _M_set_root(__root);
+        return __n;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::size_type
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::erase(const key_type& __k) {
+        _Base_ptr __lroot,__mroot,__rroot;
+        _M_split(_M_release_root(),[&](_Base_ptr __x) { return _M_impl._M_key_compare(_S_key(__x),__k); },__lroot,__mroot);
+        _M_split(__mroot,[&](_Base_ptr __x) { return !_M_impl._M_key_compare(__k,_S_key(__x)); },__mroot,__rroot);
+        _M_set_root(_M_merge(__lroot,__rroot));
+
+        size_type __n = __mroot == nullptr ? 0 : __mroot->_M_size;
+        _M_erase(static_cast<_Link_type>(__mroot));
+        return __n;
     }
 
-    template <typename _Key,typename _Compare,typename _Alloc>
+    /*
+     * @brief clone the subtree rooted at __x below __p
+     *
+     * Source and clone are walked in lockstep through _M_parent,a child is cloned the
+     * first time its slot in the clone is still empty,so no recursion is needed.
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
     template <typename _NodeGen>
-    typename _Treap<_Key,_Compare,_Alloc>::_Link_type 
-    _Treap<_Key,_Compare,_Alloc>::_M_copy(_Const_Link_type __x,_Base_ptr __p,_NodeGen& __node_gen) {
+    typename _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_Link_type
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::_M_copy(_Const_Link_type __x,_Base_ptr __p,_NodeGen& __node_gen) {
         _Link_type __top = _M_clone_node(__x,__node_gen);
         __top->_M_parent = __p;
 
         try {
-            if (__x->_M_children[Direction_Left])
-                __top->_M_children[Direction_Left] = _M_copy(_S_left(__x),__top,__node_gen);
-            if (__x->_M_children[Direction_Right])
-                __top->_M_children[Direction_Right] = _M_copy(_S_left(__x),__top,__node_gen);
+            _Const_Base_ptr __src = __x;
+            _Base_ptr __dst = __top;
+            for (;;) {
+                unsigned int __dir = Direction_Left;
+                if (__src->_M_children[__dir] == nullptr || __dst->_M_children[__dir] != nullptr)
+                    __dir = Direction_Right;
+                if (__src->_M_children[__dir] != nullptr && __dst->_M_children[__dir] == nullptr) {
+                    __src = __src->_M_children[__dir];
+                    _Link_type __y = _M_clone_node(static_cast<_Const_Link_type>(__src),__node_gen);
+                    __y->_M_parent = __dst;
+                    __dst->_M_children[__dir] = __y;
+                    __dst = __y;
+                    continue;
+                }
+
+                __dst->_M_size = __src->_M_size;
+                if (__src == __x)
+                    break;
+                __src = __src->_M_parent;
+                __dst = __dst->_M_parent;
+            }
         }
         catch (...) {
             _M_erase(__top);
             throw;
         }
 
-        __top->_M_maintain();
-        __p->_M_maintain();
         return __top;
     }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>&
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::operator = (const _Treap& __x) {
+        if (this == &__x)
+            return *this;
+        if (_Alloc_traits::_S_propagate_on_copy_assign()) {
+            _Node_allocator& __this_alloc = _M_get_Node_allocator();
+            const _Node_allocator& __that_alloc = __x._M_get_Node_allocator();
+            // nodes from the old allocator cannot be reused once it is replaced
+            if (!_Alloc_traits::_S_always_equal() && __this_alloc != __that_alloc)
+                clear();
+            std::__alloc_on_copy(__this_alloc,__that_alloc);
+        }
+        _M_impl._M_key_compare = __x._M_impl._M_key_compare;
+        _M_impl._M_priority_gen = _M_fork_priority(__x._M_impl._M_priority_gen,0);
+
+        _Reuse_or_alloc_node __roan(*this);
+        if (__x._M_root() != nullptr)
+            _M_set_root(_M_copy(__x._M_begin(),_M_end(),__roan));
+        return *this;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>::swap(_Treap& __x) noexcept {
+        _Base_ptr __root = _M_root(),__leftmost = _M_leftmost(),__rightmost = _M_rightmost();
+        if (__x._M_root() == nullptr)
+            _M_impl._M_reset();
+        else {
+            _M_root() = __x._M_root();
+            _M_leftmost() = __x._M_leftmost();
+            _M_rightmost() = __x._M_rightmost();
+            _M_root()->_M_parent = _M_end();
+        }
+        if (__root == nullptr)
+            __x._M_impl._M_reset();
+        else {
+            __x._M_root() = __root;
+            __x._M_leftmost() = __leftmost;
+            __x._M_rightmost() = __rightmost;
+            __root->_M_parent = __x._M_end();
+        }
+
+        std::swap(_M_impl._M_block,__x._M_impl._M_block);
+        std::swap(_M_impl._M_block_nodes,__x._M_impl._M_block_nodes);
+        std::swap(_M_impl._M_block_live,__x._M_impl._M_block_live);
+        std::swap(_M_impl._M_key_compare,__x._M_impl._M_key_compare);
+        std::swap(_M_impl._M_priority_gen,__x._M_impl._M_priority_gen);
+        std::__alloc_on_swap(_M_get_Node_allocator(),__x._M_get_Node_allocator());
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    inline void swap(_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>& __x,
+                     _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>& __y) noexcept {
+        __x.swap(__y);
+    }
+}
+
+#if __cplusplus > 201703L
+#include <ranges>
+
+/*
+ * The range views own no element,so they model std::ranges::view and the scan cursors stay valid
+ * after the view they came from is gone.
+ */
+namespace std::ranges {
+    template <typename _Val,typename _KeyOfValue,typename _Compare,unsigned int _Dir>
+    inline constexpr bool enable_view<TreapTree::_Treap_range_view<_Val,_KeyOfValue,_Compare,_Dir>> = true;
+
+    template <typename _Val,typename _KeyOfValue,typename _Compare,unsigned int _Dir>
+    inline constexpr bool enable_borrowed_range<TreapTree::_Treap_range_view<_Val,_KeyOfValue,_Compare,_Dir>> = true;
+
+    template <typename _View,std::size_t _Nm>
+    inline constexpr bool enable_view<TreapTree::_Treap_kmerge_view<_View,_Nm>> = true;
 }
+#endif
 
 #endif
@@ -0,0 +1,411 @@
+// Treap set algebra -*- C++ -*-
+// @file treap_algebra.hpp
+
+#ifndef _TREAP_ALGEBRA_H_
+#define _TREAP_ALGEBRA_H_ 1
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "treap.hpp"
+
+namespace TreapTree {
+
+    /*
+     * @brief execution policies of treap_union(),treap_intersection() and treap_difference()
+     *
+     * With treap_parallel_policy the two recursive halves of a large enough call run on the
+     * workers of _Treap_fork_pool,forking at most log2(__threads) levels deep.The allocator must
+     * then be safe to use from several threads at once.
+     */
+    struct treap_sequenced_policy {};
+
+    struct treap_parallel_policy
+    {
+        unsigned int _M_threads;
+
+        explicit treap_parallel_policy(unsigned int __threads = 0) : _M_threads(__threads) {}
+    };
+
+    static const treap_sequenced_policy treap_seq = treap_sequenced_policy();
+    static const treap_parallel_policy treap_par = treap_parallel_policy();
+
+    /*
+     * @brief process-wide workers behind treap_parallel_policy,hardware_concurrency() - 1 of them
+     * started on first use and joined at exit
+     *
+     * A task no worker has picked up yet is taken back and run by the thread waiting for it,so a
+     * fork never waits on a queue nobody drains and nested forks cannot deadlock the pool.
+     */
+    class _Treap_fork_pool
+    {
+    public :
+        struct _Task
+        {
+            void (*_M_fn)(void*);
+            void* _M_arg;
+            std::exception_ptr _M_error;
+            bool _M_started = false;
+            bool _M_done = false;
+
+            _Task(void (*__fn)(void*),void* __arg) : _M_fn(__fn),_M_arg(__arg) {}
+        };
+
+        template <typename _Fn>
+        static void _S_invoke(void* __f) { (*static_cast<_Fn*>(__f))(); }
+
+        static _Treap_fork_pool& _S_instance() {
+            static _Treap_fork_pool __pool;
+            return __pool;
+        }
+
+        void _M_submit(_Task& __t) {
+            {
+                std::lock_guard<std::mutex> __lock(_M_mutex);
+                _M_queue.push_back(&__t);
+            }
+            _M_work.notify_one();
+        }
+
+        /*
+         * @brief returns once __t has run,rethrowing what it threw
+         */
+        void _M_wait(_Task& __t) {
+            std::unique_lock<std::mutex> __lock(_M_mutex);
+            if (!__t._M_started) {
+                _M_queue.erase(std::find(_M_queue.begin(),_M_queue.end(),&__t));
+                __t._M_started = true;
+                __lock.unlock();
+                __t._M_fn(__t._M_arg);
+                return;
+            }
+            _M_finished.wait(__lock,[&]() { return __t._M_done; });
+            if (__t._M_error)
+                std::rethrow_exception(__t._M_error);
+        }
+
+    private :
+        std::mutex _M_mutex;
+        std::condition_variable _M_work;
+        std::condition_variable _M_finished;
+        std::deque<_Task*> _M_queue;
+        std::vector<std::thread> _M_workers;
+        bool _M_stop = false;
+
+        _Treap_fork_pool() {
+            const unsigned int __n = std::max(std::thread::hardware_concurrency(),2u) - 1;
+            try {
+                for (unsigned int __i = 0; __i < __n; ++__i)
+                    _M_workers.emplace_back(&_Treap_fork_pool::_M_loop,this);
+            }
+            catch (const std::system_error&) {
+                // fewer workers,the waiting threads run what is left over
+            }
+        }
+
+        ~_Treap_fork_pool() {
+            {
+                std::lock_guard<std::mutex> __lock(_M_mutex);
+                _M_stop = true;
+            }
+            _M_work.notify_all();
+            for (std::thread& __w : _M_workers)
+                __w.join();
+        }
+
+        void _M_loop() {
+            std::unique_lock<std::mutex> __lock(_M_mutex);
+            for (;;) {
+                _M_work.wait(__lock,[&]() { return _M_stop || !_M_queue.empty(); });
+                if (_M_queue.empty())
+                    return;
+                _Task* __t = _M_queue.front();
+                _M_queue.pop_front();
+                __t->_M_started = true;
+                __lock.unlock();
+                try {
+                    __t->_M_fn(__t->_M_arg);
+                }
+                catch (...) {
+                    __t->_M_error = std::current_exception();
+                }
+                __lock.lock();
+                __t->_M_done = true;
+                _M_finished.notify_all();
+            }
+        }
+    };
+
+    /*
+     * @brief split-and-recurse set operations on detached subtrees,in O(m log(n/m + 1)) work
+     *
+     * Every node of the result is a node of one of the inputs,discarded nodes are dropped
+     * through the owning Treap.All Treaps involved must use allocators that compare equal.
+     */
+    template <typename _Treap_type>
+    struct _Treap_set_algebra
+    {
+        typedef typename _Treap_type::_Base_ptr _Base_ptr;
+        typedef typename _Treap_type::_Link_type _Link_type;
+        typedef typename _Treap_type::key_type _Key;
+
+        // below this many elements a fork costs more than it saves
+        static const std::size_t _S_grain = 1 << 14;
+
+        _Treap_type& _M_owner;
+        unsigned int _M_fork_depth;
+
+        _Treap_set_algebra(_Treap_type& __owner,const treap_sequenced_policy&) : _M_owner(__owner),_M_fork_depth(0) {}
+
+        _Treap_set_algebra(_Treap_type& __owner,const treap_parallel_policy& __policy) : _M_owner(__owner),_M_fork_depth(0) {
+            unsigned int __threads = __policy._M_threads != 0 ? __policy._M_threads : std::thread::hardware_concurrency();
+            while ((1u << _M_fork_depth) < __threads)
+                ++_M_fork_depth;
+        }
+
+        void _M_drop(_Base_ptr __x) { _M_owner._M_erase(static_cast<_Link_type>(__x)); }
+
+        void _M_drop_one(_Base_ptr __x) {
+            __x->_M_children[Direction_Left] = nullptr;
+            __x->_M_children[Direction_Right] = nullptr;
+            _M_owner._M_drop_node(static_cast<_Link_type>(__x));
+        }
+
+        /*
+         * @brief split __t into keys less than,equivalent to and greater than __k
+         */
+        void _M_split3(_Base_ptr __t,const _Key& __k,_Base_ptr& __l,_Base_ptr& __e,_Base_ptr& __r) {
+            const auto& __comp = _M_owner._M_impl._M_key_compare;
+            _Base_ptr __m;
+            _M_split(__t,[&](_Base_ptr __x) { return __comp(_Treap_type::_S_key(__x),__k); },__l,__m);
+            _M_split(__m,[&](_Base_ptr __x) { return !__comp(__k,_Treap_type::_S_key(__x)); },__e,__r);
+        }
+
+        static _Base_ptr _S_detach(_Base_ptr __x,unsigned int __dir) {
+            _Base_ptr __child = __x->_M_children[__dir];
+            if (__child != nullptr)
+                __child->_M_parent = nullptr;
+            return __child;
+        }
+
+        static _Base_ptr _S_link(_Base_ptr __x,_Base_ptr __l,_Base_ptr __r) {
+            __x->_M_children[Direction_Left] = __l;
+            __x->_M_children[Direction_Right] = __r;
+            if (__l != nullptr)
+                __l->_M_parent = __x;
+            if (__r != nullptr)
+                __r->_M_parent = __x;
+            __x->_M_parent = nullptr;
+            __x->_M_maintain();
+            return __x;
+        }
+
+        /*
+         * @brief hand __left to _Treap_fork_pool and run __right on this thread when the work is large enough
+         */
+        template <typename _Left,typename _Right>
+        void _M_fork(unsigned int __depth,std::size_t __work,_Left __left,_Right __right) {
+            if (__depth == 0 || __work < _S_grain) {
+                __left();
+                __right();
+                return;
+            }
+
+            _Treap_fork_pool& __pool = _Treap_fork_pool::_S_instance();
+            _Treap_fork_pool::_Task __task(&_Treap_fork_pool::_S_invoke<_Left>,&__left);
+            __pool._M_submit(__task);
+            try {
+                __right();
+            }
+            catch (...) {
+                // __task refers to this frame,it must finish before the exception leaves
+                try {
+                    __pool._M_wait(__task);
+                }
+                catch (...) {
+                }
+                throw;
+            }
+            __pool._M_wait(__task);
+        }
+
+        /*
+         * @brief move __a's state into the result,then combine both trees with __op
+         */
+        template <typename _Policy>
+        static _Treap_type _S_apply(_Treap_type& __a,_Treap_type& __b,const _Policy& __policy,_Base_ptr (_Treap_set_algebra::*__op)(_Base_ptr,_Base_ptr,unsigned int)) {
+            const bool __same = &__a == &__b;
+            _Treap_type __result(std::move(__a));
+            if (__same) {
+                // a set with itself,union and intersection give it back unchanged
+                if (__op == &_Treap_set_algebra::_M_difference)
+                    __result.clear();
+                return __result;
+            }
+            _Treap_set_algebra __algebra(__result,__policy);
+            // nodes of a compact() block must not leave their Treap,nor be counted off from two threads
+            __b._M_thaw();
+            if (__algebra._M_fork_depth > 0)
+                __result._M_thaw();
+            _Base_ptr __root = __result._M_release_root();
+            __result._M_set_root((__algebra.*__op)(__root,__b._M_release_root(),__algebra._M_fork_depth));
+            return __result;
+        }
+
+        _Base_ptr _M_union(_Base_ptr __a,_Base_ptr __b,unsigned int __depth);
+
+        _Base_ptr _M_intersection(_Base_ptr __a,_Base_ptr __b,unsigned int __depth);
+
+        _Base_ptr _M_difference(_Base_ptr __a,_Base_ptr __b,unsigned int __depth);
+    };
+
+    /*
+     * @brief the root with the higher priority splits the other subtree,on equal keys __a's element is kept
+     */
+    template <typename _Treap_type>
+    typename _Treap_set_algebra<_Treap_type>::_Base_ptr
+    _Treap_set_algebra<_Treap_type>::_M_union(_Base_ptr __a,_Base_ptr __b,unsigned int __depth) {
+        if (__a == nullptr)
+            return __b;
+        if (__b == nullptr)
+            return __a;
+
+        const unsigned int __next = __depth > 0 ? __depth - 1 : 0;
+        const bool __a_on_top = __a->_M_Priority > __b->_M_Priority;
+        _Base_ptr __top = __a_on_top ? __a : __b;
+        _Base_ptr __l,__e,__r;
+        _M_split3(__a_on_top ? __b : __a,_Treap_type::_S_key(__top),__l,__e,__r);
+
+        _Base_ptr __tl = _S_detach(__top,Direction_Left);
+        _Base_ptr __tr = _S_detach(__top,Direction_Right);
+        _Base_ptr __rl,__rr;
+        _M_fork(__depth,__top->_M_size + _M_subtree_size(__l) + _M_subtree_size(__r),
+            [&]() { __rl = __a_on_top ? _M_union(__tl,__l,__next) : _M_union(__l,__tl,__next); },
+            [&]() { __rr = __a_on_top ? _M_union(__tr,__r,__next) : _M_union(__r,__tr,__next); });
+
+        if (__a_on_top) {
+            _M_drop(__e);
+            return _S_link(__top,__rl,__rr);
+        }
+        if (__e == nullptr)
+            return _S_link(__top,__rl,__rr);
+        _M_drop_one(__top);
+        return _M_merge(_M_merge(__rl,__e),__rr);
+    }
+
+    /*
+     * @brief the root of __a splits __b,so the result is made of __a's nodes only
+     */
+    template <typename _Treap_type>
+    typename _Treap_set_algebra<_Treap_type>::_Base_ptr
+    _Treap_set_algebra<_Treap_type>::_M_intersection(_Base_ptr __a,_Base_ptr __b,unsigned int __depth) {
+        if (__a == nullptr || __b == nullptr) {
+            _M_drop(__a);
+            _M_drop(__b);
+            return nullptr;
+        }
+
+        const unsigned int __next = __depth > 0 ? __depth - 1 : 0;
+        _Base_ptr __l,__e,__r;
+        _M_split3(__b,_Treap_type::_S_key(__a),__l,__e,__r);
+        const bool __found = __e != nullptr;
+        _M_drop(__e);
+
+        _Base_ptr __al = _S_detach(__a,Direction_Left);
+        _Base_ptr __ar = _S_detach(__a,Direction_Right);
+        _Base_ptr __rl,__rr;
+        _M_fork(__depth,__a->_M_size + _M_subtree_size(__l) + _M_subtree_size(__r),
+            [&]() { __rl = _M_intersection(__al,__l,__next); },
+            [&]() { __rr = _M_intersection(__ar,__r,__next); });
+
+        if (__found)
+            return _S_link(__a,__rl,__rr);
+        _M_drop_one(__a);
+        return _M_merge(__rl,__rr);
+    }
+
+    /*
+     * @brief the root of __b splits __a,its equivalent elements in __a are dropped
+     */
+    template <typename _Treap_type>
+    typename _Treap_set_algebra<_Treap_type>::_Base_ptr
+    _Treap_set_algebra<_Treap_type>::_M_difference(_Base_ptr __a,_Base_ptr __b,unsigned int __depth) {
+        if (__a == nullptr || __b == nullptr) {
+            _M_drop(__b);
+            return __a;
+        }
+
+        const unsigned int __next = __depth > 0 ? __depth - 1 : 0;
+        _Base_ptr __l,__e,__r;
+        _M_split3(__a,_Treap_type::_S_key(__b),__l,__e,__r);
+        _M_drop(__e);
+
+        _Base_ptr __bl = _S_detach(__b,Direction_Left);
+        _Base_ptr __br = _S_detach(__b,Direction_Right);
+        _Base_ptr __rl,__rr;
+        _M_fork(__depth,__b->_M_size + _M_subtree_size(__l) + _M_subtree_size(__r),
+            [&]() { __rl = _M_difference(__l,__bl,__next); },
+            [&]() { __rr = _M_difference(__r,__br,__next); });
+
+        _M_drop_one(__b);
+        return _M_merge(__rl,__rr);
+    }
+
+    /*
+     * @brief Union of two Treaps in O(m log(n/m + 1)),m <= n being the sizes of the inputs
+     * @param __a,__b Treaps treated as sets,both are left empty and their nodes are reused
+     * @param __policy treap_seq or treap_par
+     * @return every element of __a,plus the elements of __b whose key does not occur in __a
+     *
+     * Discarded elements are destroyed on top of the bound.Equivalent keys inside one input
+     * still give a valid Treap,but which of them survive is unspecified.
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen,typename _Policy = treap_sequenced_policy>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen> treap_union(_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>& __a,_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>& __b,const _Policy& __policy = _Policy()) {
+        typedef _Treap_set_algebra<_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>> _Algebra;
+        return _Algebra::_S_apply(__a,__b,__policy,&_Algebra::_M_union);
+    }
+
+    /*
+     * @brief Intersection of two Treaps in O(m log(n/m + 1)),see treap_union()
+     * @return the elements of __a whose key occurs in __b
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen,typename _Policy = treap_sequenced_policy>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen> treap_intersection(_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>& __a,_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>& __b,const _Policy& __policy = _Policy()) {
+        typedef _Treap_set_algebra<_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>> _Algebra;
+        return _Algebra::_S_apply(__a,__b,__policy,&_Algebra::_M_intersection);
+    }
+
+    /*
+     * @brief Difference of two Treaps in O(m log(n/m + 1)),see treap_union()
+     * @return the elements of __a whose key does not occur in __b
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen,typename _Policy = treap_sequenced_policy>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen> treap_difference(_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>& __a,_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>& __b,const _Policy& __policy = _Policy()) {
+        typedef _Treap_set_algebra<_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>> _Algebra;
+        return _Algebra::_S_apply(__a,__b,__policy,&_Algebra::_M_difference);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen,typename _Policy = treap_sequenced_policy>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen> treap_union(_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>&& __a,_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>&& __b,const _Policy& __policy = _Policy()) {
+        return treap_union(__a,__b,__policy);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen,typename _Policy = treap_sequenced_policy>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen> treap_intersection(_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>&& __a,_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>&& __b,const _Policy& __policy = _Policy()) {
+        return treap_intersection(__a,__b,__policy);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen,typename _Policy = treap_sequenced_policy>
+    _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen> treap_difference(_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>&& __a,_Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>&& __b,const _Policy& __policy = _Policy()) {
+        return treap_difference(__a,__b,__policy);
+    }
+}
+
+#endif
@@ -0,0 +1,1016 @@
+// Fat-node (block) Treap implementation -*- C++ -*-
+// @file treap_block.hpp
+
+#ifndef _TREAP_BLOCK_H_
+#define _TREAP_BLOCK_H_ 1
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <iterator>
+#include "treap.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace TreapTree {
+
+    /*
+     * @brief node of _Block_treap,a sorted run of up to _Nb keys
+     *
+     * The treap order is over whole blocks:every key below the left child is not greater than
+     * _M_keys[0] and every key below the right child is not less than the last key.A block is
+     * never empty while linked.
+     */
+    template <typename _Key,unsigned int _Nb>
+    struct _Block_treap_node
+    {
+        _Block_treap_node* _M_children[2];
+        unsigned int _M_Priority;
+        unsigned int _M_count;
+        unsigned int _M_size;
+
+        _Key _M_keys[_Nb];
+
+        const _Key& _M_min() const { return _M_keys[0]; }
+
+        const _Key& _M_max() const { return _M_keys[_M_count - 1]; }
+
+        void _M_maintain() {
+            _M_size = _M_count;
+            if (_M_children[Direction_Left]) _M_size += _M_children[Direction_Left]->_M_size;
+            if (_M_children[Direction_Right]) _M_size += _M_children[Direction_Right]->_M_size;
+        }
+    };
+
+    /*
+     * @brief rank of a key inside a block:_S_lower() counts the keys ordered before __k,
+     *        _S_upper() the keys __k is not ordered before
+     *
+     * The generic version is a branch-free count over the block.Specializations below compare
+     * 8 (AVX2) or 4 (SSE2) lanes at once for int,long,long long,float and double under std::less;
+     * they read whole vectors,so the block capacity must be a multiple of 8.
+     */
+    template <typename _Key,typename _Compare>
+    struct _Block_search
+    {
+        static unsigned int _S_lower(const _Key* __keys,unsigned int __n,const _Key& __k,const _Compare& __comp) {
+            unsigned int __r = 0;
+            for (unsigned int __i = 0; __i < __n; ++__i)
+                __r += __comp(__keys[__i],__k);
+            return __r;
+        }
+
+        static unsigned int _S_upper(const _Key* __keys,unsigned int __n,const _Key& __k,const _Compare& __comp) {
+            unsigned int __r = 0;
+            for (unsigned int __i = 0; __i < __n; ++__i)
+                __r += !__comp(__k,__keys[__i]);
+            return __r;
+        }
+    };
+
+    #if defined(__AVX2__) || defined(__SSE2__)
+    /*
+     * @brief shared body of the vector searches,_Lanes gives the load,splat and lane-wise less-than mask
+     */
+    template <typename _Lanes>
+    struct _Block_simd_search
+    {
+        typedef typename _Lanes::key_type _Key;
+        typedef typename _Lanes::vector_type _Vec;
+
+        static unsigned int _S_valid(unsigned int __left) {
+            return __left >= _Lanes::_S_width ? (1u << _Lanes::_S_width) - 1 : (1u << __left) - 1;
+        }
+
+        template <typename _Compare>
+        static unsigned int _S_lower(const _Key* __keys,unsigned int __n,const _Key& __k,const _Compare&) {
+            const _Vec __kv = _Lanes::_S_splat(__k);
+            unsigned int __r = 0;
+            for (unsigned int __i = 0; __i < __n; __i += _Lanes::_S_width)
+                __r += __builtin_popcount(_Lanes::_S_less(_Lanes::_S_load(__keys + __i),__kv) & _S_valid(__n - __i));
+            return __r;
+        }
+
+        template <typename _Compare>
+        static unsigned int _S_upper(const _Key* __keys,unsigned int __n,const _Key& __k,const _Compare&) {
+            const _Vec __kv = _Lanes::_S_splat(__k);
+            unsigned int __r = 0;
+            for (unsigned int __i = 0; __i < __n; __i += _Lanes::_S_width)
+                __r += __builtin_popcount(_Lanes::_S_less(__kv,_Lanes::_S_load(__keys + __i)) & _S_valid(__n - __i));
+            return __n - __r;
+        }
+    };
+
+    #if defined(__AVX2__)
+    template <typename _Tp>
+    struct _Block_lanes_i32
+    {
+        typedef _Tp key_type;
+        typedef __m256i vector_type;
+        static const unsigned int _S_width = 8;
+
+        static __m256i _S_load(const _Tp* __p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(__p)); }
+        static __m256i _S_splat(_Tp __k) { return _mm256_set1_epi32(static_cast<int>(__k)); }
+        static unsigned int _S_less(__m256i __a,__m256i __b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(__b,__a))); }
+    };
+
+    template <typename _Tp>
+    struct _Block_lanes_i64
+    {
+        typedef _Tp key_type;
+        typedef __m256i vector_type;
+        static const unsigned int _S_width = 4;
+
+        static __m256i _S_load(const _Tp* __p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(__p)); }
+        static __m256i _S_splat(_Tp __k) { return _mm256_set1_epi64x(static_cast<long long>(__k)); }
+        static unsigned int _S_less(__m256i __a,__m256i __b) { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(__b,__a))); }
+    };
+
+    struct _Block_lanes_f32
+    {
+        typedef float key_type;
+        typedef __m256 vector_type;
+        static const unsigned int _S_width = 8;
+
+        static __m256 _S_load(const float* __p) { return _mm256_loadu_ps(__p); }
+        static __m256 _S_splat(float __k) { return _mm256_set1_ps(__k); }
+        static unsigned int _S_less(__m256 __a,__m256 __b) { return _mm256_movemask_ps(_mm256_cmp_ps(__a,__b,_CMP_LT_OQ)); }
+    };
+
+    struct _Block_lanes_f64
+    {
+        typedef double key_type;
+        typedef __m256d vector_type;
+        static const unsigned int _S_width = 4;
+
+        static __m256d _S_load(const double* __p) { return _mm256_loadu_pd(__p); }
+        static __m256d _S_splat(double __k) { return _mm256_set1_pd(__k); }
+        static unsigned int _S_less(__m256d __a,__m256d __b) { return _mm256_movemask_pd(_mm256_cmp_pd(__a,__b,_CMP_LT_OQ)); }
+    };
+    #else
+    template <typename _Tp>
+    struct _Block_lanes_i32
+    {
+        typedef _Tp key_type;
+        typedef __m128i vector_type;
+        static const unsigned int _S_width = 4;
+
+        static __m128i _S_load(const _Tp* __p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(__p)); }
+        static __m128i _S_splat(_Tp __k) { return _mm_set1_epi32(static_cast<int>(__k)); }
+        static unsigned int _S_less(__m128i __a,__m128i __b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(__b,__a))); }
+    };
+
+    struct _Block_lanes_f32
+    {
+        typedef float key_type;
+        typedef __m128 vector_type;
+        static const unsigned int _S_width = 4;
+
+        static __m128 _S_load(const float* __p) { return _mm_loadu_ps(__p); }
+        static __m128 _S_splat(float __k) { return _mm_set1_ps(__k); }
+        static unsigned int _S_less(__m128 __a,__m128 __b) { return _mm_movemask_ps(_mm_cmplt_ps(__a,__b)); }
+    };
+
+    struct _Block_lanes_f64
+    {
+        typedef double key_type;
+        typedef __m128d vector_type;
+        static const unsigned int _S_width = 2;
+
+        static __m128d _S_load(const double* __p) { return _mm_loadu_pd(__p); }
+        static __m128d _S_splat(double __k) { return _mm_set1_pd(__k); }
+        static unsigned int _S_less(__m128d __a,__m128d __b) { return _mm_movemask_pd(_mm_cmplt_pd(__a,__b)); }
+    };
+    #endif
+
+    template <>
+    struct _Block_search<int,std::less<int>> : _Block_simd_search<_Block_lanes_i32<int>> {};
+
+    template <>
+    struct _Block_search<float,std::less<float>> : _Block_simd_search<_Block_lanes_f32> {};
+
+    template <>
+    struct _Block_search<double,std::less<double>> : _Block_simd_search<_Block_lanes_f64> {};
+
+    #if defined(__AVX2__)
+    template <>
+    struct _Block_search<long,std::less<long>> : std::conditional<sizeof(long) == 8,_Block_simd_search<_Block_lanes_i64<long>>,
+                                                                  _Block_simd_search<_Block_lanes_i32<long>>>::type {};
+
+    template <>
+    struct _Block_search<long long,std::less<long long>> : _Block_simd_search<_Block_lanes_i64<long long>> {};
+    #endif
+    #endif
+
+    /*
+     * @brief forward iterator of _Block_treap,keeps the pending blocks on a fixed stack
+     *
+     * Blocks have no parent link:like _Treap_scan_cursor the iterator keeps the last _S_depth
+     * pending ancestors,and should older ones have been dropped it finds the next block again
+     * from the root by the rank of its first key.Any insertion or erasure may move keys between
+     * blocks and invalidates every iterator.
+     */
+    template <typename _Key,unsigned int _Nb>
+    struct _Block_treap_const_iterator
+    {
+        typedef _Key value_type;
+        typedef const _Key* pointer;
+        typedef const _Key& reference;
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::ptrdiff_t difference_type;
+
+        typedef _Block_treap_const_iterator<_Key,_Nb> _Self;
+        typedef const _Block_treap_node<_Key,_Nb>* _Node_ptr;
+
+        static const unsigned int _S_depth = 32;
+
+        _Block_treap_const_iterator() : _M_node(),_M_pos(0),_M_root(),_M_rank(0),_M_top(0),_M_count(0) {}
+
+        reference operator* () const { return _M_node->_M_keys[_M_pos]; }
+
+        pointer operator->() const { return _M_node->_M_keys + _M_pos; }
+
+        _Self& operator++() {
+            if (++_M_pos == _M_node->_M_count)
+                _M_next_block();
+            return *this;
+        }
+
+        _Self operator++(int) {
+            _Self __tmp = *this;
+            ++*this;
+            return __tmp;
+        }
+
+        bool operator == (const _Self& __x) const { return _M_node == __x._M_node && _M_pos == __x._M_pos; }
+
+        bool operator != (const _Self& __x) const { return !(*this == __x); }
+
+        void _M_push(_Node_ptr __x) {
+            _M_stack[_M_top++ & (_S_depth - 1)] = __x;
+            if (_M_count < _S_depth)
+                ++_M_count;
+        }
+
+        /*
+         * @brief move to the first key of the block after _M_node,or to the end
+         */
+        void _M_next_block() {
+            _M_rank += _M_node->_M_count;
+            _M_pos = 0;
+            _Node_ptr __x = _M_node->_M_children[Direction_Right];
+            if (__x != nullptr) {
+                for (; __x->_M_children[Direction_Left] != nullptr; __x = __x->_M_children[Direction_Left])
+                    _M_push(__x);
+                _M_node = __x;
+            }
+            else if (_M_count > 0) {
+                --_M_count;
+                _M_node = _M_stack[--_M_top & (_S_depth - 1)];
+            }
+            else if (_M_rank < _M_root->_M_size)
+                _M_seek(_M_rank);
+            else
+                _M_node = nullptr;
+        }
+
+        /*
+         * @brief position on the key of in-order rank __k < _M_root->_M_size,rebuilding the stack
+         */
+        void _M_seek(std::size_t __k) {
+            _M_top = _M_count = 0;
+            _M_rank = 0;
+            for (_Node_ptr __x = _M_root;;) {
+                const std::size_t __lsize = __x->_M_children[Direction_Left] == nullptr ? 0 : __x->_M_children[Direction_Left]->_M_size;
+                if (__k < __lsize) {
+                    _M_push(__x);
+                    __x = __x->_M_children[Direction_Left];
+                }
+                else if (__k < __lsize + __x->_M_count) {
+                    _M_node = __x;
+                    _M_rank += __lsize;
+                    _M_pos = static_cast<unsigned int>(__k - __lsize);
+                    return;
+                }
+                else {
+                    __k -= __lsize + __x->_M_count;
+                    _M_rank += __lsize + __x->_M_count;
+                    __x = __x->_M_children[Direction_Right];
+                }
+            }
+        }
+
+        _Node_ptr _M_node;
+        unsigned int _M_pos;
+        _Node_ptr _M_root;
+        // rank of the first key of _M_node
+        std::size_t _M_rank;
+        _Node_ptr _M_stack[_S_depth];
+        unsigned int _M_top;
+        unsigned int _M_count;
+    };
+
+    /*
+     * @brief multiset of trivially copyable keys stored _Nb to a treap node
+     *
+     * A lookup compares against the first and last key of each block on its way down and ranks
+     * the key inside the final block with _Block_search,so it visits one node per level of a
+     * treap with about n / _Nb nodes instead of n,and each key costs a few bytes instead of a
+     * whole _Treap_node.A full block is cut in two on insertion,a block left under half full by
+     * erase() takes over its in-order successor when they fit together.split() and merge() keep
+     * the semantics of _Treap,a block straddling the split key is cut in two.A new block takes
+     * its priority from _PriorityGen,called with its first key.
+     */
+    template <typename _Key,typename _Compare = std::less<_Key>,typename _Alloc = std::allocator<_Key>,unsigned int _Nb = 16,
+              typename _PriorityGen = treap_random_priority>
+    class _Block_treap
+    {
+        static_assert(_Nb >= 8 && _Nb % 8 == 0,"_Block_treap: the block capacity must be a multiple of 8");
+        static_assert(std::is_trivially_copyable<_Key>::value && std::is_default_constructible<_Key>::value,
+                      "_Block_treap: keys are copied between blocks bytewise");
+
+        typedef _Block_treap_node<_Key,_Nb> _Node;
+        typedef typename __gnu_cxx::__alloc_traits<_Alloc>::template rebind<_Node>::other _Node_allocator;
+        typedef __gnu_cxx::__alloc_traits<_Node_allocator> _Alloc_traits;
+        typedef _Block_search<_Key,_Compare> _Search;
+
+    public :
+        typedef _Key key_type;
+        typedef _Key value_type;
+        typedef const value_type& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _Alloc allocator_type;
+
+        typedef _Block_treap_const_iterator<_Key,_Nb> const_iterator;
+        typedef const_iterator iterator;
+
+        static const unsigned int _S_block_keys = _Nb;
+
+    private :
+        _Node_allocator _M_alloc;
+        _Compare _M_key_compare;
+        _PriorityGen _M_priority_gen;
+        _Node* _M_root = nullptr;
+        // a free node kept ahead of every split,so a block cut in two never allocates half-way
+        _Node* _M_spare = nullptr;
+
+        static unsigned int _S_size(const _Node* __x) { return __x == nullptr ? 0 : __x->_M_size; }
+
+        /*
+         * @brief hint that all of __x will be read soon,a node spans more than one cache line
+         */
+        static void _S_prefetch(const _Node* __x) {
+            for (std::size_t __off = 0; __off < sizeof(_Node); __off += 64)
+                _M_prefetch(reinterpret_cast<const _Treap_node_base*>(reinterpret_cast<const char*>(__x) + __off));
+        }
+
+        _Node* _M_create_node() {
+            _Node* __p = _Alloc_traits::allocate(_M_alloc,1);
+            ::new(__p) _Node();
+            return __p;
+        }
+
+        void _M_put_node(_Node* __p) { _Alloc_traits::deallocate(_M_alloc,__p,1); }
+
+        /*
+         * @brief priority of a new block,once its keys are in
+         */
+        void _M_draw_priority(_Node* __x) { __x->_M_Priority = _M_priority_gen(__x->_M_min()); }
+
+        void _M_drop_spare() {
+            if (_M_spare != nullptr)
+                _M_put_node(_M_spare);
+            _M_spare = nullptr;
+        }
+
+        void _M_move_assign(_Block_treap& __x,std::true_type) {
+            clear();
+            _M_drop_spare();
+            std::__alloc_on_move(_M_alloc,__x._M_alloc);
+            _M_root = __x._M_root;
+            _M_spare = __x._M_spare;
+            __x._M_root = __x._M_spare = nullptr;
+        }
+
+        /*
+         * @brief move assignment between allocators that do not propagate,the keys are copied when they differ
+         */
+        void _M_move_assign(_Block_treap& __x,std::false_type) {
+            if (_M_alloc == __x._M_alloc) {
+                _M_move_assign(__x,std::true_type());
+                return;
+            }
+            clear();
+            const_iterator __first = __x.begin();
+            _M_append_sorted(__first,__x.end());
+            __x.clear();
+        }
+
+        void _M_reserve_spare() {
+            if (_M_spare == nullptr)
+                _M_spare = _M_create_node();
+        }
+
+        unsigned int _M_lower(const _Node* __x,const _Key& __k) const { return _Search::_S_lower(__x->_M_keys,__x->_M_count,__k,_M_key_compare); }
+
+        unsigned int _M_upper(const _Node* __x,const _Key& __k) const { return _Search::_S_upper(__x->_M_keys,__x->_M_count,__k,_M_key_compare); }
+
+        /*
+         * @brief next block on the way to where __k is inserted,nullptr once __x is that block
+         */
+        _Node* _M_insert_step(const _Node* __x,const _Key& __k) const {
+            if (_M_key_compare(__k,__x->_M_min()) && __x->_M_children[Direction_Left] != nullptr)
+                return __x->_M_children[Direction_Left];
+            if (!_M_key_compare(__k,__x->_M_max()) && __x->_M_children[Direction_Right] != nullptr)
+                return __x->_M_children[Direction_Right];
+            return nullptr;
+        }
+
+        void _M_split(_Node* __t,const _Key& __k,bool __upper,_Node*& __l,_Node*& __r);
+
+        _Node* _M_merge(_Node* __l,_Node* __r);
+
+        void _M_insert_full(_Node* __x,const _Key& __k);
+
+        void _M_absorb_successor(_Node* __x);
+
+        void _M_erase_all(_Node* __x);
+
+        size_type _M_count_before(const _Key& __k,bool __upper) const;
+
+        /*
+         * @brief Cartesian build over sorted keys,blocks are filled up and appended along the right spine
+         * @param __first advanced past every key consumed,stops at the first one out of order
+         */
+        template <typename _InputIterator>
+        void _M_append_sorted(_InputIterator& __first,_InputIterator __last);
+
+    public :
+        _Block_treap() {}
+
+        explicit _Block_treap(const _Compare& __comp,const allocator_type& __a = allocator_type(),const _PriorityGen& __gen = _PriorityGen())
+        : _M_alloc(__a),_M_key_compare(__comp),_M_priority_gen(__gen) {}
+
+        /*
+         * @brief Builds from [__first,__last) with full blocks,in O(n) when the range is sorted
+         */
+        template <typename _InputIterator>
+        _Block_treap(_InputIterator __first,_InputIterator __last,const _Compare& __comp = _Compare(),const allocator_type& __a = allocator_type(),
+                     const _PriorityGen& __gen = _PriorityGen())
+        : _M_alloc(__a),_M_key_compare(__comp),_M_priority_gen(__gen) {
+            _M_append_sorted(__first,__last);
+            for (; __first != __last; ++__first)
+                insert(*__first);
+        }
+
+        _Block_treap(const _Block_treap& __x)
+        : _M_alloc(_Alloc_traits::_S_select_on_copy(__x._M_alloc)),_M_key_compare(__x._M_key_compare),_M_priority_gen(_M_fork_priority(__x._M_priority_gen,0)) {
+            const_iterator __first = __x.begin();
+            _M_append_sorted(__first,__x.end());
+        }
+
+        /*
+         * @brief O(1),the blocks of __x change owner
+         */
+        _Block_treap(_Block_treap&& __x) noexcept(std::is_nothrow_copy_constructible<_Compare>::value && std::is_nothrow_copy_constructible<_PriorityGen>::value)
+        : _M_alloc(std::move(__x._M_alloc)),_M_key_compare(__x._M_key_compare),_M_priority_gen(_M_fork_priority(__x._M_priority_gen,0)),
+          _M_root(__x._M_root),_M_spare(__x._M_spare) {
+            __x._M_root = __x._M_spare = nullptr;
+        }
+
+        _Block_treap& operator = (const _Block_treap&) = delete;
+
+        _Block_treap& operator = (_Block_treap&& __x) noexcept(_Alloc_traits::_S_nothrow_move() && std::is_nothrow_move_assignable<_Compare>::value
+                                                               && std::is_nothrow_move_assignable<_PriorityGen>::value) {
+            if (this != &__x) {
+                _M_key_compare = std::move(__x._M_key_compare);
+                _M_priority_gen = _M_fork_priority(__x._M_priority_gen,0);
+                _M_move_assign(__x,std::integral_constant<bool,_Alloc_traits::_S_nothrow_move()>());
+            }
+            return *this;
+        }
+
+        /*
+         * @brief O(1) exchange of contents,comparators,priority generators and (if they propagate) allocators
+         */
+        void swap(_Block_treap& __x) noexcept {
+            std::swap(_M_root,__x._M_root);
+            std::swap(_M_spare,__x._M_spare);
+            std::swap(_M_key_compare,__x._M_key_compare);
+            std::swap(_M_priority_gen,__x._M_priority_gen);
+            std::__alloc_on_swap(_M_alloc,__x._M_alloc);
+        }
+
+        ~_Block_treap() {
+            clear();
+            _M_drop_spare();
+        }
+
+        const_iterator begin() const {
+            const_iterator __it;
+            __it._M_root = _M_root;
+            if (_M_root != nullptr)
+                __it._M_seek(0);
+            return __it;
+        }
+
+        const_iterator end() const { return const_iterator(); }
+
+        size_type size() const { return _S_size(_M_root); }
+
+        bool empty() const { return _M_root == nullptr; }
+
+        /*
+         * @brief number of blocks,size() / block_count() is the mean fill
+         */
+        size_type block_count() const;
+
+        void clear() {
+            _M_erase_all(_M_root);
+            _M_root = nullptr;
+        }
+
+        /*
+         * @brief Inserts __k after the keys equivalent to it in O(log n)
+         */
+        void insert(const key_type& __k);
+
+        template <typename... _Args>
+        void emplace(_Args&&... __args) { insert(key_type(std::forward<_Args>(__args)...)); }
+
+        /*
+         * @brief Removes every key equivalent to __k
+         * @return number of keys removed
+         */
+        size_type erase(const key_type& __k);
+
+        const_iterator lower_bound(const key_type& __k) const;
+
+        const_iterator find(const key_type& __k) const {
+            const_iterator __it = lower_bound(__k);
+            return (__it == end() || _M_key_compare(__k,*__it)) ? end() : __it;
+        }
+
+        /*
+         * @brief membership test that reads the two end keys of each block on the way down
+         */
+        bool contains(const key_type& __k) const;
+
+        size_type count(const key_type& __k) const { return _M_count_before(__k,true) - _M_count_before(__k,false); }
+
+        /*
+         * @brief number of keys strictly less than __k in O(log n)
+         */
+        size_type order_of_key(const key_type& __k) const { return _M_count_before(__k,false); }
+
+        /*
+         * @brief Moves every key not less than __k into a new _Block_treap in O(log n)
+         */
+        _Block_treap split(const key_type& __k);
+
+        /*
+         * @brief Concatenates __x in O(log n) when its keys all order after (or all before) ours
+         *
+         * Otherwise the keys of __x are inserted one by one.Either way __x is left empty.
+         */
+        void merge(_Block_treap& __x);
+
+        void merge(_Block_treap&& __x) { merge(__x); }
+
+        /*
+         * @brief checks every structural invariant in O(n),the counterpart of _Treap::__treap_verify()
+         * @return false on the first broken one:block fill,subtree sizes,heap order of the priorities
+         *         or key order within and across blocks
+         */
+        bool __block_treap_verify() const;
+    };
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    void _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::_M_split(_Node* __t,const _Key& __k,bool __upper,_Node*& __l,_Node*& __r) {
+        if (__t == nullptr) {
+            __l = __r = nullptr;
+            return;
+        }
+        const unsigned int __c = __upper ? _M_upper(__t,__k) : _M_lower(__t,__k);
+        if (__c == __t->_M_count) {
+            __l = __t;
+            _M_split(__t->_M_children[Direction_Right],__k,__upper,__t->_M_children[Direction_Right],__r);
+        }
+        else if (__c == 0) {
+            __r = __t;
+            _M_split(__t->_M_children[Direction_Left],__k,__upper,__l,__t->_M_children[Direction_Left]);
+        }
+        else {
+            // the keys on both sides of __k part,the new block keeps the priority so both halves stay heaps
+            _Node* __t2 = _M_spare;
+            _M_spare = nullptr;
+            __t2->_M_Priority = __t->_M_Priority;
+            __t2->_M_count = __t->_M_count - __c;
+            std::memcpy(__t2->_M_keys,__t->_M_keys + __c,__t2->_M_count * sizeof(_Key));
+            __t2->_M_children[Direction_Left] = nullptr;
+            __t2->_M_children[Direction_Right] = __t->_M_children[Direction_Right];
+            __t2->_M_maintain();
+            __t->_M_count = __c;
+            __t->_M_children[Direction_Right] = nullptr;
+            __l = __t;
+            __r = __t2;
+        }
+        __t->_M_maintain();
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    typename _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::_Node* _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::_M_merge(_Node* __l,_Node* __r) {
+        if (__l == nullptr)
+            return __r;
+        if (__r == nullptr)
+            return __l;
+        if (__l->_M_Priority > __r->_M_Priority) {
+            __l->_M_children[Direction_Right] = _M_merge(__l->_M_children[Direction_Right],__r);
+            __l->_M_maintain();
+            return __l;
+        }
+        __r->_M_children[Direction_Left] = _M_merge(__l,__r->_M_children[Direction_Left]);
+        __r->_M_maintain();
+        return __r;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    void _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::insert(const key_type& __k) {
+        if (_M_root == nullptr) {
+            _Node* __z = _M_create_node();
+            __z->_M_keys[0] = __k;
+            __z->_M_count = __z->_M_size = 1;
+            _M_draw_priority(__z);
+            _M_root = __z;
+            return;
+        }
+
+        _Node* __x = _M_root;
+        for (_Node* __next; (__next = _M_insert_step(__x,__k)) != nullptr; __x = __next) {
+            _S_prefetch(__next);
+            ++__x->_M_size;
+        }
+        if (__x->_M_count == _Nb) {
+            // undo the sizes bumped on the way,the full block is cut in two instead
+            for (_Node* __y = _M_root; __y != __x; __y = _M_insert_step(__y,__k))
+                --__y->_M_size;
+            _M_insert_full(__x,__k);
+            return;
+        }
+
+        const unsigned int __pos = _M_upper(__x,__k);
+        std::memmove(__x->_M_keys + __pos + 1,__x->_M_keys + __pos,(__x->_M_count - __pos) * sizeof(_Key));
+        __x->_M_keys[__pos] = __k;
+        ++__x->_M_count;
+        ++__x->_M_size;
+    }
+
+    /*
+     * @brief insert __k into the full block __x:the upper half moves to a new block linked back
+     *        in by a split and two merges,the only step of insert() that allocates
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    void _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::_M_insert_full(_Node* __x,const _Key& __k) {
+        _M_reserve_spare();
+        _Node* __z = _M_create_node();
+
+        _Key __keys[_Nb + 1];
+        const unsigned int __pos = _M_upper(__x,__k);
+        std::memcpy(__keys,__x->_M_keys,__pos * sizeof(_Key));
+        __keys[__pos] = __k;
+        std::memcpy(__keys + __pos + 1,__x->_M_keys + __pos,(_Nb - __pos) * sizeof(_Key));
+
+        const unsigned int __half = (_Nb + 1) / 2;
+        std::memcpy(__x->_M_keys,__keys,__half * sizeof(_Key));
+        std::memcpy(__z->_M_keys,__keys + __half,(_Nb + 1 - __half) * sizeof(_Key));
+        __z->_M_count = __z->_M_size = _Nb + 1 - __half;
+        _M_draw_priority(__z);
+
+        // __x loses the moved keys,so does every block on the path down to it
+        for (_Node* __y = _M_root; __y != __x; __y = _M_insert_step(__y,__k))
+            __y->_M_size -= _Nb - __half;
+        __x->_M_count = __half;
+        __x->_M_maintain();
+
+        // keys equal to the first one of __z may sit on either side,they all order before the rest of __z
+        _Node *__l,*__r;
+        _M_split(_M_root,__z->_M_min(),true,__l,__r);
+        _M_root = _M_merge(_M_merge(__l,__z),__r);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    typename _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::size_type _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::erase(const key_type& __k) {
+        size_type __n = 0;
+        for (;;) {
+            // the first block holding a key not less than __k,and the link it hangs from
+            _Node** __slot = &_M_root;
+            _Node** __found = nullptr;
+            unsigned int __pos = 0;
+            while (*__slot != nullptr) {
+                _Node* __y = *__slot;
+                if (_M_key_compare(__y->_M_max(),__k))
+                    __slot = &__y->_M_children[Direction_Right];
+                else if (!_M_key_compare(__y->_M_min(),__k)) {
+                    __found = __slot;
+                    __pos = 0;
+                    __slot = &__y->_M_children[Direction_Left];
+                }
+                else {
+                    __found = __slot;
+                    __pos = _M_lower(__y,__k);
+                    break;
+                }
+            }
+            if (__found == nullptr)
+                break;
+            _Node* __x = *__found;
+            if (_M_key_compare(__k,__x->_M_keys[__pos]))
+                break;
+
+            const unsigned int __m = _M_upper(__x,__k) - __pos;
+            for (_Node* __y = _M_root; __y != __x; ) {
+                __y->_M_size -= __m;
+                if (_M_key_compare(__y->_M_max(),__k))
+                    __y = __y->_M_children[Direction_Right];
+                else
+                    __y = __y->_M_children[Direction_Left];
+            }
+            std::memmove(__x->_M_keys + __pos,__x->_M_keys + __pos + __m,(__x->_M_count - __pos - __m) * sizeof(_Key));
+            __x->_M_count -= __m;
+            __x->_M_size -= __m;
+            __n += __m;
+
+            if (__x->_M_count == 0) {
+                *__found = _M_merge(__x->_M_children[Direction_Left],__x->_M_children[Direction_Right]);
+                _M_put_node(__x);
+            }
+            else if (__x->_M_count < _Nb / 2)
+                _M_absorb_successor(__x);
+        }
+        return __n;
+    }
+
+    /*
+     * @brief move the keys of the block after __x into __x if they fit,then free that block
+     *
+     * Only a successor below __x is taken,it is the leftmost block of the right subtree and has no
+     * left child,so unlinking it cannot touch the sizes above __x.
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    void _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::_M_absorb_successor(_Node* __x) {
+        _Node** __slot = &__x->_M_children[Direction_Right];
+        if (*__slot == nullptr)
+            return;
+        while ((*__slot)->_M_children[Direction_Left] != nullptr)
+            __slot = &(*__slot)->_M_children[Direction_Left];
+        _Node* __s = *__slot;
+        if (__x->_M_count + __s->_M_count > _Nb)
+            return;
+
+        std::memcpy(__x->_M_keys + __x->_M_count,__s->_M_keys,__s->_M_count * sizeof(_Key));
+        __x->_M_count += __s->_M_count;
+        for (_Node* __y = __x->_M_children[Direction_Right]; __y != __s; __y = __y->_M_children[Direction_Left])
+            __y->_M_size -= __s->_M_count;
+        *__slot = __s->_M_children[Direction_Right];
+        _M_put_node(__s);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    void _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::_M_erase_all(_Node* __x) {
+        while (__x != nullptr) {
+            _Node* __y = __x->_M_children[Direction_Left];
+            if (__y != nullptr) {
+                __x->_M_children[Direction_Left] = __y->_M_children[Direction_Right];
+                __y->_M_children[Direction_Right] = __x;
+                __x = __y;
+            }
+            else {
+                __y = __x->_M_children[Direction_Right];
+                _M_put_node(__x);
+                __x = __y;
+            }
+        }
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    typename _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::size_type _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::block_count() const {
+        size_type __n = 0;
+        for (const_iterator __it = begin(); __it != end(); __it._M_next_block())
+            ++__n;
+        return __n;
+    }
+
+    /*
+     * @brief in-order walk on an explicit stack,there are no parent links to climb
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    bool _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::__block_treap_verify() const {
+        std::vector<const _Node*> __pending;
+        const _Key* __prev = nullptr;
+        size_type __count = 0;
+        for (const _Node* __x = _M_root; __x != nullptr || !__pending.empty(); ) {
+            if (__x != nullptr) {
+                if (__x->_M_count == 0 || __x->_M_count > _Nb)
+                    return false;
+                unsigned int __size = __x->_M_count;
+                for (unsigned int __dir = Direction_Left; __dir <= Direction_Right; ++__dir) {
+                    const _Node* __c = __x->_M_children[__dir];
+                    if (__c == nullptr)
+                        continue;
+                    if (__c->_M_Priority > __x->_M_Priority)
+                        return false;
+                    __size += __c->_M_size;
+                }
+                if (__x->_M_size != __size)
+                    return false;
+                __pending.push_back(__x);
+                __x = __x->_M_children[Direction_Left];
+                continue;
+            }
+            __x = __pending.back();
+            __pending.pop_back();
+            for (unsigned int __i = 0; __i < __x->_M_count; ++__i) {
+                if (__prev != nullptr && _M_key_compare(__x->_M_keys[__i],*__prev))
+                    return false;
+                __prev = __x->_M_keys + __i;
+            }
+            __count += __x->_M_count;
+            __x = __x->_M_children[Direction_Right];
+        }
+        return __count == size();
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    typename _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::const_iterator _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::lower_bound(const key_type& __k) const {
+        const_iterator __it;
+        __it._M_root = _M_root;
+        // __before counts the keys of the blocks left of __x,the last candidate becomes pending when a nearer one shows up
+        size_type __before = 0;
+        const _Node* __x = _M_root;
+        while (__x != nullptr) {
+            if (_M_key_compare(__x->_M_max(),__k)) {
+                __before += _S_size(__x->_M_children[Direction_Left]) + __x->_M_count;
+                __x = __x->_M_children[Direction_Right];
+            }
+            else {
+                if (__it._M_node != nullptr)
+                    __it._M_push(__it._M_node);
+                __it._M_node = __x;
+                __it._M_rank = __before + _S_size(__x->_M_children[Direction_Left]);
+                if (!_M_key_compare(__x->_M_min(),__k)) {
+                    __it._M_pos = 0;
+                    __x = __x->_M_children[Direction_Left];
+                }
+                else {
+                    __it._M_pos = _M_lower(__x,__k);
+                    break;
+                }
+            }
+            if (__x != nullptr)
+                _S_prefetch(__x);
+        }
+        return __it;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    bool _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::contains(const key_type& __k) const {
+        const _Node* __x = _M_root;
+        while (__x != nullptr) {
+            _S_prefetch(__x);
+            if (_M_key_compare(__x->_M_max(),__k))
+                __x = __x->_M_children[Direction_Right];
+            else if (_M_key_compare(__k,__x->_M_min()))
+                __x = __x->_M_children[Direction_Left];
+            else {
+                const unsigned int __pos = _M_lower(__x,__k);
+                return !_M_key_compare(__k,__x->_M_keys[__pos]);
+            }
+        }
+        return false;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    typename _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::size_type _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::_M_count_before(const _Key& __k,bool __upper) const {
+        size_type __n = 0;
+        const _Node* __x = _M_root;
+        while (__x != nullptr) {
+            const bool __all = __upper ? !_M_key_compare(__k,__x->_M_max()) : _M_key_compare(__x->_M_max(),__k);
+            const bool __none = __upper ? _M_key_compare(__k,__x->_M_min()) : !_M_key_compare(__x->_M_min(),__k);
+            if (__all) {
+                __n += _S_size(__x->_M_children[Direction_Left]) + __x->_M_count;
+                __x = __x->_M_children[Direction_Right];
+            }
+            else if (__none)
+                __x = __x->_M_children[Direction_Left];
+            else
+                return __n + _S_size(__x->_M_children[Direction_Left]) + (__upper ? _M_upper(__x,__k) : _M_lower(__x,__k));
+        }
+        return __n;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    template <typename _InputIterator>
+    void _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::_M_append_sorted(_InputIterator& __first,_InputIterator __last) {
+        // the right spine of the tree built so far,bottom last
+        std::vector<_Node*> __spine;
+        for (_Node* __x = _M_root; __x != nullptr; __x = __x->_M_children[Direction_Right])
+            __spine.push_back(__x);
+
+        _Node* __block = nullptr;
+        try {
+            while (__first != __last) {
+                if (!__spine.empty() && _M_key_compare(*__first,__spine.back()->_M_max()))
+                    break;
+                __block = _M_create_node();
+                for (; __first != __last && __block->_M_count < _Nb; ++__first) {
+                    if (__block->_M_count > 0 && _M_key_compare(*__first,__block->_M_max()))
+                        break;
+                    __block->_M_keys[__block->_M_count++] = *__first;
+                }
+                _M_draw_priority(__block);
+
+                _Node* __popped = nullptr;
+                while (!__spine.empty() && __spine.back()->_M_Priority < __block->_M_Priority) {
+                    __popped = __spine.back();
+                    __popped->_M_maintain();
+                    __spine.pop_back();
+                }
+                __block->_M_children[Direction_Left] = __popped;
+                if (__spine.empty())
+                    _M_root = __block;
+                else
+                    __spine.back()->_M_children[Direction_Right] = __block;
+                __spine.push_back(__block);
+                __block = nullptr;
+            }
+        }
+        catch (...) {
+            if (__block != nullptr)
+                _M_put_node(__block);
+            while (!__spine.empty()) {
+                __spine.back()->_M_maintain();
+                __spine.pop_back();
+            }
+            throw;
+        }
+        while (!__spine.empty()) {
+            __spine.back()->_M_maintain();
+            __spine.pop_back();
+        }
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen> _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::split(const key_type& __k) {
+        _Block_treap __r(_M_key_compare,allocator_type(_M_alloc),_M_fork_priority(_M_priority_gen,0));
+        _M_reserve_spare();
+        _M_split(_M_root,__k,false,_M_root,__r._M_root);
+        return __r;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    void _Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>::merge(_Block_treap& __x) {
+        if (this == &__x || __x._M_root == nullptr)
+            return;
+        if (_M_root == nullptr) {
+            std::swap(_M_root,__x._M_root);
+            return;
+        }
+
+        const _Node* __lmax = _M_root;
+        while (__lmax->_M_children[Direction_Right] != nullptr)
+            __lmax = __lmax->_M_children[Direction_Right];
+        const _Node* __rmin = __x._M_root;
+        while (__rmin->_M_children[Direction_Left] != nullptr)
+            __rmin = __rmin->_M_children[Direction_Left];
+        if (!_M_key_compare(__rmin->_M_min(),__lmax->_M_max())) {
+            _M_root = _M_merge(_M_root,__x._M_root);
+            __x._M_root = nullptr;
+            return;
+        }
+
+        const _Node* __lmin = _M_root;
+        while (__lmin->_M_children[Direction_Left] != nullptr)
+            __lmin = __lmin->_M_children[Direction_Left];
+        const _Node* __rmax = __x._M_root;
+        while (__rmax->_M_children[Direction_Right] != nullptr)
+            __rmax = __rmax->_M_children[Direction_Right];
+        if (!_M_key_compare(__lmin->_M_min(),__rmax->_M_max())) {
+            _M_root = _M_merge(__x._M_root,_M_root);
+            __x._M_root = nullptr;
+            return;
+        }
+
+        for (const_iterator __it = __x.begin(); __it != __x.end(); ++__it)
+            insert(*__it);
+        __x.clear();
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,unsigned int _Nb,typename _PriorityGen>
+    inline void swap(_Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>& __x,_Block_treap<_Key,_Compare,_Alloc,_Nb,_PriorityGen>& __y) noexcept { __x.swap(__y); }
+}
+
+#endif
@@ -0,0 +1,344 @@
+// Index-linked compact Treap implementation -*- C++ -*-
+// @file treap_index.hpp
+
+#ifndef _TREAP_INDEX_H_
+#define _TREAP_INDEX_H_ 1
+
+#include <cstdint>
+#include <vector>
+#include <iterator>
+#include <stdexcept>
+#include "treap.hpp"
+
+namespace TreapTree {
+
+    typedef std::uint32_t _Index_type;
+
+    static const _Index_type _S_index_nil = std::numeric_limits<_Index_type>::max();
+
+    /*
+     * @brief node of _Index_treap,links are positions in the node array
+     *
+     * There is no parent link and no subtree size,for a 4-byte key a node is 16 bytes
+     * instead of the 40 bytes of _Treap_node.The value is a plain member so the node
+     * array can relocate it with its move constructor.
+     */
+    template <typename _Val>
+    struct _Index_treap_node
+    {
+        _Index_type _M_children[2];
+        unsigned int _M_Priority;
+
+        _Val _M_value;
+
+        template <typename... _Args>
+        explicit _Index_treap_node(_Args&&... __args) : _M_children{_S_index_nil,_S_index_nil},_M_Priority(0),_M_value(std::forward<_Args>(__args)...) {}
+
+        _Val* _M_valptr() { return std::__addressof(_M_value); }
+
+        const _Val* _M_valptr() const { return std::__addressof(_M_value); }
+    };
+
+    /*
+     * @brief forward iterator of _Index_treap,keeps the pending ancestors on a finger stack
+     *
+     * Any insertion may relocate the node array and invalidates every iterator.
+     */
+    template <typename _Val>
+    struct _Index_treap_const_iterator
+    {
+        typedef _Val value_type;
+        typedef const _Val* pointer;
+        typedef const _Val& reference;
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::ptrdiff_t difference_type;
+
+        typedef _Index_treap_const_iterator<_Val> _Self;
+        typedef const _Index_treap_node<_Val>* _Node_array;
+
+        _Index_treap_const_iterator() : _M_nodes() {}
+
+        _Index_treap_const_iterator(_Node_array __nodes) : _M_nodes(__nodes) {}
+
+        reference operator* () const { return *_M_nodes[_M_stack.back()]._M_valptr(); }
+
+        pointer operator->() const { return _M_nodes[_M_stack.back()]._M_valptr(); }
+
+        _Self& operator++() {
+            _Index_type __x = _M_nodes[_M_stack.back()]._M_children[Direction_Right];
+            _M_stack.pop_back();
+            _M_push_left(__x);
+            return *this;
+        }
+
+        _Self operator++(int) {
+            _Self __tmp = *this;
+            ++*this;
+            return __tmp;
+        }
+
+        bool operator == (const _Self& __x) const {
+            return _M_stack.empty() ? __x._M_stack.empty() : (!__x._M_stack.empty() && _M_stack.back() == __x._M_stack.back());
+        }
+
+        bool operator != (const _Self& __x) const { return !(*this == __x); }
+
+        void _M_push_left(_Index_type __x) {
+            for (; __x != _S_index_nil; __x = _M_nodes[__x]._M_children[Direction_Left])
+                _M_stack.push_back(__x);
+        }
+
+        _Node_array _M_nodes;
+        std::vector<_Index_type> _M_stack;
+    };
+
+    /*
+     * @brief Treap whose nodes live in one contiguous array and link by 32-bit index
+     *
+     * Same multiset semantics as _Treap,but without parent links insertion works top-down:
+     * descend while the priorities stay above the new node's,then split the remaining
+     * subtree around it.Erased slots are recycled through a free list.
+     */
+    template <typename _Key,typename _Compare = std::less<_Key>,typename _Alloc = std::allocator<_Key>>
+    class _Index_treap
+    {
+        typedef _Index_treap_node<_Key> _Node;
+        typedef typename __gnu_cxx::__alloc_traits<_Alloc>::template rebind<_Node>::other _Node_allocator;
+
+    public :
+        typedef _Key key_type;
+        typedef _Key value_type;
+        typedef const value_type& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _Alloc allocator_type;
+
+        typedef _Index_treap_const_iterator<value_type> const_iterator;
+        typedef const_iterator iterator;
+
+    private :
+        std::vector<_Node,_Node_allocator> _M_nodes;
+        _Compare _M_key_compare;
+        _Index_type _M_root = _S_index_nil;
+        _Index_type _M_free = _S_index_nil;
+        size_type _M_count = 0;
+
+        const _Key& _M_key(_Index_type __x) const { return *_M_nodes[__x]._M_valptr(); }
+
+        _Index_type& _M_child(_Index_type __x,unsigned int __dir) { return _M_nodes[__x]._M_children[__dir]; }
+
+        template <typename... _Args>
+        _Index_type _M_create_node(_Args&&... __args);
+
+        // the value of a freed slot stays alive until the slot is reused or the array is cleared
+        void _M_drop_node(_Index_type __x) {
+            _M_nodes[__x]._M_children[Direction_Left] = _M_free;
+            _M_free = __x;
+        }
+
+        template <typename _Pred>
+        void _M_split(_Index_type __t,_Pred __goes_left,_Index_type& __l,_Index_type& __r);
+
+        _Index_type _M_merge(_Index_type __l,_Index_type __r);
+
+    public :
+        _Index_treap() {}
+
+        explicit _Index_treap(const _Compare& __comp,const allocator_type& __a = allocator_type()) : _M_nodes(_Node_allocator(__a)),_M_key_compare(__comp) {}
+
+        _Index_treap(const _Index_treap& __x) : _M_nodes(__x._M_nodes.get_allocator()),_M_key_compare(__x._M_key_compare) {
+            _M_nodes.reserve(__x._M_count);
+            for (const_iterator __it = __x.begin(); __it != __x.end(); ++__it)
+                emplace(*__it);
+        }
+
+        _Index_treap(_Index_treap&& __x) : _M_nodes(std::move(__x._M_nodes)),_M_key_compare(__x._M_key_compare),_M_root(__x._M_root),_M_free(__x._M_free),_M_count(__x._M_count) {
+            __x._M_nodes.clear();
+            __x._M_root = __x._M_free = _S_index_nil;
+            __x._M_count = 0;
+        }
+
+        _Index_treap& operator = (const _Index_treap&) = delete;
+
+        const_iterator begin() const {
+            const_iterator __it(_M_nodes.data());
+            __it._M_push_left(_M_root);
+            return __it;
+        }
+
+        const_iterator end() const { return const_iterator(_M_nodes.data()); }
+
+        size_type size() const { return _M_count; }
+
+        bool empty() const { return _M_count == 0; }
+
+        /*
+         * @brief pre-sizes the node array so the next __n insertions do not relocate it
+         */
+        void reserve(size_type __n) { _M_nodes.reserve(__n); }
+
+        void clear() {
+            _M_nodes.clear();
+            _M_root = _M_free = _S_index_nil;
+            _M_count = 0;
+        }
+
+        /*
+         * @brief Builds and inserts an element into the Treap
+         * @param __args Arguments used to generate the element instance to be inserted;
+         */
+        template <typename... _Args>
+        void emplace(_Args&&... __args);
+
+        /*
+         * @brief Removes every element equivalent to __k
+         * @return number of elements removed
+         */
+        size_type erase(const key_type& __k);
+
+        const_iterator lower_bound(const key_type& __k) const;
+
+        const_iterator find(const key_type& __k) const {
+            const_iterator __it = lower_bound(__k);
+            return (__it == end() || _M_key_compare(__k,*__it)) ? end() : __it;
+        }
+
+        /*
+         * @brief membership test that walks the array without building an iterator
+         */
+        bool contains(const key_type& __k) const {
+            _Index_type __x = _M_root;
+            while (__x != _S_index_nil) {
+                if (_M_key_compare(__k,_M_key(__x)))
+                    __x = _M_nodes[__x]._M_children[Direction_Left];
+                else if (_M_key_compare(_M_key(__x),__k))
+                    __x = _M_nodes[__x]._M_children[Direction_Right];
+                else
+                    return true;
+            }
+            return false;
+        }
+    };
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    template <typename... _Args>
+    _Index_type _Index_treap<_Key,_Compare,_Alloc>::_M_create_node(_Args&&... __args) {
+        _Index_type __x = _M_free;
+        if (__x == _S_index_nil) {
+            if (_M_nodes.size() >= _S_index_nil)
+                throw std::length_error("_Index_treap::_M_create_node");
+            _M_nodes.emplace_back(std::forward<_Args>(__args)...);
+            __x = static_cast<_Index_type>(_M_nodes.size() - 1);
+        }
+        else {
+            _M_nodes[__x]._M_value = _Key(std::forward<_Args>(__args)...);
+            _M_free = _M_nodes[__x]._M_children[Direction_Left];
+        }
+
+        _M_nodes[__x]._M_children[Direction_Left] = _S_index_nil;
+        _M_nodes[__x]._M_children[Direction_Right] = _S_index_nil;
+        _M_nodes[__x]._M_Priority = generaterand();
+        return __x;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    template <typename _Pred>
+    void _Index_treap<_Key,_Compare,_Alloc>::_M_split(_Index_type __t,_Pred __goes_left,_Index_type& __l,_Index_type& __r) {
+        _Index_type* __lslot = &__l;
+        _Index_type* __rslot = &__r;
+        while (__t != _S_index_nil) {
+            if (__goes_left(__t)) {
+                *__lslot = __t;
+                __lslot = &_M_child(__t,Direction_Right);
+                __t = *__lslot;
+            }
+            else {
+                *__rslot = __t;
+                __rslot = &_M_child(__t,Direction_Left);
+                __t = *__rslot;
+            }
+        }
+        *__lslot = _S_index_nil;
+        *__rslot = _S_index_nil;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    _Index_type _Index_treap<_Key,_Compare,_Alloc>::_M_merge(_Index_type __l,_Index_type __r) {
+        _Index_type __root = _S_index_nil;
+        _Index_type* __slot = &__root;
+        while (__l != _S_index_nil && __r != _S_index_nil) {
+            if (_M_nodes[__l]._M_Priority > _M_nodes[__r]._M_Priority) {
+                *__slot = __l;
+                __slot = &_M_child(__l,Direction_Right);
+                __l = *__slot;
+            }
+            else {
+                *__slot = __r;
+                __slot = &_M_child(__r,Direction_Left);
+                __r = *__slot;
+            }
+        }
+        *__slot = __l != _S_index_nil ? __l : __r;
+        return __root;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    template <typename... _Args>
+    void _Index_treap<_Key,_Compare,_Alloc>::emplace(_Args&&... __args) {
+        _Index_type __z = _M_create_node(std::forward<_Args>(__args)...);
+        const unsigned int __prio = _M_nodes[__z]._M_Priority;
+
+        _Index_type* __slot = &_M_root;
+        while (*__slot != _S_index_nil && _M_nodes[*__slot]._M_Priority >= __prio) {
+            unsigned int __dir = _M_key_compare(_M_key(__z),_M_key(*__slot)) ? Direction_Left : Direction_Right;
+            __slot = &_M_child(*__slot,__dir);
+        }
+
+        // equal keys go to the left of __z,matching _Treap's insert_equal order
+        _M_split(*__slot,[&](_Index_type __x) { return !_M_key_compare(_M_key(__z),_M_key(__x)); },
+                 _M_child(__z,Direction_Left),_M_child(__z,Direction_Right));
+        *__slot = __z;
+        ++_M_count;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    typename _Index_treap<_Key,_Compare,_Alloc>::size_type
+    _Index_treap<_Key,_Compare,_Alloc>::erase(const key_type& __k) {
+        size_type __n = 0;
+        _Index_type* __slot = &_M_root;
+        while (*__slot != _S_index_nil) {
+            _Index_type __x = *__slot;
+            if (_M_key_compare(__k,_M_key(__x)))
+                __slot = &_M_child(__x,Direction_Left);
+            else if (_M_key_compare(_M_key(__x),__k))
+                __slot = &_M_child(__x,Direction_Right);
+            else {
+                // the merged children take __x's place and may hold further equal keys
+                *__slot = _M_merge(_M_child(__x,Direction_Left),_M_child(__x,Direction_Right));
+                _M_drop_node(__x);
+                ++__n;
+            }
+        }
+        _M_count -= __n;
+        return __n;
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc>
+    typename _Index_treap<_Key,_Compare,_Alloc>::const_iterator
+    _Index_treap<_Key,_Compare,_Alloc>::lower_bound(const key_type& __k) const {
+        const_iterator __it(_M_nodes.data());
+        _Index_type __x = _M_root;
+        while (__x != _S_index_nil) {
+            if (!_M_key_compare(_M_key(__x),__k)) {
+                __it._M_stack.push_back(__x);
+                __x = _M_nodes[__x]._M_children[Direction_Left];
+            }
+            else
+                __x = _M_nodes[__x]._M_children[Direction_Right];
+        }
+        return __it;
+    }
+}
+
+#endif
@@ -0,0 +1,480 @@
+// Unique-key Treap containers -*- C++ -*-
+// @file treap_map.hpp
+
+#ifndef _TREAP_MAP_H_
+#define _TREAP_MAP_H_ 1
+
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "treap.hpp"
+
+namespace TreapTree {
+
+    /*
+     * @brief ordered set of unique keys on top of _Treap,with the std::set interface
+     *
+     * Iterators are constant,besides the usual lookups it offers the order statistics of _Treap.
+     */
+    template <typename _Key,typename _Compare = std::less<_Key>,typename _Alloc = std::allocator<_Key>,typename _PriorityGen = treap_random_priority>
+    class treap_set
+    {
+        typedef _Treap<_Key,_Compare,_Alloc,_Key,std::_Identity<_Key>,_PriorityGen> _Rep_type;
+
+        _Rep_type _M_t;
+
+    public :
+        typedef _Key key_type;
+        typedef _Key value_type;
+        typedef _Compare key_compare;
+        typedef _Compare value_compare;
+        typedef _Alloc allocator_type;
+        typedef typename _Rep_type::size_type size_type;
+        typedef typename _Rep_type::difference_type difference_type;
+        typedef typename _Rep_type::const_reference reference;
+        typedef typename _Rep_type::const_reference const_reference;
+        typedef typename _Rep_type::const_iterator iterator;
+        typedef typename _Rep_type::const_iterator const_iterator;
+        typedef typename _Rep_type::range_type range_type;
+        typedef typename _Rep_type::reverse_range_type reverse_range_type;
+        typedef typename _Rep_type::node_type node_type;
+        typedef typename _Rep_type::insert_return_type insert_return_type;
+
+        treap_set() {}
+
+        explicit treap_set(const _Compare& __comp,const allocator_type& __a = allocator_type(),const _PriorityGen& __gen = _PriorityGen())
+        : _M_t(__comp,__a,__gen) {}
+
+        template <typename _InputIterator>
+        treap_set(_InputIterator __first,_InputIterator __last,const _Compare& __comp = _Compare(),const allocator_type& __a = allocator_type(),
+                  const _PriorityGen& __gen = _PriorityGen())
+        : _M_t(__comp,__a,__gen) {
+            insert(__first,__last);
+        }
+
+        treap_set(std::initializer_list<value_type> __l,const _Compare& __comp = _Compare(),const allocator_type& __a = allocator_type(),
+                  const _PriorityGen& __gen = _PriorityGen())
+        : _M_t(__comp,__a,__gen) {
+            insert(__l.begin(),__l.end());
+        }
+
+        allocator_type get_allocator() const { return _M_t.get_allocator(); }
+
+        iterator begin() const { return _M_t.begin(); }
+
+        iterator end() const { return _M_t.end(); }
+
+        size_type size() const { return _M_t.size(); }
+
+        bool empty() const { return _M_t.empty(); }
+
+        void clear() { _M_t.clear(); }
+
+        void swap(treap_set& __x) noexcept { _M_t.swap(__x._M_t); }
+
+        void compact() { _M_t.compact(); }
+
+        std::pair<iterator,bool> insert(const value_type& __v) { return _M_t.insert_unique(__v); }
+
+        std::pair<iterator,bool> insert(value_type&& __v) { return _M_t.insert_unique(std::move(__v)); }
+
+        iterator insert(const_iterator __hint,const value_type& __v) { return _M_t._M_emplace_hint_unique_key(__hint,__v,__v).first; }
+
+        iterator insert(const_iterator __hint,value_type&& __v) { return _M_t._M_emplace_hint_unique_key(__hint,__v,std::move(__v)).first; }
+
+        insert_return_type insert(node_type&& __nh) { return _M_t.insert_unique(std::move(__nh)); }
+
+        /*
+         * @brief insert() of a node handle,the hint is not used and __nh keeps the node if it is not linked
+         */
+        iterator insert(const_iterator,node_type&& __nh) {
+            insert_return_type __r = _M_t.insert_unique(std::move(__nh));
+            if (!__r.inserted)
+                __nh = std::move(__r.node);
+            return __r.position;
+        }
+
+        node_type extract(const_iterator __position) { return _M_t.extract(__position); }
+
+        node_type extract(const key_type& __k) { return _M_t.extract(__k); }
+
+        /*
+         * @brief Moves [__first,__last) of __x here without reallocating,keys already present stay in __x
+         */
+        void splice(treap_set& __x,const_iterator __first,const_iterator __last) { _M_t.splice_unique(__x._M_t,__first,__last); }
+
+        /*
+         * @brief Inserts [__first,__last) with end() as hint,so sorted input is appended in O(1) comparisons each
+         */
+        template <typename _InputIterator>
+        void insert(_InputIterator __first,_InputIterator __last) {
+            for (; __first != __last; ++__first)
+                _M_t._M_emplace_hint_unique_key(end(),*__first,*__first);
+        }
+
+        template <typename... _Args>
+        std::pair<iterator,bool> emplace(_Args&&... __args) { return _M_t.emplace_unique(std::forward<_Args>(__args)...); }
+
+        template <typename... _Args>
+        iterator emplace_hint(const_iterator __hint,_Args&&... __args) { return _M_t.emplace_hint_unique(__hint,std::forward<_Args>(__args)...).first; }
+
+        iterator erase(const_iterator __position) { return _M_t.erase(__position); }
+
+        size_type erase(const key_type& __k) { return _M_t.erase(__k); }
+
+        iterator erase(const_iterator __first,const_iterator __last) { return _M_t.erase(__first,__last); }
+
+        size_type erase_range(const key_type& __lo,const key_type& __hi) { return _M_t.erase_range(__lo,__hi); }
+
+        template <typename _Predicate>
+        size_type erase_if(_Predicate __pred) { return _M_t.erase_if(__pred); }
+
+        iterator find_from(const_iterator __hint,const key_type& __k) const { return _M_t.find_from(__hint,__k); }
+
+        template <typename _ForwardIterator,typename _OutputIterator>
+        _OutputIterator find_batch(_ForwardIterator __first,_ForwardIterator __last,_OutputIterator __out) const { return _M_t.find_batch(__first,__last,__out); }
+
+        template <typename _ForwardIterator,typename _OutputIterator>
+        _OutputIterator lower_bound_batch(_ForwardIterator __first,_ForwardIterator __last,_OutputIterator __out) const { return _M_t.lower_bound_batch(__first,__last,__out); }
+
+        iterator find(const key_type& __k) const { return _M_t.find(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        iterator find(const _Kt& __k) const { return _M_t.find(__k); }
+
+        size_type count(const key_type& __k) const { return _M_t.contains(__k) ? 1 : 0; }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        size_type count(const _Kt& __k) const { return _M_t.count(__k); }
+
+        bool contains(const key_type& __k) const { return _M_t.contains(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        bool contains(const _Kt& __k) const { return _M_t.contains(__k); }
+
+        iterator lower_bound(const key_type& __k) const { return _M_t.lower_bound(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        iterator lower_bound(const _Kt& __k) const { return _M_t.lower_bound(__k); }
+
+        iterator upper_bound(const key_type& __k) const { return _M_t.upper_bound(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        iterator upper_bound(const _Kt& __k) const { return _M_t.upper_bound(__k); }
+
+        std::pair<iterator,iterator> equal_range(const key_type& __k) const { return _M_t.equal_range(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        std::pair<iterator,iterator> equal_range(const _Kt& __k) const { return _M_t.equal_range(__k); }
+
+        range_type range() const { return _M_t.range(); }
+
+        range_type range(const key_type& __lo,const key_type& __hi) const { return _M_t.range(__lo,__hi); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        range_type range(const _Kt& __lo,const _Kt& __hi) const { return _M_t.range(__lo,__hi); }
+
+        reverse_range_type reverse_range() const { return _M_t.reverse_range(); }
+
+        reverse_range_type reverse_range(const key_type& __lo,const key_type& __hi) const { return _M_t.reverse_range(__lo,__hi); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        reverse_range_type reverse_range(const _Kt& __lo,const _Kt& __hi) const { return _M_t.reverse_range(__lo,__hi); }
+
+        iterator find_by_order(size_type __k) const { return _M_t.find_by_order(__k); }
+
+        size_type order_of_key(const key_type& __k) const { return _M_t.order_of_key(__k); }
+
+        key_compare key_comp() const { return _M_t.key_comp(); }
+
+        bool __treap_verify() const { return _M_t.__treap_verify(); }
+    };
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _PriorityGen,typename _Predicate>
+    inline typename treap_set<_Key,_Compare,_Alloc,_PriorityGen>::size_type erase_if(treap_set<_Key,_Compare,_Alloc,_PriorityGen>& __s,_Predicate __pred) {
+        return __s.erase_if(__pred);
+    }
+
+    template <typename _Key,typename _Compare,typename _Alloc,typename _PriorityGen>
+    inline void swap(treap_set<_Key,_Compare,_Alloc,_PriorityGen>& __x,treap_set<_Key,_Compare,_Alloc,_PriorityGen>& __y) noexcept { __x.swap(__y); }
+
+    /*
+     * @brief ordered map of unique keys on top of _Treap,with the std::map interface
+     *
+     * try_emplace() and operator[] look the key up first and only build a node for a new key.
+     */
+    template <typename _Key,typename _Tp,typename _Compare = std::less<_Key>,typename _Alloc = std::allocator<std::pair<const _Key,_Tp>>,
+              typename _PriorityGen = treap_random_priority>
+    class treap_map
+    {
+    public :
+        typedef _Key key_type;
+        typedef _Tp mapped_type;
+        typedef std::pair<const _Key,_Tp> value_type;
+        typedef _Compare key_compare;
+        typedef _Alloc allocator_type;
+
+    private :
+        typedef _Treap<_Key,_Compare,_Alloc,value_type,std::_Select1st<value_type>,_PriorityGen> _Rep_type;
+
+        _Rep_type _M_t;
+
+    public :
+        typedef typename _Rep_type::size_type size_type;
+        typedef typename _Rep_type::difference_type difference_type;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef typename _Rep_type::iterator iterator;
+        typedef typename _Rep_type::const_iterator const_iterator;
+        typedef typename _Rep_type::range_type range_type;
+        typedef typename _Rep_type::reverse_range_type reverse_range_type;
+        typedef typename _Rep_type::node_type node_type;
+        typedef typename _Rep_type::insert_return_type insert_return_type;
+
+        treap_map() {}
+
+        explicit treap_map(const _Compare& __comp,const allocator_type& __a = allocator_type(),const _PriorityGen& __gen = _PriorityGen())
+        : _M_t(__comp,__a,__gen) {}
+
+        template <typename _InputIterator>
+        treap_map(_InputIterator __first,_InputIterator __last,const _Compare& __comp = _Compare(),const allocator_type& __a = allocator_type(),
+                  const _PriorityGen& __gen = _PriorityGen())
+        : _M_t(__comp,__a,__gen) {
+            insert(__first,__last);
+        }
+
+        treap_map(std::initializer_list<value_type> __l,const _Compare& __comp = _Compare(),const allocator_type& __a = allocator_type(),
+                  const _PriorityGen& __gen = _PriorityGen())
+        : _M_t(__comp,__a,__gen) {
+            insert(__l.begin(),__l.end());
+        }
+
+        allocator_type get_allocator() const { return _M_t.get_allocator(); }
+
+        iterator begin() { return _M_t.begin(); }
+
+        const_iterator begin() const { return _M_t.begin(); }
+
+        iterator end() { return _M_t.end(); }
+
+        const_iterator end() const { return _M_t.end(); }
+
+        size_type size() const { return _M_t.size(); }
+
+        bool empty() const { return _M_t.empty(); }
+
+        void clear() { _M_t.clear(); }
+
+        void swap(treap_map& __x) noexcept { _M_t.swap(__x._M_t); }
+
+        void compact() { _M_t.compact(); }
+
+        mapped_type& operator[](const key_type& __k) { return try_emplace(__k).first->second; }
+
+        mapped_type& operator[](key_type&& __k) { return try_emplace(std::move(__k)).first->second; }
+
+        mapped_type& at(const key_type& __k) {
+            iterator __it = _M_t.find(__k);
+            if (__it == end())
+                throw std::out_of_range("treap_map::at");
+            return __it->second;
+        }
+
+        const mapped_type& at(const key_type& __k) const {
+            const_iterator __it = _M_t.find(__k);
+            if (__it == end())
+                throw std::out_of_range("treap_map::at");
+            return __it->second;
+        }
+
+        std::pair<iterator,bool> insert(const value_type& __v) { return _M_t.insert_unique(__v); }
+
+        std::pair<iterator,bool> insert(value_type&& __v) { return _M_t.insert_unique(std::move(__v)); }
+
+        iterator insert(const_iterator __hint,const value_type& __v) { return _M_t._M_emplace_hint_unique_key(__hint,__v.first,__v).first; }
+
+        iterator insert(const_iterator __hint,value_type&& __v) { return _M_t._M_emplace_hint_unique_key(__hint,__v.first,std::move(__v)).first; }
+
+        insert_return_type insert(node_type&& __nh) { return _M_t.insert_unique(std::move(__nh)); }
+
+        /*
+         * @brief insert() of a node handle,the hint is not used and __nh keeps the node if it is not linked
+         */
+        iterator insert(const_iterator,node_type&& __nh) {
+            insert_return_type __r = _M_t.insert_unique(std::move(__nh));
+            if (!__r.inserted)
+                __nh = std::move(__r.node);
+            return __r.position;
+        }
+
+        node_type extract(const_iterator __position) { return _M_t.extract(__position); }
+
+        node_type extract(const key_type& __k) { return _M_t.extract(__k); }
+
+        /*
+         * @brief Moves [__first,__last) of __x here without reallocating,keys already present stay in __x
+         */
+        void splice(treap_map& __x,const_iterator __first,const_iterator __last) { _M_t.splice_unique(__x._M_t,__first,__last); }
+
+        /*
+         * @brief Inserts [__first,__last) with end() as hint,so sorted input is appended in O(1) comparisons each
+         */
+        template <typename _InputIterator>
+        void insert(_InputIterator __first,_InputIterator __last) {
+            for (; __first != __last; ++__first)
+                _M_t._M_emplace_hint_unique_key(end(),(*__first).first,*__first);
+        }
+
+        template <typename... _Args>
+        std::pair<iterator,bool> emplace(_Args&&... __args) { return _M_t.emplace_unique(std::forward<_Args>(__args)...); }
+
+        template <typename... _Args>
+        iterator emplace_hint(const_iterator __hint,_Args&&... __args) { return _M_t.emplace_hint_unique(__hint,std::forward<_Args>(__args)...).first; }
+
+        /*
+         * @brief Builds the mapped value from __args only if __k is not present yet
+         * @return the element with key __k,and whether it was inserted
+         */
+        template <typename... _Args>
+        std::pair<iterator,bool> try_emplace(const key_type& __k,_Args&&... __args) {
+            return _M_t._M_emplace_unique_key(__k,std::piecewise_construct,std::forward_as_tuple(__k),std::forward_as_tuple(std::forward<_Args>(__args)...));
+        }
+
+        template <typename... _Args>
+        std::pair<iterator,bool> try_emplace(key_type&& __k,_Args&&... __args) {
+            return _M_t._M_emplace_unique_key(__k,std::piecewise_construct,std::forward_as_tuple(std::move(__k)),std::forward_as_tuple(std::forward<_Args>(__args)...));
+        }
+
+        template <typename... _Args>
+        iterator try_emplace(const_iterator __hint,const key_type& __k,_Args&&... __args) {
+            return _M_t._M_emplace_hint_unique_key(__hint,__k,std::piecewise_construct,std::forward_as_tuple(__k),std::forward_as_tuple(std::forward<_Args>(__args)...)).first;
+        }
+
+        template <typename... _Args>
+        iterator try_emplace(const_iterator __hint,key_type&& __k,_Args&&... __args) {
+            return _M_t._M_emplace_hint_unique_key(__hint,__k,std::piecewise_construct,std::forward_as_tuple(std::move(__k)),std::forward_as_tuple(std::forward<_Args>(__args)...)).first;
+        }
+
+        template <typename _Obj>
+        std::pair<iterator,bool> insert_or_assign(const key_type& __k,_Obj&& __obj) {
+            std::pair<iterator,bool> __r = try_emplace(__k,std::forward<_Obj>(__obj));
+            if (!__r.second)
+                __r.first->second = std::forward<_Obj>(__obj);
+            return __r;
+        }
+
+        iterator erase(const_iterator __position) { return _M_t.erase(__position); }
+
+        iterator erase(iterator __position) { return _M_t.erase(__position); }
+
+        size_type erase(const key_type& __k) { return _M_t.erase(__k); }
+
+        iterator erase(const_iterator __first,const_iterator __last) { return _M_t.erase(__first,__last); }
+
+        size_type erase_range(const key_type& __lo,const key_type& __hi) { return _M_t.erase_range(__lo,__hi); }
+
+        template <typename _Predicate>
+        size_type erase_if(_Predicate __pred) { return _M_t.erase_if(__pred); }
+
+        iterator find(const key_type& __k) { return _M_t.find(__k); }
+
+        const_iterator find(const key_type& __k) const { return _M_t.find(__k); }
+
+        iterator find_from(const_iterator __hint,const key_type& __k) { return _M_t.find_from(__hint,__k); }
+
+        const_iterator find_from(const_iterator __hint,const key_type& __k) const { return _M_t.find_from(__hint,__k); }
+
+        template <typename _ForwardIterator,typename _OutputIterator>
+        _OutputIterator find_batch(_ForwardIterator __first,_ForwardIterator __last,_OutputIterator __out) { return _M_t.find_batch(__first,__last,__out); }
+
+        template <typename _ForwardIterator,typename _OutputIterator>
+        _OutputIterator find_batch(_ForwardIterator __first,_ForwardIterator __last,_OutputIterator __out) const { return _M_t.find_batch(__first,__last,__out); }
+
+        template <typename _ForwardIterator,typename _OutputIterator>
+        _OutputIterator lower_bound_batch(_ForwardIterator __first,_ForwardIterator __last,_OutputIterator __out) { return _M_t.lower_bound_batch(__first,__last,__out); }
+
+        template <typename _ForwardIterator,typename _OutputIterator>
+        _OutputIterator lower_bound_batch(_ForwardIterator __first,_ForwardIterator __last,_OutputIterator __out) const { return _M_t.lower_bound_batch(__first,__last,__out); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        iterator find(const _Kt& __k) { return _M_t.find(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        const_iterator find(const _Kt& __k) const { return _M_t.find(__k); }
+
+        size_type count(const key_type& __k) const { return _M_t.contains(__k) ? 1 : 0; }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        size_type count(const _Kt& __k) const { return _M_t.count(__k); }
+
+        bool contains(const key_type& __k) const { return _M_t.contains(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        bool contains(const _Kt& __k) const { return _M_t.contains(__k); }
+
+        iterator lower_bound(const key_type& __k) { return _M_t.lower_bound(__k); }
+
+        const_iterator lower_bound(const key_type& __k) const { return _M_t.lower_bound(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        iterator lower_bound(const _Kt& __k) { return _M_t.lower_bound(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        const_iterator lower_bound(const _Kt& __k) const { return _M_t.lower_bound(__k); }
+
+        iterator upper_bound(const key_type& __k) { return _M_t.upper_bound(__k); }
+
+        const_iterator upper_bound(const key_type& __k) const { return _M_t.upper_bound(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        iterator upper_bound(const _Kt& __k) { return _M_t.upper_bound(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        const_iterator upper_bound(const _Kt& __k) const { return _M_t.upper_bound(__k); }
+
+        std::pair<iterator,iterator> equal_range(const key_type& __k) { return _M_t.equal_range(__k); }
+
+        std::pair<const_iterator,const_iterator> equal_range(const key_type& __k) const { return _M_t.equal_range(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        std::pair<iterator,iterator> equal_range(const _Kt& __k) { return _M_t.equal_range(__k); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        std::pair<const_iterator,const_iterator> equal_range(const _Kt& __k) const { return _M_t.equal_range(__k); }
+
+        range_type range() const { return _M_t.range(); }
+
+        range_type range(const key_type& __lo,const key_type& __hi) const { return _M_t.range(__lo,__hi); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        range_type range(const _Kt& __lo,const _Kt& __hi) const { return _M_t.range(__lo,__hi); }
+
+        reverse_range_type reverse_range() const { return _M_t.reverse_range(); }
+
+        reverse_range_type reverse_range(const key_type& __lo,const key_type& __hi) const { return _M_t.reverse_range(__lo,__hi); }
+
+        template <typename _Kt,typename _Req = typename _Treap_transparent<_Compare,_Kt>::type>
+        reverse_range_type reverse_range(const _Kt& __lo,const _Kt& __hi) const { return _M_t.reverse_range(__lo,__hi); }
+
+        iterator find_by_order(size_type __k) { return _M_t.find_by_order(__k); }
+
+        const_iterator find_by_order(size_type __k) const { return _M_t.find_by_order(__k); }
+
+        size_type order_of_key(const key_type& __k) const { return _M_t.order_of_key(__k); }
+
+        key_compare key_comp() const { return _M_t.key_comp(); }
+
+        bool __treap_verify() const { return _M_t.__treap_verify(); }
+    };
+
+    template <typename _Key,typename _Tp,typename _Compare,typename _Alloc,typename _PriorityGen,typename _Predicate>
+    inline typename treap_map<_Key,_Tp,_Compare,_Alloc,_PriorityGen>::size_type erase_if(treap_map<_Key,_Tp,_Compare,_Alloc,_PriorityGen>& __m,_Predicate __pred) {
+        return __m.erase_if(__pred);
+    }
+
+    template <typename _Key,typename _Tp,typename _Compare,typename _Alloc,typename _PriorityGen>
+    inline void swap(treap_map<_Key,_Tp,_Compare,_Alloc,_PriorityGen>& __x,treap_map<_Key,_Tp,_Compare,_Alloc,_PriorityGen>& __y) noexcept { __x.swap(__y); }
+}
+
+#endif
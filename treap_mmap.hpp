@@ -0,0 +1,490 @@
+// Memory-mapped Treap file format -*- C++ -*-
+// @file treap_mmap.hpp
+
+#ifndef _TREAP_MMAP_H_
+#define _TREAP_MMAP_H_ 1
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "treap.hpp"
+
+namespace TreapTree {
+
+    /*
+     * @brief file layout shared by treap_save() and mapped_treap
+     *
+     * A _Treap_file_header,padded to _S_nodes_offset bytes,then _M_count nodes in preorder.
+     * Nodes refer to each other by index into that array,so the file can be mapped anywhere;
+     * _S_npos marks a missing child or parent.Integers are stored in native byte order.
+     */
+    struct _Treap_file_header
+    {
+        static const std::uint32_t _S_npos = 0xffffffffu;
+        static const std::size_t _S_nodes_offset = 64;
+
+        char _M_magic[8];
+        std::uint32_t _M_node_size;
+        std::uint32_t _M_value_size;
+        std::uint64_t _M_count;
+        std::uint32_t _M_root;
+        std::uint32_t _M_leftmost;
+        std::uint32_t _M_rightmost;
+        std::uint32_t _M_reserved;
+
+        static const char* _S_magic() { return "TREAPMM1"; }
+
+        /*
+         * @brief header of an empty tree,for objects with no file mapped
+         */
+        static const _Treap_file_header& _S_empty() {
+            static const _Treap_file_header __h = { { 'T','R','E','A','P','M','M','1' },0,0,0,_S_npos,_S_npos,_S_npos,0 };
+            return __h;
+        }
+    };
+
+    template <typename _Val>
+    struct _Treap_file_node
+    {
+        std::uint32_t _M_children[2];
+        std::uint32_t _M_parent;
+        std::uint32_t _M_size;
+        std::uint32_t _M_Priority;
+        __gnu_cxx::__aligned_membuf<_Val> _M_storage;
+
+        const _Val* _M_valptr() const { return _M_storage._M_ptr(); }
+    };
+
+    /*
+     * @brief Writes __t to __path in the format read by mapped_treap,in O(n) with no extra memory
+     *
+     * Nodes are written in preorder,so a node's children sit at index i + 1 and i + 1 + size(left)
+     * and their positions follow from the subtree sizes alone.
+     * @throw std::system_error if the file cannot be written
+     */
+    template <typename _Key,typename _Compare,typename _Alloc,typename _Val,typename _KeyOfValue,typename _PriorityGen>
+    void treap_save(const _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>& __t,const std::string& __path) {
+        static_assert(std::is_trivially_copy_constructible<_Val>::value && std::is_trivially_destructible<_Val>::value,
+                      "treap_save() stores element bytes as they are");
+        typedef _Treap_file_header _Header;
+
+        if (__t.size() >= _Header::_S_npos)
+            throw std::length_error("treap_save");
+
+        std::FILE* __f = std::fopen(__path.c_str(),"wb");
+        if (__f == nullptr)
+            throw std::system_error(errno,std::generic_category(),"treap_save");
+
+        const _Treap_node_base* __header = __t.end()._M_node;
+        const _Treap_node_base* __root = __header->_M_parent;
+        char __head[_Header::_S_nodes_offset] = {};
+        _Header __h;
+        std::memset(&__h,0,sizeof(__h));
+        std::memcpy(__h._M_magic,_Header::_S_magic(),sizeof(__h._M_magic));
+        __h._M_node_size = sizeof(_Treap_file_node<_Val>);
+        __h._M_value_size = sizeof(_Val);
+        __h._M_count = __t.size();
+        __h._M_root = __h._M_leftmost = __h._M_rightmost = _Header::_S_npos;
+        bool __ok = std::fwrite(__head,sizeof(__head),1,__f) == 1;
+
+        // preorder walk through parent links,__i is the index of __x in the file
+        std::uint32_t __i = 0;
+        for (const _Treap_node_base* __x = __root; __ok && __x != nullptr; ++__i) {
+            _Treap_file_node<_Val> __n;
+            std::memset(static_cast<void*>(&__n),0,sizeof(__n));
+            const _Treap_node_base* __l = __x->_M_children[Direction_Left];
+            const _Treap_node_base* __r = __x->_M_children[Direction_Right];
+            __n._M_children[Direction_Left] = __l == nullptr ? _Header::_S_npos : __i + 1;
+            __n._M_children[Direction_Right] = __r == nullptr ? _Header::_S_npos : __i + 1 + _M_subtree_size(__l);
+            if (__x == __root)
+                __n._M_parent = _Header::_S_npos;
+            else if (__x->_M_parent->_M_children[Direction_Left] == __x)
+                __n._M_parent = __i - 1;
+            else
+                __n._M_parent = __i - 1 - _M_subtree_size(__x->_M_parent->_M_children[Direction_Left]);
+            __n._M_size = __x->_M_size;
+            __n._M_Priority = __x->_M_Priority;
+            std::memcpy(static_cast<void*>(__n._M_storage._M_addr()),static_cast<const _Treap_node<_Val>*>(__x)->_M_valptr(),sizeof(_Val));
+            if (__x == __root)
+                __h._M_root = __i;
+            if (__x == __header->_M_children[Direction_Left])
+                __h._M_leftmost = __i;
+            if (__x == __header->_M_children[Direction_Right])
+                __h._M_rightmost = __i;
+            __ok = std::fwrite(&__n,sizeof(__n),1,__f) == 1;
+
+            if (__l != nullptr)
+                __x = __l;
+            else if (__r != nullptr)
+                __x = __r;
+            else {
+                // climb to the first ancestor reached from its left that still has a right subtree to visit
+                while (__x != __root && (__x->_M_parent->_M_children[Direction_Right] == __x || __x->_M_parent->_M_children[Direction_Right] == nullptr))
+                    __x = __x->_M_parent;
+                __x = __x == __root ? nullptr : __x->_M_parent->_M_children[Direction_Right];
+            }
+        }
+
+        __ok = __ok && std::fseek(__f,0,SEEK_SET) == 0 && std::fwrite(&__h,sizeof(__h),1,__f) == 1;
+        int __err = __ok ? 0 : errno;
+        if (std::fclose(__f) != 0 && __ok) {
+            __ok = false;
+            __err = errno;
+        }
+        if (!__ok)
+            throw std::system_error(__err != 0 ? __err : EIO,std::generic_category(),"treap_save");
+    }
+
+    /*
+     * @brief read-only Treap served straight from a file written by treap_save()
+     *
+     * Opening maps the file and checks it in one O(n) pass:every index must lie in range and the
+     * links must form a single tree whose sizes add up,so no later walk leaves the mapping or
+     * loops.Key order is not checked.Iteration,lookups and order statistics run on the mapping
+     * with the usual bounds.The elements are never modified;to_treap() copies them into a mutable _Treap
+     * in O(n).The file must come from a _Treap with the same _Val,_Compare and byte order.
+     */
+    template <typename _Key,typename _Compare = std::less<_Key>,typename _Val = _Key,typename _KeyOfValue = std::_Identity<_Key>>
+    class mapped_treap
+    {
+        typedef _Treap_file_header _Header;
+        typedef _Treap_file_node<_Val> _Node;
+
+    public :
+        typedef _Key key_type;
+        typedef _Val value_type;
+        typedef const _Val& reference;
+        typedef const _Val& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _Compare key_compare;
+
+        class const_iterator
+        {
+            friend class mapped_treap;
+
+            const _Node* _M_nodes;
+            const _Header* _M_header;
+            std::uint32_t _M_index;
+
+            const_iterator(const _Node* __nodes,const _Header* __h,std::uint32_t __i) : _M_nodes(__nodes),_M_header(__h),_M_index(__i) {}
+
+        public :
+            typedef _Val value_type;
+            typedef const _Val* pointer;
+            typedef const _Val& reference;
+            typedef std::bidirectional_iterator_tag iterator_category;
+            typedef std::ptrdiff_t difference_type;
+
+            const_iterator() : _M_nodes(),_M_header(),_M_index(_Header::_S_npos) {}
+
+            reference operator* () const { return *_M_nodes[_M_index]._M_valptr(); }
+
+            pointer operator->() const { return _M_nodes[_M_index]._M_valptr(); }
+
+            const_iterator& operator++() {
+                std::uint32_t __x = _M_index;
+                if (_M_nodes[__x]._M_children[Direction_Right] != _Header::_S_npos) {
+                    __x = _M_nodes[__x]._M_children[Direction_Right];
+                    while (_M_nodes[__x]._M_children[Direction_Left] != _Header::_S_npos)
+                        __x = _M_nodes[__x]._M_children[Direction_Left];
+                }
+                else {
+                    std::uint32_t __y = _M_nodes[__x]._M_parent;
+                    while (__y != _Header::_S_npos && _M_nodes[__y]._M_children[Direction_Right] == __x) {
+                        __x = __y;
+                        __y = _M_nodes[__y]._M_parent;
+                    }
+                    __x = __y;
+                }
+                _M_index = __x;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator __tmp = *this;
+                ++*this;
+                return __tmp;
+            }
+
+            const_iterator& operator--() {
+                std::uint32_t __x = _M_index;
+                if (__x == _Header::_S_npos)
+                    __x = _M_header->_M_rightmost;
+                else if (_M_nodes[__x]._M_children[Direction_Left] != _Header::_S_npos) {
+                    __x = _M_nodes[__x]._M_children[Direction_Left];
+                    while (_M_nodes[__x]._M_children[Direction_Right] != _Header::_S_npos)
+                        __x = _M_nodes[__x]._M_children[Direction_Right];
+                }
+                else {
+                    std::uint32_t __y = _M_nodes[__x]._M_parent;
+                    while (__y != _Header::_S_npos && _M_nodes[__y]._M_children[Direction_Left] == __x) {
+                        __x = __y;
+                        __y = _M_nodes[__y]._M_parent;
+                    }
+                    __x = __y;
+                }
+                _M_index = __x;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator __tmp = *this;
+                --*this;
+                return __tmp;
+            }
+
+            bool operator == (const const_iterator& __x) const { return _M_index == __x._M_index; }
+            bool operator != (const const_iterator& __x) const { return _M_index != __x._M_index; }
+        };
+
+        typedef const_iterator iterator;
+
+    private :
+        _Compare _M_key_compare;
+        void* _M_map = nullptr;
+        std::size_t _M_length = 0;
+        const _Header* _M_header = nullptr;
+        const _Node* _M_nodes = nullptr;
+
+        static const _Key& _S_key(const _Node& __x) { return _KeyOfValue()(*__x._M_valptr()); }
+
+        std::uint32_t _M_root() const { return _M_header->_M_root; }
+
+        template <typename _Kt>
+        std::uint32_t _M_lower_bound(const _Kt& __k) const {
+            std::uint32_t __x = _M_root(),__y = _Header::_S_npos;
+            while (__x != _Header::_S_npos) {
+                if (!_M_key_compare(_S_key(_M_nodes[__x]),__k)) {
+                    __y = __x;
+                    __x = _M_nodes[__x]._M_children[Direction_Left];
+                }
+                else
+                    __x = _M_nodes[__x]._M_children[Direction_Right];
+            }
+            return __y;
+        }
+
+        template <typename _Kt>
+        std::uint32_t _M_upper_bound(const _Kt& __k) const {
+            std::uint32_t __x = _M_root(),__y = _Header::_S_npos;
+            while (__x != _Header::_S_npos) {
+                if (_M_key_compare(__k,_S_key(_M_nodes[__x]))) {
+                    __y = __x;
+                    __x = _M_nodes[__x]._M_children[Direction_Left];
+                }
+                else
+                    __x = _M_nodes[__x]._M_children[Direction_Right];
+            }
+            return __y;
+        }
+
+        std::uint32_t _M_subtree_size(std::uint32_t __x) const { return __x == _Header::_S_npos ? 0 : _M_nodes[__x]._M_size; }
+
+        size_type _M_count_not_greater(const key_type& __k) const {
+            size_type __n = 0;
+            for (std::uint32_t __x = _M_root(); __x != _Header::_S_npos;) {
+                if (!_M_key_compare(__k,_S_key(_M_nodes[__x]))) {
+                    __n += _M_subtree_size(_M_nodes[__x]._M_children[Direction_Left]) + 1;
+                    __x = _M_nodes[__x]._M_children[Direction_Right];
+                }
+                else
+                    __x = _M_nodes[__x]._M_children[Direction_Left];
+            }
+            return __n;
+        }
+
+        const_iterator _M_iter(std::uint32_t __x) const { return const_iterator(_M_nodes,_M_header,__x); }
+
+        void _M_unmap() {
+            if (_M_map != nullptr)
+                ::munmap(_M_map,_M_length);
+            _M_map = nullptr;
+            _M_header = &_Header::_S_empty();
+            _M_nodes = nullptr;
+        }
+
+        /*
+         * @brief true if the nodes form one tree rooted at _M_root() with consistent links and sizes
+         *
+         * Every child must point back at its parent and every size must be one more than those of
+         * its children;no cycle can satisfy the sizes,so with a single parentless node holding
+         * _M_count elements the nodes are exactly that tree.
+         */
+        bool _M_valid() const {
+            const std::uint64_t __n = _M_header->_M_count;
+            if (__n >= _Header::_S_npos)
+                return false;
+            if (__n == 0)
+                return _M_root() == _Header::_S_npos && _M_header->_M_leftmost == _Header::_S_npos && _M_header->_M_rightmost == _Header::_S_npos;
+            if (_M_root() >= __n || _M_nodes[_M_root()]._M_parent != _Header::_S_npos || _M_nodes[_M_root()]._M_size != __n)
+                return false;
+
+            for (std::uint32_t __i = 0; __i < __n; ++__i) {
+                const _Node& __x = _M_nodes[__i];
+                std::uint64_t __size = 1;
+                for (unsigned int __dir = Direction_Left; __dir <= Direction_Right; ++__dir) {
+                    const std::uint32_t __c = __x._M_children[__dir];
+                    if (__c == _Header::_S_npos)
+                        continue;
+                    if (__c >= __n || _M_nodes[__c]._M_parent != __i)
+                        return false;
+                    __size += _M_nodes[__c]._M_size;
+                }
+                if (__x._M_children[Direction_Left] == __x._M_children[Direction_Right] && __x._M_children[Direction_Left] != _Header::_S_npos)
+                    return false;
+                if (__x._M_size != __size)
+                    return false;
+                if (__i != _M_root()) {
+                    const std::uint32_t __p = __x._M_parent;
+                    if (__p >= __n || (_M_nodes[__p]._M_children[Direction_Left] != __i && _M_nodes[__p]._M_children[Direction_Right] != __i))
+                        return false;
+                }
+            }
+
+            std::uint32_t __lo = _M_root(),__hi = _M_root();
+            while (_M_nodes[__lo]._M_children[Direction_Left] != _Header::_S_npos)
+                __lo = _M_nodes[__lo]._M_children[Direction_Left];
+            while (_M_nodes[__hi]._M_children[Direction_Right] != _Header::_S_npos)
+                __hi = _M_nodes[__hi]._M_children[Direction_Right];
+            return _M_header->_M_leftmost == __lo && _M_header->_M_rightmost == __hi;
+        }
+
+    public :
+        /*
+         * @brief Maps the file at __path
+         * @throw std::system_error if it cannot be opened,std::runtime_error if it was not written for this _Val
+         * or its links are corrupt
+         */
+        explicit mapped_treap(const std::string& __path,const _Compare& __comp = _Compare()) : _M_key_compare(__comp) {
+            int __fd = ::open(__path.c_str(),O_RDONLY);
+            if (__fd < 0)
+                throw std::system_error(errno,std::generic_category(),"mapped_treap");
+            struct stat __st;
+            if (::fstat(__fd,&__st) != 0) {
+                int __err = errno;
+                ::close(__fd);
+                throw std::system_error(__err,std::generic_category(),"mapped_treap");
+            }
+            _M_length = static_cast<std::size_t>(__st.st_size);
+            if (_M_length < _Header::_S_nodes_offset) {
+                ::close(__fd);
+                throw std::runtime_error("mapped_treap: not a treap file");
+            }
+            _M_map = ::mmap(nullptr,_M_length,PROT_READ,MAP_SHARED,__fd,0);
+            int __err = errno;
+            ::close(__fd);
+            if (_M_map == MAP_FAILED) {
+                _M_map = nullptr;
+                throw std::system_error(__err,std::generic_category(),"mapped_treap");
+            }
+
+            _M_header = static_cast<const _Header*>(_M_map);
+            _M_nodes = reinterpret_cast<const _Node*>(static_cast<const char*>(_M_map) + _Header::_S_nodes_offset);
+            if (std::memcmp(_M_header->_M_magic,_Header::_S_magic(),sizeof(_M_header->_M_magic)) != 0
+                || _M_header->_M_node_size != sizeof(_Node) || _M_header->_M_value_size != sizeof(_Val)
+                || _M_header->_M_count > (_M_length - _Header::_S_nodes_offset) / sizeof(_Node)) {
+                _M_unmap();
+                throw std::runtime_error("mapped_treap: not a treap file for this element type");
+            }
+            if (!_M_valid()) {
+                _M_unmap();
+                throw std::runtime_error("mapped_treap: corrupt treap file");
+            }
+        }
+
+        mapped_treap(const mapped_treap&) = delete;
+
+        mapped_treap& operator = (const mapped_treap&) = delete;
+
+        /*
+         * @brief __x is left empty
+         */
+        mapped_treap(mapped_treap&& __x)
+        : _M_key_compare(__x._M_key_compare),_M_map(__x._M_map),_M_length(__x._M_length),_M_header(__x._M_header),_M_nodes(__x._M_nodes) {
+            __x._M_map = nullptr;
+            __x._M_header = &_Header::_S_empty();
+            __x._M_nodes = nullptr;
+        }
+
+        ~mapped_treap() { _M_unmap(); }
+
+        const_iterator begin() const { return _M_iter(_M_header->_M_leftmost); }
+
+        const_iterator end() const { return _M_iter(_Header::_S_npos); }
+
+        size_type size() const { return _M_header->_M_count; }
+
+        bool empty() const { return size() == 0; }
+
+        key_compare key_comp() const { return _M_key_compare; }
+
+        const_iterator lower_bound(const key_type& __k) const { return _M_iter(_M_lower_bound(__k)); }
+
+        const_iterator upper_bound(const key_type& __k) const { return _M_iter(_M_upper_bound(__k)); }
+
+        const_iterator find(const key_type& __k) const {
+            std::uint32_t __j = _M_lower_bound(__k);
+            return (__j == _Header::_S_npos || _M_key_compare(__k,_S_key(_M_nodes[__j]))) ? end() : _M_iter(__j);
+        }
+
+        bool contains(const key_type& __k) const { return find(__k) != end(); }
+
+        size_type count(const key_type& __k) const { return _M_count_not_greater(__k) - order_of_key(__k); }
+
+        std::pair<const_iterator,const_iterator> equal_range(const key_type& __k) const { return std::make_pair(lower_bound(__k),upper_bound(__k)); }
+
+        /*
+         * @brief the element at in-order position __k in O(log n),end() if __k >= size()
+         */
+        const_iterator find_by_order(size_type __k) const {
+            std::uint32_t __x = _M_root();
+            while (__x != _Header::_S_npos) {
+                size_type __lsize = _M_subtree_size(_M_nodes[__x]._M_children[Direction_Left]);
+                if (__k == __lsize)
+                    break;
+                if (__k < __lsize)
+                    __x = _M_nodes[__x]._M_children[Direction_Left];
+                else {
+                    __k -= __lsize + 1;
+                    __x = _M_nodes[__x]._M_children[Direction_Right];
+                }
+            }
+            return _M_iter(__x);
+        }
+
+        /*
+         * @brief number of elements strictly less than __k in O(log n)
+         */
+        size_type order_of_key(const key_type& __k) const {
+            size_type __n = 0;
+            for (std::uint32_t __x = _M_root(); __x != _Header::_S_npos;) {
+                if (_M_key_compare(_S_key(_M_nodes[__x]),__k)) {
+                    __n += _M_subtree_size(_M_nodes[__x]._M_children[Direction_Left]) + 1;
+                    __x = _M_nodes[__x]._M_children[Direction_Right];
+                }
+                else
+                    __x = _M_nodes[__x]._M_children[Direction_Left];
+            }
+            return __n;
+        }
+
+        /*
+         * @brief copies the elements into a mutable _Treap in O(n),using the sorted-range build
+         */
+        template <typename _Alloc = std::allocator<_Key>,typename _PriorityGen = treap_random_priority>
+        _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen> to_treap(const _Alloc& __a = _Alloc(),const _PriorityGen& __gen = _PriorityGen()) const {
+            return _Treap<_Key,_Compare,_Alloc,_Val,_KeyOfValue,_PriorityGen>(begin(),end(),_M_key_compare,__a,__gen);
+        }
+    };
+}
+
+#endif
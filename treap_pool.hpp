@@ -0,0 +1,219 @@
+// Treap node pool allocator -*- C++ -*-
+// @file treap_pool.hpp
+
+#ifndef _TREAP_POOL_H_
+#define _TREAP_POOL_H_ 1
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include "treap.hpp"
+
+namespace TreapTree {
+
+    /*
+     * @brief slab of fixed-size blocks carved from geometrically growing chunks
+     *
+     * The block size is fixed by the first single-object request,requests of any other
+     * size or alignment are forwarded to ::operator new with their alignment.Not thread-safe.
+     */
+    class _Treap_pool_resource
+    {
+        struct _Chunk { _Chunk* _M_next; };
+        struct _Free_block { _Free_block* _M_next; };
+
+        static const std::size_t _S_first_chunk_blocks = 256;
+        static const std::size_t _S_max_chunk_blocks = 1 << 16;
+        static const std::size_t _S_chunk_header = (sizeof(_Chunk) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+        std::size_t _M_object_size = 0;
+        std::size_t _M_block_size = 0;
+        std::size_t _M_block_align = 0;
+        std::size_t _M_chunk_blocks = _S_first_chunk_blocks;
+        _Chunk* _M_chunks = nullptr;
+        _Free_block* _M_free = nullptr;
+        char* _M_cur = nullptr;
+        char* _M_end = nullptr;
+
+        bool _M_fits(std::size_t __size,std::size_t __align) const {
+            if (_M_block_size == 0)
+                return __align <= alignof(std::max_align_t);
+            return __size == _M_object_size && __align == _M_block_align;
+        }
+
+        void _M_new_chunk() {
+            void* __p = ::operator new(_S_chunk_header + _M_chunk_blocks * _M_block_size);
+            _Chunk* __chunk = static_cast<_Chunk*>(__p);
+            __chunk->_M_next = _M_chunks;
+            _M_chunks = __chunk;
+            _M_cur = static_cast<char*>(__p) + _S_chunk_header;
+            _M_end = _M_cur + _M_chunk_blocks * _M_block_size;
+            if (_M_chunk_blocks < _S_max_chunk_blocks)
+                _M_chunk_blocks *= 2;
+        }
+
+    public :
+        /*
+         * @brief ::operator new honouring __align,over-aligned requests need C++17 aligned new
+         */
+        static void* _S_new(std::size_t __size,std::size_t __align) {
+#if __cpp_aligned_new
+            if (__align > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                return ::operator new(__size,std::align_val_t(__align));
+#endif
+            (void)__align;
+            return ::operator new(__size);
+        }
+
+        /*
+         * @brief the ::operator delete matching _S_new(__size,__align)
+         */
+        static void _S_delete(void* __p,std::size_t __size,std::size_t __align) noexcept {
+#if __cpp_aligned_new
+            if (__align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+#if __cpp_sized_deallocation
+                ::operator delete(__p,__size,std::align_val_t(__align));
+#else
+                ::operator delete(__p,std::align_val_t(__align));
+#endif
+                return;
+            }
+#endif
+            (void)__align;
+#if __cpp_sized_deallocation
+            ::operator delete(__p,__size);
+#else
+            (void)__size;
+            ::operator delete(__p);
+#endif
+        }
+
+        _Treap_pool_resource() {}
+
+        _Treap_pool_resource(const _Treap_pool_resource&) = delete;
+
+        _Treap_pool_resource& operator = (const _Treap_pool_resource&) = delete;
+
+        ~_Treap_pool_resource() { _M_release(); }
+
+        void* _M_allocate(std::size_t __size,std::size_t __align) {
+            if (!_M_fits(__size,__align))
+                return _S_new(__size,__align);
+
+            if (_M_block_size == 0) {
+                std::size_t __bytes = __size < sizeof(_Free_block) ? sizeof(_Free_block) : __size;
+                _M_block_size = (__bytes + __align - 1) / __align * __align;
+                _M_block_align = __align;
+                _M_object_size = __size;
+            }
+
+            if (_M_free != nullptr) {
+                _Free_block* __b = _M_free;
+                _M_free = __b->_M_next;
+                return __b;
+            }
+            if (_M_cur == _M_end)
+                _M_new_chunk();
+            void* __p = _M_cur;
+            _M_cur += _M_block_size;
+            return __p;
+        }
+
+        void _M_deallocate(void* __p,std::size_t __size,std::size_t __align) {
+            if (_M_block_size == 0 || !_M_fits(__size,__align)) {
+                _S_delete(__p,__size,__align);
+                return;
+            }
+            _Free_block* __b = static_cast<_Free_block*>(__p);
+            __b->_M_next = _M_free;
+            _M_free = __b;
+        }
+
+        /*
+         * @brief give every chunk back at once,all outstanding blocks become invalid
+         */
+        void _M_release() {
+            while (_M_chunks != nullptr) {
+                _Chunk* __next = _M_chunks->_M_next;
+                ::operator delete(_M_chunks);
+                _M_chunks = __next;
+            }
+            _M_free = nullptr;
+            _M_cur = _M_end = nullptr;
+            _M_chunk_blocks = _S_first_chunk_blocks;
+        }
+    };
+
+    /*
+     * @brief allocator handing out Treap nodes from a shared _Treap_pool_resource
+     *
+     * Copies and rebound copies share the pool and compare equal,so split()/merge() between
+     * Treaps built from the same allocator never move nodes across pools.Copy construction of
+     * a Treap selects a fresh pool.Use as the _Alloc parameter:
+     *     _Treap<int,std::less<int>,_Treap_pool_allocator<int>>
+     */
+    template <typename _Tp>
+    class _Treap_pool_allocator
+    {
+        template <typename _Up>
+        friend class _Treap_pool_allocator;
+
+        std::shared_ptr<_Treap_pool_resource> _M_pool;
+
+    public :
+        typedef _Tp value_type;
+        typedef _Tp* pointer;
+        typedef const _Tp* const_pointer;
+        typedef _Tp& reference;
+        typedef const _Tp& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        typedef std::false_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        template <typename _Up>
+        struct rebind { typedef _Treap_pool_allocator<_Up> other; };
+
+        _Treap_pool_allocator() : _M_pool(std::make_shared<_Treap_pool_resource>()) {}
+
+        _Treap_pool_allocator(const _Treap_pool_allocator& __a) noexcept : _M_pool(__a._M_pool) {}
+
+        template <typename _Up>
+        _Treap_pool_allocator(const _Treap_pool_allocator<_Up>& __a) noexcept : _M_pool(__a._M_pool) {}
+
+        _Tp* allocate(size_type __n) {
+            if (__n == 1)
+                return static_cast<_Tp*>(_M_pool->_M_allocate(sizeof(_Tp),alignof(_Tp)));
+            return static_cast<_Tp*>(_Treap_pool_resource::_S_new(__n * sizeof(_Tp),alignof(_Tp)));
+        }
+
+        void deallocate(_Tp* __p,size_type __n) {
+            if (__n == 1)
+                _M_pool->_M_deallocate(__p,sizeof(_Tp),alignof(_Tp));
+            else
+                _Treap_pool_resource::_S_delete(__p,__n * sizeof(_Tp),alignof(_Tp));
+        }
+
+        _Treap_pool_allocator select_on_container_copy_construction() const { return _Treap_pool_allocator(); }
+
+        /*
+         * @brief true if no other allocator,and hence no other container,can hold blocks of this pool
+         */
+        bool _M_is_sole_owner() const { return _M_pool.use_count() == 1; }
+
+        void _M_release_all() { _M_pool->_M_release(); }
+
+        template <typename _Up>
+        bool operator == (const _Treap_pool_allocator<_Up>& __a) const { return _M_pool == __a._M_pool; }
+
+        template <typename _Up>
+        bool operator != (const _Treap_pool_allocator<_Up>& __a) const { return _M_pool != __a._M_pool; }
+    };
+
+    template <typename _Tp>
+    struct _Treap_bulk_release<_Treap_pool_allocator<_Tp>> : public std::true_type {};
+}
+
+#endif
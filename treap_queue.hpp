@@ -0,0 +1,151 @@
+// Treap priority queue -*- C++ -*-
+// @file treap_queue.hpp
+
+#ifndef _TREAP_QUEUE_H_
+#define _TREAP_QUEUE_H_ 1
+
+#include <cassert>
+#include <functional>
+#include <utility>
+#include "treap.hpp"
+#include "treap_algebra.hpp"
+
+namespace TreapTree {
+
+    /*
+     * @brief orders ids by a mixed hash,then by _Compare among colliding hashes
+     *
+     * The order only serves lookups by id,hashing it keeps the tree shape independent of the
+     * priorities even when they grow with the id,as deadlines of tasks queued in order do.
+     */
+    template <typename _Key,typename _Compare,typename _Hash>
+    struct _Treap_queue_order
+    {
+        _Compare _M_comp;
+        _Hash _M_hash;
+
+        _Treap_queue_order(const _Compare& __comp = _Compare(),const _Hash& __hash = _Hash()) : _M_comp(__comp),_M_hash(__hash) {}
+
+        bool operator()(const _Key& __a,const _Key& __b) const {
+            const std::uint64_t __ha = _M_mix64(static_cast<std::uint64_t>(_M_hash(__a)));
+            const std::uint64_t __hb = _M_mix64(static_cast<std::uint64_t>(_M_hash(__b)));
+            return __ha != __hb ? __ha < __hb : _M_comp(__a,__b);
+        }
+    };
+
+    /*
+     * @brief addressable priority queue of unique ids,a Treap keyed by id and heap-ordered by a user priority
+     *
+     * The priority of an id is the _M_Priority of its node,the highest one is at the root.top()
+     * is O(1);push(),pop(),erase() and update_priority() are O(log n) expected,meld() is
+     * O(m log(n/m + 1)).Priorities are unsigned int,larger first,MAX_PRIORITY is reserved and
+     * taken as MAX_PRIORITY - 1;for earliest-deadline-first push MAX_PRIORITY - 1 - deadline.
+     * Iteration visits every id once,in no useful order.
+     *
+     * The O(log n) bounds rest on the hashed id order:priorities that correlate with the hash
+     * give a deep tree.Pick this queue when meld() is frequent,see bench/treap_queue_bench.cpp;
+     * without meld() a pairing heap with an id map does as well.
+     */
+    template <typename _Key,typename _Compare = std::less<_Key>,typename _Hash = std::hash<_Key>,typename _Alloc = std::allocator<_Key>>
+    class treap_priority_queue
+    {
+        typedef _Treap_queue_order<_Key,_Compare,_Hash> _Order;
+        typedef _Treap<_Key,_Order,_Alloc> _Rep_type;
+
+        _Rep_type _M_t;
+
+    public :
+        typedef _Key key_type;
+        typedef _Key value_type;
+        typedef unsigned int priority_type;
+        typedef _Alloc allocator_type;
+        typedef typename _Rep_type::size_type size_type;
+        typedef typename _Rep_type::const_reference const_reference;
+        typedef typename _Rep_type::const_iterator iterator;
+        typedef typename _Rep_type::const_iterator const_iterator;
+
+        treap_priority_queue() {}
+
+        explicit treap_priority_queue(const _Compare& __comp,const _Hash& __hash = _Hash(),const allocator_type& __a = allocator_type())
+        : _M_t(_Order(__comp,__hash),__a) {}
+
+        allocator_type get_allocator() const { return _M_t.get_allocator(); }
+
+        const_iterator begin() const { return _M_t.begin(); }
+
+        const_iterator end() const { return _M_t.end(); }
+
+        size_type size() const { return _M_t.size(); }
+
+        bool empty() const { return _M_t.empty(); }
+
+        void clear() { _M_t.clear(); }
+
+        void swap(treap_priority_queue& __x) noexcept { _M_t.swap(__x._M_t); }
+
+        /*
+         * @brief the id of highest priority,the queue must not be empty
+         */
+        const_reference top() const { return *_M_t.top(); }
+
+        priority_type top_priority() const { return _M_t.priority(_M_t.top()); }
+
+        void pop() { _M_t.erase(_M_t.top()); }
+
+        /*
+         * @brief queues __k with priority __p
+         * @return the entry of __k and true,or the entry already queued for __k and false
+         */
+        std::pair<const_iterator,bool> push(const key_type& __k,priority_type __p) { return _M_t.insert_unique_with_priority(__p,__k); }
+
+        template <typename... _Args>
+        std::pair<const_iterator,bool> emplace(priority_type __p,_Args&&... __args) { return _M_t.insert_unique_with_priority(__p,key_type(std::forward<_Args>(__args)...)); }
+
+        const_iterator find(const key_type& __k) const { return _M_t.find(__k); }
+
+        bool contains(const key_type& __k) const { return _M_t.find(__k) != _M_t.end(); }
+
+        priority_type priority(const_iterator __position) const { return _M_t.priority(__position); }
+
+        /*
+         * @brief raises or lowers the priority of a queued id,covers decrease-key and increase-key
+         */
+        void update_priority(const_iterator __position,priority_type __p) { _M_t.update_priority(__position,__p); }
+
+        /*
+         * @return false if __k is not queued
+         */
+        bool update_priority(const key_type& __k,priority_type __p) {
+            const_iterator __it = _M_t.find(__k);
+            if (__it == _M_t.end())
+                return false;
+            _M_t.update_priority(__it,__p);
+            return true;
+        }
+
+        void erase(const_iterator __position) { _M_t.erase(__position); }
+
+        size_type erase(const key_type& __k) { return _M_t.erase(__k); }
+
+        /*
+         * @brief moves every id of __x into this queue with its priority,leaving __x empty
+         *
+         * Nodes are relinked by treap_union(),none is copied.An id queued in both keeps the entry
+         * of this queue.The allocators must compare equal.
+         */
+        void meld(treap_priority_queue& __x) {
+            assert(get_allocator() == __x.get_allocator());
+            if (this != &__x)
+                _M_t = treap_union(_M_t,__x._M_t);
+        }
+
+        void meld(treap_priority_queue&& __x) { meld(__x); }
+
+        bool __treap_verify() const { return _M_t.__treap_verify(); }
+    };
+
+    template <typename _Key,typename _Compare,typename _Hash,typename _Alloc>
+    inline void swap(treap_priority_queue<_Key,_Compare,_Hash,_Alloc>& __x,treap_priority_queue<_Key,_Compare,_Hash,_Alloc>& __y) noexcept { __x.swap(__y); }
+}
+
+#endif